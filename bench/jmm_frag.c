@@ -0,0 +1,104 @@
+/* bench/jmm_frag.c - JMM Fragmentation Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Replays a long, deterministic, mixed-size workload against jmm and reports
+ * how much heap it needed for the bytes that were actually live at the peak.
+ * A ratio close to 1.0 means little fragmentation.
+ *
+ * usage: jmm_frag [ops] [slots]
+ */
+
+#include "jmm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void)
+{
+	/* xorshift64*, the same stream on every run */
+	rng ^= rng >> 12;
+	rng ^= rng << 25;
+	rng ^= rng >> 27;
+	return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static size_t pick_size(void)
+{
+	uint64_t r = next_rand() % 100;
+	if (r < 60)
+		return 16 + next_rand() % 240; /* small */
+	if (r < 90)
+		return 256 + next_rand() % (8192 - 256); /* medium */
+	if (r < 99)
+		return 8192 + next_rand() % (BLOCK_MID - 8192); /* large */
+	return BLOCK_MID + next_rand() % (BLOCK_BIG - BLOCK_MID); /* huge */
+}
+
+int main(int argc, char **argv)
+{
+	size_t ops = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000000;
+	size_t nslots = argc > 2 ? strtoul(argv[2], NULL, 0) : 20000;
+	void **slot;
+	size_t *len;
+	size_t live = 0, peak_live = 0;
+	size_t mapped = 0, heap, peak_heap = 0;
+	void *base;
+	struct timespec t0, t1;
+
+	/* stdio allocates its buffer on the first print, get it out of the way */
+	printf("jmm_frag: %zu ops over %zu slots\n", ops, nslots);
+	slot = calloc(nslots, sizeof(*slot));
+	len = calloc(nslots, sizeof(*len));
+	if (!slot || !len)
+		return 1;
+	base = sbrk(0);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (size_t i = 0; i < ops; i++) {
+		size_t k = next_rand() % nslots;
+		if (slot[k]) {
+			if (((header *)slot[k] - 1)->is_mmap)
+				mapped -= ((header *)slot[k] - 1)->size;
+			jfree(slot[k]);
+			live -= len[k];
+			slot[k] = NULL;
+			continue;
+		}
+		len[k] = pick_size();
+		if ((slot[k] = jmalloc(len[k])) == NULL) {
+			fprintf(stderr, "jmm_frag: out of memory at op %zu\n", i);
+			return 1;
+		}
+		/* touch it so the workload looks like a real one */
+		memset(slot[k], (int)k, len[k] < 64 ? len[k] : 64);
+		if (((header *)slot[k] - 1)->is_mmap)
+			mapped += ((header *)slot[k] - 1)->size;
+		live += len[k];
+		if (live > peak_live)
+			peak_live = live;
+		heap = (size_t)(sbrk(0) - base) + mapped;
+		if (heap > peak_heap)
+			peak_heap = heap;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	printf("peak live bytes : %zu\n", peak_live);
+	printf("peak heap bytes : %zu\n", peak_heap);
+	printf("heap / live     : %.3f\n", (double)peak_heap / (double)peak_live);
+	printf("time            : %.3f s (%.1f ns/op)\n",
+	       (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9,
+	       ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) /
+		       (double)ops);
+
+	for (size_t k = 0; k < nslots; k++)
+		jfree(slot[k]);
+	free(slot);
+	free(len);
+	return 0;
+}
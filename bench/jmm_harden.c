@@ -0,0 +1,82 @@
+/* bench/jmm_harden.c - JMM Hardened Mode Overhead Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Times the hot paths that hardening touches: malloc/free pairs of a few
+ * small sizes, a LIFO batch of frees, and realloc growth. Build it once as
+ * is and once with `make bench HARDENED=1`, then compare the two runs; the
+ * first line says which build is running.
+ *
+ * usage: jmm_harden [rounds]
+ */
+
+#include "jmm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define BATCH 1024
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void report(const char *name, double ns, size_t ops)
+{
+	printf("  %-14s %8.1f ns/op\n", name, ns / ops);
+}
+
+int main(int argc, char **argv)
+{
+	size_t rounds = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+	static void *slot[BATCH];
+	double t;
+
+#if defined(JMM_HARDENED)
+	printf("jmm_harden: hardened build");
+#else
+	printf("jmm_harden: default build");
+#endif
+#if defined(JMM_SAFE_LINK)
+	printf(", safe-linking");
+#endif
+	printf(", %zu rounds\n", rounds);
+
+	t = now();
+	for (size_t r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < BATCH; i++) {
+			void *p = jmalloc(16 + (i % 8) * 24);
+			*(volatile char *)p = 0;
+			jfree(p);
+		}
+	}
+	report("pair", now() - t, rounds * BATCH);
+
+	t = now();
+	for (size_t r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < BATCH; i++)
+			slot[i] = jmalloc(16 + (i % 8) * 24);
+		for (size_t i = BATCH; i-- > 0;)
+			jfree(slot[i]);
+	}
+	report("batch", now() - t, rounds * BATCH * 2);
+
+	t = now();
+	for (size_t r = 0; r < rounds / 8 + 1; r++) {
+		char *p = NULL;
+		for (size_t n = 16; n <= 64 * 1024; n *= 2) {
+			if ((p = jrealloc(p, n)) == NULL)
+				return 1;
+			p[n - 1] = 0;
+		}
+		jfree(p);
+	}
+	report("realloc", now() - t, (rounds / 8 + 1) * 13);
+	return 0;
+}
@@ -0,0 +1,107 @@
+/* bench/jmm_pingpong.c - Cross-Thread Free Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * One thread allocates messages and hands them to another over a ring, which
+ * frees them, like a producer/consumer pipeline. Runs jmm with and without
+ * remote frees (JM_REMOTE_FREE) and the system malloc, and reports messages
+ * per second for each.
+ *
+ * usage: jmm_pingpong [messages]
+ */
+
+#include "jmm.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RING 1024 /* power of two */
+
+struct backend {
+	const char *name;
+	void *(*malloc)(size_t);
+	void (*free)(void *);
+	int remote; /* JM_REMOTE_FREE, -1 if not jmm */
+};
+
+static const struct backend backends[] = {
+	{ "jmm (remote free)", jmalloc, jfree, 1 },
+	{ "jmm (locked free)", jmalloc, jfree, 0 },
+	{ "libc", malloc, free, -1 },
+};
+
+static const struct backend *be;
+static size_t messages;
+static void *ring[RING];
+static _Atomic size_t head; /* written by the producer */
+static _Atomic size_t tail; /* written by the consumer */
+
+static void *producer(void *arg)
+{
+	uint64_t rng = 88172645463325252ULL;
+	(void)arg;
+
+	for (size_t i = 0; i < messages; i++) {
+		size_t h = atomic_load_explicit(&head, memory_order_relaxed);
+		void *m;
+
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		m = be->malloc(32 + rng % 480);
+		memset(m, (int)i, 32);
+		while (h - atomic_load_explicit(&tail, memory_order_acquire) ==
+		       RING)
+			sched_yield();
+		ring[h % RING] = m;
+		atomic_store_explicit(&head, h + 1, memory_order_release);
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	(void)arg;
+
+	for (size_t i = 0; i < messages; i++) {
+		size_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+		while (atomic_load_explicit(&head, memory_order_acquire) == t)
+			sched_yield();
+		be->free(ring[t % RING]);
+		atomic_store_explicit(&tail, t + 1, memory_order_release);
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	messages = argc > 1 ? strtoul(argv[1], NULL, 0) : 5000000;
+
+	for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+		struct timespec t0, t1;
+		pthread_t p, c;
+		double secs;
+
+		be = &backends[b];
+		if (be->remote >= 0)
+			jmallopt(JM_REMOTE_FREE, be->remote);
+		atomic_store(&head, 0);
+		atomic_store(&tail, 0);
+
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		pthread_create(&c, NULL, consumer, NULL);
+		pthread_create(&p, NULL, producer, NULL);
+		pthread_join(p, NULL);
+		pthread_join(c, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+
+		secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+		printf("%-18s: %zu messages in %.3f s, %.2f M msg/s\n", be->name,
+		       messages, secs, messages / secs / 1e6);
+	}
+	return 0;
+}
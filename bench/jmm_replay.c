@@ -0,0 +1,196 @@
+/* bench/jmm_replay.c - Allocation Trace Replay
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Replays a trace written by jtrace_start() (or JMM_TRACE=path) against
+ * either jmm or the system malloc, in the recorded order, and reports the
+ * throughput, the latency percentiles of the allocator calls and peak RSS.
+ * Threads are replayed serially, in the order the records were logged.
+ *
+ * usage: jmm_replay trace [jmm|libc]
+ */
+
+#include "jmm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+struct backend {
+	const char *name;
+	void *(*malloc)(size_t);
+	void (*free)(void *);
+	void *(*realloc)(void *, size_t);
+};
+
+static const struct backend backends[] = {
+	{ "jmm", jmalloc, jfree, jrealloc },
+	{ "libc", malloc, free, realloc },
+};
+
+/* trace id -> live pointer, linear probing with backward shift deletion */
+struct slot {
+	uint64_t id;
+	void *p;
+};
+static struct slot *table;
+static size_t mask;
+
+static size_t hash(uint64_t id)
+{
+	id ^= id >> 33;
+	id *= 0xff51afd7ed558ccdULL;
+	id ^= id >> 33;
+	return (size_t)id & mask;
+}
+
+static void put(uint64_t id, void *p)
+{
+	size_t i = hash(id);
+	while (table[i].id && table[i].id != id)
+		i = (i + 1) & mask;
+	table[i].id = id;
+	table[i].p = p;
+}
+
+static void *find(uint64_t id)
+{
+	size_t i = hash(id);
+	while (table[i].id && table[i].id != id)
+		i = (i + 1) & mask;
+	return table[i].id ? table[i].p : NULL;
+}
+
+static void *take(uint64_t id)
+{
+	size_t i = hash(id), j, k;
+	void *p;
+
+	while (table[i].id != id) {
+		if (!table[i].id)
+			return NULL;
+		i = (i + 1) & mask;
+	}
+	p = table[i].p;
+	for (j = (i + 1) & mask; table[j].id; j = (j + 1) & mask) {
+		k = hash(table[j].id);
+		/* move j into the hole at i unless its home lies in (i, j] */
+		if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+			table[i] = table[j];
+			i = j;
+		}
+	}
+	table[i].id = 0;
+	return p;
+}
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+	const struct backend *be = &backends[0];
+	struct jtrace_rec *recs;
+	uint64_t *lat, t0, total = 0;
+	size_t n, cap;
+	struct rusage ru;
+	FILE *f;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s trace [jmm|libc]\n", argv[0]);
+		return 2;
+	}
+	if (argc > 2 && strcmp(argv[2], "libc") == 0)
+		be = &backends[1];
+	else if (argc > 2 && strcmp(argv[2], "jmm") != 0) {
+		fprintf(stderr, "unknown backend '%s'\n", argv[2]);
+		return 2;
+	}
+
+	/* the harness' own memory comes from libc, it's the same for both */
+	if ((f = fopen(argv[1], "rb")) == NULL) {
+		perror(argv[1]);
+		return 1;
+	}
+	fseek(f, 0, SEEK_END);
+	n = (size_t)ftell(f) / sizeof(*recs);
+	rewind(f);
+	recs = malloc(n * sizeof(*recs) + 1);
+	lat = malloc(n * sizeof(*lat) + 1);
+	for (cap = 16; cap < 2 * n; cap <<= 1)
+		;
+	table = calloc(cap, sizeof(*table));
+	mask = cap - 1;
+	if (!recs || !lat || !table || fread(recs, sizeof(*recs), n, f) != n) {
+		fprintf(stderr, "can't load %s\n", argv[1]);
+		return 1;
+	}
+	fclose(f);
+
+	for (size_t i = 0; i < n; i++) {
+		struct jtrace_rec *r = &recs[i];
+		void *p, *q;
+
+		switch (r->op) {
+		case JT_MALLOC:
+			t0 = now();
+			p = be->malloc(r->size);
+			lat[i] = now() - t0;
+			if (p && r->ptr) {
+				memset(p, 0, r->size < 64 ? r->size : 64);
+				put(r->ptr, p);
+			}
+			break;
+		case JT_FREE:
+			q = take(r->old);
+			t0 = now();
+			be->free(q);
+			lat[i] = now() - t0;
+			break;
+		case JT_REALLOC:
+			q = r->old ? find(r->old) : NULL;
+			t0 = now();
+			p = be->realloc(q, r->size);
+			lat[i] = now() - t0;
+			/* a failed realloc leaves the old block live */
+			if (r->old && (p || r->size == 0))
+				take(r->old);
+			/* one that failed in the trace only, under the old id */
+			if (p && (r->ptr || r->old))
+				put(r->ptr ? r->ptr : r->old, p);
+			break;
+		default:
+			lat[i] = 0;
+			break;
+		}
+		total += lat[i];
+	}
+	getrusage(RUSAGE_SELF, &ru);
+
+	qsort(lat, n, sizeof(*lat), cmp_u64);
+	printf("backend      : %s\n", be->name);
+	printf("operations   : %zu\n", n);
+	printf("throughput   : %.0f ops/s\n", total ? n * 1e9 / total : 0.0);
+	if (n) {
+		printf("latency p50  : %lu ns\n", (unsigned long)lat[n / 2]);
+		printf("latency p90  : %lu ns\n", (unsigned long)lat[n * 9 / 10]);
+		printf("latency p99  : %lu ns\n", (unsigned long)lat[n * 99 / 100]);
+		printf("latency p999 : %lu ns\n",
+		       (unsigned long)lat[n * 999 / 1000]);
+		printf("latency max  : %lu ns\n", (unsigned long)lat[n - 1]);
+	}
+	printf("peak RSS     : %ld KiB\n", ru.ru_maxrss);
+	return 0;
+}
@@ -0,0 +1,172 @@
+/* bench/jstdio_mapfile.c - Line Scanning Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Counting the lines of a log file and the bytes in them, the scan every
+ * log tool starts with: through a jmapfile, with jgetline() and the C
+ * library's getline(), and the way it used to be done here, read() into a
+ * buffer with every line copied out by jstrndup(). The file is written
+ * once and is in the page cache for every run after the first.
+ *
+ * usage: jstdio_mapfile [megabytes] [rounds]
+ */
+
+#define _GNU_SOURCE /* getline() under strict standards */
+#include "jstdio.h"
+#include "jstring.h"
+#include "jmm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static volatile size_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+static const char *path;
+
+static size_t by_mapfile(void)
+{
+	jmapfile m;
+	const char *p;
+	size_t len;
+	size_t sum = 0;
+
+	jmapfile_open(&m, path);
+	while (jmapfile_line(&m, &p, &len))
+		sum += len + 1;
+	jmapfile_close(&m);
+	return sum;
+}
+
+static size_t by_jgetline(void)
+{
+	jFILE *f = jfopen(path, "r");
+	char *line = NULL;
+	size_t cap = 0;
+	size_t sum = 0;
+	ssize_t len;
+
+	while ((len = jgetline_unlocked(&line, &cap, f)) > 0)
+		sum += (size_t)len;
+	jfree(line);
+	jfclose(f);
+	return sum;
+}
+
+static size_t by_getline(void)
+{
+	FILE *f = fopen(path, "r");
+	char *line = NULL;
+	size_t cap = 0;
+	size_t sum = 0;
+	ssize_t len;
+
+	while ((len = getline(&line, &cap, f)) > 0)
+		sum += (size_t)len;
+	free(line);
+	fclose(f);
+	return sum;
+}
+
+/* lines split across two reads are carried over to the front */
+static size_t by_read_strndup(void)
+{
+	static char buf[64 * 1024];
+	int fd = open(path, O_RDONLY);
+	size_t have = 0;
+	size_t sum = 0;
+	ssize_t got;
+
+	while ((got = read(fd, buf + have, sizeof(buf) - have)) > 0) {
+		char *p = buf;
+		char *end = buf + have + got;
+		char *q;
+
+		while ((q = memchr(p, '\n', end - p))) {
+			char *line = jstrndup(p, q - p);
+
+			sum += jstrlen(line) + 1;
+			jfree(line);
+			p = q + 1;
+		}
+		have = end - p;
+		memmove(buf, p, have);
+	}
+	close(fd);
+	return sum;
+}
+
+int main(int argc, char **argv)
+{
+	size_t mb = argc > 1 ? strtoul(argv[1], NULL, 0) : 256;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 3;
+	static const struct {
+		const char *name;
+		size_t (*scan)(void);
+	} ways[] = {
+		{ "jmapfile_line", by_mapfile },
+		{ "jgetline_unlocked", by_jgetline },
+		{ "getline", by_getline },
+		{ "read + jstrndup", by_read_strndup },
+	};
+	char tmp[] = "/tmp/jstdio_bench_XXXXXX";
+	jFILE *f;
+
+	close(mkstemp(tmp));
+	path = tmp;
+	f = jfopen(path, "w");
+	/* log lines of 40 to 200 bytes, all ending in a newline */
+	for (size_t n = 0; n < mb << 20;) {
+		char line[256];
+		int len = sprintf(line, "2026-10-19T12:%02d:%02d worker=%u ",
+				  (int)(rnd() % 60), (int)(rnd() % 60),
+				  (unsigned)(rnd() % 64));
+
+		for (size_t k = rnd() % 160; k--;)
+			line[len++] = 'a' + rnd() % 26;
+		line[len++] = '\n';
+		jfwrite_unlocked(line, 1, len, f);
+		n += len;
+	}
+	jfclose(f);
+
+	printf("jstdio_mapfile: %zu MiB of log lines, best of %zu rounds\n", mb,
+	       rounds);
+	for (size_t w = 0; w < sizeof(ways) / sizeof(ways[0]); w++) {
+		double best = 1e300;
+
+		for (size_t r = 0; r < rounds; r++) {
+			double t0 = now();
+
+			sink += ways[w].scan();
+			t0 = now() - t0;
+			if (t0 < best)
+				best = t0;
+		}
+		printf("  %-18s %8.2f GB/s\n", ways[w].name,
+		       (double)(mb << 20) / best);
+	}
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,122 @@
+/* bench/jstdio_write.c - Buffered Output Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * The output path of a batch job: many short records, with now and then a
+ * large blob between them, written to a file with jstdio, with the C
+ * library's stdio and with a write() per record. Also the locked and
+ * unlocked jfputc() in a loop, the case the unlocked variants are for.
+ *
+ * usage: jstdio_write [records] [rounds]
+ */
+
+#include "jstdio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+struct record {
+	const char *p;
+	size_t len;
+};
+
+/* ns per record for n records of `stmt`, into a fresh file each round */
+#define TIME(open, stmt, close)                                              \
+	({                                                                   \
+		double t = 0;                                                \
+		for (size_t r = 0; r < rounds; r++) {                        \
+			open;                                                \
+			double t0 = now();                                   \
+			for (size_t i = 0; i < n; i++) {                     \
+				const char *p = recs[i % nrec].p;            \
+				size_t len = recs[i % nrec].len;             \
+				stmt;                                        \
+			}                                                    \
+			close;                                               \
+			t += now() - t0;                                     \
+		}                                                            \
+		t / ((double)rounds * n);                                    \
+	})
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 3;
+	size_t nrec = n;
+	static char blob[256 * 1024];
+	char path[] = "/tmp/jstdio_bench_XXXXXX";
+	struct record *recs = malloc(n * sizeof(*recs));
+	char *text = malloc(n * 64);
+	size_t off = 0;
+	jFILE *jf;
+	FILE *cf;
+	int fd;
+
+	close(mkstemp(path));
+	memset(blob, 'x', sizeof(blob));
+	for (size_t i = 0; i < 2; i++) {
+		printf("%s\n", i ? "with a 256 KiB blob every 1000 records"
+				 : "short records only");
+		off = 0;
+		for (size_t j = 0; j < n; j++) {
+			if (i && j % 1000 == 999) {
+				recs[j] = (struct record){ blob, sizeof(blob) };
+				continue;
+			}
+			int len = sprintf(text + off, "%zu,%llu,ok\n", j,
+					  (unsigned long long)(rnd() % 1000000));
+			recs[j] = (struct record){ text + off, (size_t)len };
+			off += len;
+		}
+		printf("  %-22s %9.1f ns/record\n", "jfwrite",
+		       TIME(jf = jfopen(path, "w"), jfwrite(p, 1, len, jf),
+			    jfclose(jf)));
+		printf("  %-22s %9.1f ns/record\n", "jfwrite_unlocked",
+		       TIME(jf = jfopen(path, "w"),
+			    jfwrite_unlocked(p, 1, len, jf), jfclose(jf)));
+		printf("  %-22s %9.1f ns/record\n", "fwrite",
+		       TIME(cf = fopen(path, "w"), fwrite(p, 1, len, cf),
+			    fclose(cf)));
+		printf("  %-22s %9.1f ns/record\n", "write",
+		       TIME(fd = creat(path, 0600), (void)!write(fd, p, len),
+			    close(fd)));
+	}
+
+	printf("a byte at a time\n");
+	n *= 16;
+	printf("  %-22s %9.2f ns/byte\n", "jfputc",
+	       TIME(jf = jfopen(path, "w"), (void)p; jfputc('0' + len % 10, jf),
+		    jfclose(jf)));
+	printf("  %-22s %9.2f ns/byte\n", "jfputc_unlocked",
+	       TIME(jf = jfopen(path, "w"),
+		    (void)p; jfputc_unlocked('0' + len % 10, jf), jfclose(jf)));
+	printf("  %-22s %9.2f ns/byte\n", "putc_unlocked",
+	       TIME(cf = fopen(path, "w"), (void)p; putc_unlocked('0' + len % 10, cf),
+		    fclose(cf)));
+	unlink(path);
+	free(recs);
+	free(text);
+	return 0;
+}
@@ -0,0 +1,177 @@
+/* bench/jstdlib_sort.c - Sorting and Searching Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * jqsort() against the C library's qsort() on the element sizes batch jobs
+ * sort (ints, doubles, 16 and 24 byte records keyed by their first word)
+ * in the input orders that tell sorts apart, then jbsearch() against
+ * bsearch() on an array small enough for the cache and one that isn't.
+ *
+ * usage: jstdlib_sort [elements] [rounds]
+ */
+
+#include "jstdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static volatile size_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* the records only compare their first word */
+static int cmp_key(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+enum order { RANDOM, SORTED, REVERSED, FEW };
+
+/* n elements of `size` bytes in `order`, their first word is the key */
+static void fill(char *a, size_t n, size_t size, enum order o)
+{
+	for (size_t i = 0; i < n; i++) {
+		uint64_t k = o == RANDOM ? rnd() >> 2 :
+			     o == SORTED ? i :
+			     o == REVERSED ? n - i :
+					     rnd() % 16;
+		char *e = a + i * size;
+
+		memset(e, 0, size);
+		if (size == 4) {
+			int v = (int)k;
+			memcpy(e, &v, 4);
+		} else if (size == 8 && o == RANDOM) {
+			double v = (double)k / 3;
+			memcpy(e, &v, 8);
+		} else if (size == 8) {
+			double v = (double)k;
+			memcpy(e, &v, 8);
+		} else {
+			memcpy(e, &k, 8);
+			memcpy(e + 8, &i, sizeof(i));
+		}
+	}
+}
+
+/* ns per element of a sort, each round on a fresh copy */
+static double time_sort(char *work, const char *src, size_t n, size_t size,
+			int (*cmp)(const void *, const void *), size_t rounds,
+			void (*sort)(void *, size_t, size_t,
+				     int (*)(const void *, const void *)))
+{
+	double t = 0;
+
+	for (size_t r = 0; r < rounds; r++) {
+		memcpy(work, src, n * size);
+		double t0 = now();
+		sort(work, n, size, cmp);
+		t += now() - t0;
+	}
+	return t / ((double)rounds * n);
+}
+
+/* ns per lookup of every key of a sorted int array, in random order */
+static double time_search(const int *a, const int *keys, size_t n,
+			  void *(*search)(const void *, const void *, size_t,
+					  size_t,
+					  int (*)(const void *, const void *)))
+{
+	double t0 = now();
+
+	for (size_t i = 0; i < n; i++)
+		sink += search(keys + i, a, n, sizeof(int), cmp_int) != NULL;
+	return (now() - t0) / n;
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 5;
+	static const char *orders[] = { "random", "sorted", "reversed", "few" };
+	static const struct {
+		const char *name;
+		size_t size;
+		int (*cmp)(const void *, const void *);
+	} types[] = {
+		{ "int", 4, cmp_int },
+		{ "double", 8, cmp_double },
+		{ "rec16", 16, cmp_key },
+		{ "rec24", 24, cmp_key },
+	};
+	char *src = malloc(n * 24);
+	char *work = malloc(n * 24);
+
+	printf("jstdlib_sort: %zu elements, %zu rounds, ns per element\n", n,
+	       rounds);
+	printf("  %-8s %-9s %9s %9s\n", "type", "order", "jqsort", "qsort");
+	for (size_t t = 0; t < sizeof(types) / sizeof(*types); t++) {
+		for (int o = RANDOM; o <= FEW; o++) {
+			size_t size = types[t].size;
+
+			fill(src, n, size, o);
+			printf("  %-8s %-9s %9.2f %9.2f\n", types[t].name,
+			       orders[o],
+			       time_sort(work, src, n, size, types[t].cmp,
+					 rounds, jqsort),
+			       time_sort(work, src, n, size, types[t].cmp,
+					 rounds, qsort));
+		}
+	}
+
+	printf("\n  %-18s %9s %9s\n", "lookups", "jbsearch", "bsearch");
+	size_t lengths[] = { 4096, 65536, n };
+	for (size_t l = 0; l < 3 && lengths[l] <= n; l++) {
+		size_t m = lengths[l];
+		int *a = (int *)src;
+		int *keys = (int *)work;
+
+		for (size_t i = 0; i < m; i++) {
+			a[i] = (int)(2 * i);
+			keys[i] = (int)(rnd() % (2 * m));
+		}
+		printf("  %-18zu %9.2f %9.2f\n", m,
+		       time_search(a, keys, m, jbsearch),
+		       time_search(a, keys, m, bsearch));
+	}
+	free(src);
+	free(work);
+	return 0;
+}
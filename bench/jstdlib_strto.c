@@ -0,0 +1,107 @@
+/* bench/jstdlib_strto.c - Number Parsing Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * A CSV line's worth of numbers at a time, the way ingest code sees them:
+ * each kind of number is written out comma separated, then parsed back
+ * field by field with jstrto*() and with the C library's strto*().
+ *
+ * usage: jstdlib_strto [numbers] [rounds]
+ */
+
+#include "jstdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+static volatile double sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+enum kind { SMALL, INT64, PRICE, SHORTEST, SCI };
+
+static int field(char *buf, size_t cap, enum kind k)
+{
+	double d;
+
+	switch (k) {
+	case SMALL:
+		return snprintf(buf, cap, "%d", (int)(rnd() % 10000));
+	case INT64:
+		return snprintf(buf, cap, "%lld", (long long)rnd());
+	case PRICE:
+		return snprintf(buf, cap, "%.2f", (double)(rnd() % 10000000) / 100);
+	case SHORTEST:
+		d = (double)(rnd() >> 11) / (1ULL << 53) * 1000;
+		return snprintf(buf, cap, "%.17g", d);
+	default:
+		d = (double)(rnd() >> 11) / (1ULL << 53);
+		return snprintf(buf, cap, "%.6e", d * 1e12);
+	}
+}
+
+/* ns per number for one pass of `expr` over every field */
+#define TIME(expr)                                                   \
+	({                                                           \
+		double t0 = now();                                   \
+		for (size_t r = 0; r < rounds; r++) {                \
+			char *p = text;                              \
+			for (size_t i = 0; i < n; i++) {             \
+				char *e;                             \
+				sink += (expr);                      \
+				p = e + 1;                           \
+			}                                            \
+		}                                                    \
+		(now() - t0) / ((double)rounds * n);                 \
+	})
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 100000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 20;
+	static const char *names[] = { "small", "int64", "price", "shortest",
+				       "sci" };
+	char *text = malloc(n * 32);
+
+	printf("jstdlib_strto: %zu numbers, %zu rounds, ns per number\n", n,
+	       rounds);
+	printf("  %-9s %9s %9s %9s %9s\n", "numbers", "jstrtol", "strtol",
+	       "jstrtod", "strtod");
+	for (int k = SMALL; k <= SCI; k++) {
+		size_t len = 0;
+		double ns[4] = { 0 };
+
+		for (size_t i = 0; i < n; i++) {
+			len += field(text + len, 32, k);
+			text[len++] = ',';
+		}
+		text[len - 1] = '\0';
+		if (k == SMALL || k == INT64) {
+			ns[0] = TIME(jstrtol(p, &e, 10));
+			ns[1] = TIME(strtol(p, &e, 10));
+		}
+		ns[2] = TIME(jstrtod(p, &e));
+		ns[3] = TIME(strtod(p, &e));
+		printf("  %-9s %9.2f %9.2f %9.2f %9.2f\n", names[k], ns[0],
+		       ns[1], ns[2], ns[3]);
+	}
+	free(text);
+	return 0;
+}
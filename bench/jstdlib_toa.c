@@ -0,0 +1,118 @@
+/* bench/jstdlib_toa.c - Number Formatting Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * The other half of jstdlib_strto: numbers of each kind written out one
+ * after another into a text buffer, with jutoa()/jitoa()/jdtoa() and with
+ * snprintf(). The doubles go to snprintf as "%.17g", the shortest format it
+ * has that always round trips.
+ *
+ * usage: jstdlib_toa [numbers] [rounds]
+ */
+
+#include "jstdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static volatile size_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+enum kind { SMALL, INT64, PRICE, UNIFORM, BITS };
+
+union number {
+	long long i;
+	double d;
+};
+
+static union number number(enum kind k)
+{
+	union number v;
+	uint64_t bits;
+
+	switch (k) {
+	case SMALL:
+		v.i = rnd() % 10000;
+		break;
+	case INT64:
+		v.i = (long long)rnd();
+		break;
+	case PRICE:
+		v.d = (double)(rnd() % 10000000) / 100;
+		break;
+	case UNIFORM:
+		v.d = (double)(rnd() >> 11) / (1ULL << 53) * 1000;
+		break;
+	default:
+		/* any finite double at all */
+		do {
+			bits = rnd();
+			memcpy(&v.d, &bits, sizeof(bits));
+		} while (v.d != v.d || v.d - v.d != 0);
+		break;
+	}
+	return v;
+}
+
+/* ns per number for one pass of `expr` over every number */
+#define TIME(expr)                                                   \
+	({                                                           \
+		double t0 = now();                                   \
+		for (size_t r = 0; r < rounds; r++) {                \
+			char *p = text;                              \
+			for (size_t i = 0; i < n; i++)               \
+				p = (expr);                          \
+			sink += p - text;                            \
+		}                                                    \
+		(now() - t0) / ((double)rounds * n);                 \
+	})
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 100000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 20;
+	static const char *names[] = { "small", "int64", "price", "uniform",
+				       "bits" };
+	union number *v = malloc(n * sizeof(*v));
+	char *text = malloc(n * JDTOA_MAX);
+
+	printf("jstdlib_toa: %zu numbers, %zu rounds, ns per number\n", n,
+	       rounds);
+	printf("  %-9s %9s %9s\n", "numbers", "j*toa", "snprintf");
+	for (int k = SMALL; k <= BITS; k++) {
+		double ns[2];
+
+		for (size_t i = 0; i < n; i++)
+			v[i] = number(k);
+		if (k == SMALL || k == INT64) {
+			ns[0] = TIME(jitoa(p, v[i].i));
+			ns[1] = TIME(p + snprintf(p, JITOA_MAX, "%lld", v[i].i));
+		} else {
+			ns[0] = TIME(jdtoa(p, v[i].d));
+			ns[1] = TIME(p + snprintf(p, JDTOA_MAX, "%.17g", v[i].d));
+		}
+		printf("  %-9s %9.2f %9.2f\n", names[k], ns[0], ns[1]);
+	}
+	free(text);
+	free(v);
+	return 0;
+}
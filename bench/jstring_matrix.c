@@ -0,0 +1,628 @@
+/* bench/jstring_matrix.c - JString Kernel Benchmark Matrix
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Times every libc-equivalent function of jstring.h next to glibc's, over a
+ * matrix of lengths (0 B to 64 MiB by default), source and destination
+ * misalignments (0 to 63) and cache state:
+ *
+ *   hot   the same buffers are used over and over, so they sit in the cache
+ *   cold  the buffers are flushed from every cache level before each call
+ *
+ * One CSV row per cell goes to stdout, everything else to stderr, so two
+ * runs can be diffed or loaded side by side:
+ *
+ *   func,impl,bytes,src_align,dst_align,cache,calls,ns_per_call,gb_per_s
+ *
+ * Before timing anything, each function is checked against glibc on strings
+ * and buffers that start right after or end right before an inaccessible
+ * page. A read past the end faults, a wrong result stops the run.
+ *
+ * usage: jstring_matrix [-m max_bytes] [-t usec_per_cell] [-f func]
+ *                       [-c hot|cold] [-a]
+ *
+ *   -m  largest length, 64 MiB by default
+ *   -t  time spent on each cell, 2000 us by default
+ *   -f  only the functions whose name contains this
+ *   -c  only one cache state
+ *   -a  every misalignment pair up to 63, not just a representative set
+ */
+
+#define _GNU_SOURCE /* strchrnul() */
+#include "jmm.h"
+#include "jstring.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define MAX_ALIGN 64
+#define SWEEP_LIMIT (1 << 20) /* longer lengths only try a few alignments */
+
+/* one implementation of the functions under test */
+struct impl {
+	const char *name;
+	void *(*memcpy)(void *restrict, const void *restrict, size_t);
+	void *(*memmove)(void *, const void *, size_t);
+	void *(*memset)(void *, int, size_t);
+	int (*memcmp)(const void *, const void *, size_t);
+	size_t (*strlen)(const char *);
+	char *(*stpcpy)(char *restrict, const char *restrict);
+	char *(*strcpy)(char *restrict, const char *restrict);
+	char *(*strcat)(char *restrict, const char *restrict);
+	char *(*strncpy)(char *restrict, const char *restrict, size_t);
+	char *(*stpncpy)(char *restrict, const char *restrict, size_t);
+	int (*strcmp)(const char *, const char *);
+	int (*strncmp)(const char *, const char *, size_t);
+	char *(*strchr)(const char *, int);
+	char *(*strrchr)(const char *, int);
+	char *(*strchrnul)(const char *, int);
+	char *(*strsep)(char **restrict, const char *restrict);
+	char *(*strdup)(const char *);
+	char *(*strndup)(const char *, size_t);
+	int (*strcasecmp)(const char *, const char *);
+	int (*strncasecmp)(const char *, const char *, size_t);
+	void (*free)(void *);
+};
+
+/* through pointers, so GCC can't expand glibc's calls as builtins */
+static const struct impl *volatile impls[2] = {
+	&(const struct impl){
+		.name = "jstring",
+		.memcpy = jmemcpy,
+		.memmove = jmemmove,
+		.memset = jmemset,
+		.memcmp = jmemcmp,
+		.strlen = jstrlen,
+		.stpcpy = jstpcpy,
+		.strcpy = jstrcpy,
+		.strcat = jstrcat,
+		.strncpy = jstrncpy,
+		.stpncpy = jstpncpy,
+		.strcmp = jstrcmp,
+		.strncmp = jstrncmp,
+		.strchr = jstrchr,
+		.strrchr = jstrrchr,
+		.strchrnul = jstrchrnul,
+		.strsep = jstrsep,
+		.strdup = jstrdup,
+		.strndup = jstrndup,
+		.strcasecmp = jstrcasecmp,
+		.strncasecmp = jstrncasecmp,
+		.free = jfree,
+	},
+	&(const struct impl){
+		.name = "glibc",
+		.memcpy = memcpy,
+		.memmove = memmove,
+		.memset = memset,
+		.memcmp = memcmp,
+		.strlen = strlen,
+		.stpcpy = stpcpy,
+		.strcpy = strcpy,
+		.strcat = strcat,
+		.strncpy = strncpy,
+		.stpncpy = stpncpy,
+		.strcmp = strcmp,
+		.strncmp = strncmp,
+		.strchr = strchr,
+		.strrchr = strrchr,
+		.strchrnul = strchrnul,
+		.strsep = strsep,
+		.strdup = strdup,
+		.strndup = strndup,
+		.strcasecmp = strcasecmp,
+		.strncasecmp = strncasecmp,
+		.free = free,
+	},
+};
+
+/* what a call works on */
+struct cell {
+	char *src;
+	char *dst;
+	size_t n;
+};
+
+/*
+ * How a function is called and what its buffers have to look like: STR
+ * wants `src` to be a string of `n` bytes, STR2 wants `dst` to be an equal
+ * one, MEM2 wants `dst` to hold the same bytes as `src`, CAT wants `dst` to
+ * hold the first half of the string.
+ */
+enum { MEM, MEM2, STR, STR2, CAT };
+
+struct func {
+	const char *name;
+	int setup;
+	bool two; /* uses `dst`, so its alignment is swept too */
+	uintptr_t (*call)(const struct impl *f, struct cell *c);
+};
+
+static uintptr_t call_memcpy(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->memcpy(c->dst, c->src, c->n);
+}
+
+static uintptr_t call_memmove(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->memmove(c->dst, c->src, c->n);
+}
+
+static uintptr_t call_memset(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->memset(c->dst, 'm', c->n);
+}
+
+static uintptr_t call_memcmp(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->memcmp(c->src, c->dst, c->n);
+}
+
+static uintptr_t call_strlen(const struct impl *f, struct cell *c)
+{
+	return f->strlen(c->src);
+}
+
+static uintptr_t call_stpcpy(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->stpcpy(c->dst, c->src);
+}
+
+static uintptr_t call_strcpy(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strcpy(c->dst, c->src);
+}
+
+static uintptr_t call_strcat(const struct impl *f, struct cell *c)
+{
+	/* put the end of the first half back where it was */
+	c->dst[c->n / 2] = '\0';
+	return (uintptr_t)f->strcat(c->dst, c->src + c->n / 2);
+}
+
+static uintptr_t call_strncpy(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strncpy(c->dst, c->src, c->n);
+}
+
+static uintptr_t call_stpncpy(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->stpncpy(c->dst, c->src, c->n);
+}
+
+static uintptr_t call_strcmp(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strcmp(c->src, c->dst);
+}
+
+static uintptr_t call_strncmp(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strncmp(c->src, c->dst, c->n);
+}
+
+/* the searches look for a byte that isn't there, so they scan it all */
+static uintptr_t call_strchr(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strchr(c->src, '#');
+}
+
+static uintptr_t call_strrchr(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strrchr(c->src, '#');
+}
+
+static uintptr_t call_strchrnul(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strchrnul(c->src, '#');
+}
+
+static uintptr_t call_strsep(const struct impl *f, struct cell *c)
+{
+	char *p = c->src;
+
+	/* no delimiter in it, so the string is left as it was */
+	return (uintptr_t)f->strsep(&p, "#");
+}
+
+static uintptr_t call_strdup(const struct impl *f, struct cell *c)
+{
+	char *p = f->strdup(c->src);
+
+	f->free(p);
+	return (uintptr_t)p;
+}
+
+static uintptr_t call_strndup(const struct impl *f, struct cell *c)
+{
+	char *p = f->strndup(c->src, c->n);
+
+	f->free(p);
+	return (uintptr_t)p;
+}
+
+static uintptr_t call_strcasecmp(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strcasecmp(c->src, c->dst);
+}
+
+static uintptr_t call_strncasecmp(const struct impl *f, struct cell *c)
+{
+	return (uintptr_t)f->strncasecmp(c->src, c->dst, c->n);
+}
+
+static const struct func funcs[] = {
+	{ "memcpy", MEM, true, call_memcpy },
+	{ "memmove", MEM, true, call_memmove },
+	{ "memset", MEM, true, call_memset },
+	{ "memcmp", MEM2, true, call_memcmp },
+	{ "strlen", STR, false, call_strlen },
+	{ "stpcpy", STR, true, call_stpcpy },
+	{ "strcpy", STR, true, call_strcpy },
+	{ "strcat", CAT, true, call_strcat },
+	{ "strncpy", STR, true, call_strncpy },
+	{ "stpncpy", STR, true, call_stpncpy },
+	{ "strcmp", STR2, true, call_strcmp },
+	{ "strncmp", STR2, true, call_strncmp },
+	{ "strchr", STR, false, call_strchr },
+	{ "strrchr", STR, false, call_strrchr },
+	{ "strchrnul", STR, false, call_strchrnul },
+	{ "strsep", STR, false, call_strsep },
+	{ "strdup", STR, false, call_strdup },
+	{ "strndup", STR, false, call_strndup },
+	{ "strcasecmp", STR2, true, call_strcasecmp },
+	{ "strncasecmp", STR2, true, call_strncasecmp },
+};
+
+#define NFUNCS (sizeof(funcs) / sizeof(funcs[0]))
+
+static volatile uintptr_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void *map(size_t len)
+{
+	void *p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		perror("jstring_matrix: mmap");
+		exit(1);
+	}
+	return p;
+}
+
+/* a string of `n` bytes that none of the searches look for */
+static void fill(char *p, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		p[i] = (char)('a' + i % 23);
+	p[n] = '\0';
+}
+
+static void setup(const struct func *fn, struct cell *c)
+{
+	switch (fn->setup) {
+	case MEM:
+		fill(c->src, c->n);
+		break;
+	case MEM2:
+	case STR2:
+		fill(c->src, c->n);
+		fill(c->dst, c->n);
+		break;
+	case STR:
+		fill(c->src, c->n);
+		break;
+	case CAT:
+		fill(c->src, c->n);
+		fill(c->dst, c->n / 2);
+		break;
+	}
+}
+
+/* pushes `n` bytes at `p` out of every cache level */
+static void evict(const char *p, size_t n)
+{
+#if defined(__SSE2__)
+	for (size_t i = 0; i < n + 64; i += 64)
+		_mm_clflush(p + i);
+	_mm_mfence();
+#else
+	/* no flush instruction, so read something bigger than any cache */
+	static char *junk;
+	static const size_t len = 256 << 20;
+
+	(void)p;
+	(void)n;
+	if (!junk)
+		junk = map(len);
+	for (size_t i = 0; i < len; i += 64)
+		sink += junk[i];
+#endif
+}
+
+/* what reading the clock twice costs, taken off every cold call */
+static double clock_cost;
+
+static void calibrate(void)
+{
+	double t = now();
+	int n = 10000;
+
+	for (int i = 0; i < n; i++)
+		sink += (uintptr_t)now();
+	clock_cost = (now() - t) / n;
+}
+
+/* runs one cell, returns ns per call */
+static double cell(const struct func *fn, const struct impl *f,
+		   struct cell *c, bool cold, double budget, size_t *calls)
+{
+	double spent = 0;
+	double t;
+	size_t k = 0;
+
+	setup(fn, c);
+	if (!cold) {
+		/* warm up, then time ever bigger batches so the clock is noise */
+		sink += fn->call(f, c);
+		for (size_t batch = 1; spent < budget; batch *= 2) {
+			t = now();
+			for (size_t i = 0; i < batch; i++)
+				sink += fn->call(f, c);
+			spent += now() - t;
+			k += batch;
+		}
+	} else {
+		do {
+			evict(c->src, c->n);
+			evict(c->dst, c->n);
+			t = now();
+			sink += fn->call(f, c);
+			spent += now() - t;
+			k++;
+		} while (spent < budget);
+		spent -= k * clock_cost;
+	}
+	*calls = k;
+	return spent > 0 ? spent / k : 0;
+}
+
+/*
+ * ==========================================================================
+ */
+
+static int sign(long v)
+{
+	return (v > 0) - (v < 0);
+}
+
+/*
+ * Runs `fn` from both implementations on the same input, with one byte of
+ * slack at most between the data and an inaccessible page. Returns false if
+ * they disagree.
+ */
+static bool agree(const struct func *fn, char *src, char *dj, char *dg,
+		  size_t n)
+{
+	const struct impl *j = impls[0];
+	const struct impl *g = impls[1];
+	struct cell cj = { src, dj, n };
+	struct cell cg = { src, dg, n };
+	uintptr_t rj;
+	uintptr_t rg;
+	size_t out = n + 1;
+
+	setup(fn, &cj);
+	if (fn->setup == MEM2 || fn->setup == STR2) {
+		/* equal, then different at the very last byte */
+		for (int round = 0; round < 2; round++) {
+			rj = fn->call(j, &cj);
+			rg = fn->call(g, &cj);
+			if (sign((int)rj) != sign((int)rg))
+				return false;
+			if (n == 0)
+				break;
+			dj[n - 1] = 'A';
+		}
+		return true;
+	}
+	setup(fn, &cg);
+	rj = fn->call(j, &cj);
+	rg = fn->call(g, &cg);
+	if (fn->call == call_strdup || fn->call == call_strndup)
+		return (rj != 0) == (rg != 0);
+	/* lengths, or pointers into `src` */
+	if (fn->call == call_strlen || fn->call == call_strsep ||
+	    fn->call == call_strchr || fn->call == call_strrchr ||
+	    fn->call == call_strchrnul)
+		return rj == rg;
+	/* the rest write to their own `dst` and return a pointer into it */
+	if (rj - (uintptr_t)dj != rg - (uintptr_t)dg)
+		return false;
+	if (fn->setup == MEM || fn->call == call_strncpy ||
+	    fn->call == call_stpncpy)
+		out = n;
+	return memcmp(dj, dg, out) == 0;
+}
+
+/*
+ * Checks every function on lengths up to 96 that start right after, or end
+ * right before, a PROT_NONE page. Returns the number of disagreements.
+ */
+static int check_pages(void)
+{
+	size_t pg = sysconf(_SC_PAGESIZE);
+	char *r = map(9 * pg);
+	char *src_lo = r + pg; /* a page after a guard */
+	char *src_hi = r + 4 * pg; /* the end of one before a guard */
+	char *dj = r + 5 * pg;
+	char *dg = r + 7 * pg;
+	int bad = 0;
+
+	mprotect(r, pg, PROT_NONE);
+	mprotect(r + 2 * pg, pg, PROT_NONE);
+	mprotect(r + 4 * pg, pg, PROT_NONE);
+	mprotect(r + 6 * pg, pg, PROT_NONE);
+	mprotect(r + 8 * pg, pg, PROT_NONE);
+	for (size_t i = 0; i < NFUNCS; i++) {
+		const struct func *fn = &funcs[i];
+
+		for (size_t n = 0; n <= 96; n++) {
+			for (size_t k = 0; k < 16; k++) {
+				/* src right at a page start, then ending at one */
+				char *lo = src_lo + k;
+				char *hi = src_hi - n - 1 - k;
+				char *dl = dj + pg - n - 1 - k;
+				char *gl = dg + pg - n - 1 - k;
+
+				if (!agree(fn, lo, dl, gl, n) ||
+				    !agree(fn, hi, dl, gl, n)) {
+					fprintf(stderr,
+						"jstring_matrix: %s disagrees "
+						"with glibc, n=%zu k=%zu\n",
+						fn->name, n, k);
+					bad++;
+					break;
+				}
+			}
+		}
+	}
+	munmap(r, 9 * pg);
+	return bad;
+}
+
+/*
+ * ==========================================================================
+ */
+
+/* a representative set, the full 0..63 sweep is -a */
+static const size_t aligns[] = { 0, 1, 3, 7, 8, 15, 16, 31, 32, 33, 63 };
+
+#define NALIGNS (sizeof(aligns) / sizeof(aligns[0]))
+
+static void run(const struct func *fn, char *src, char *dst, size_t max,
+		bool all, int caches, double budget)
+{
+	size_t pairs[MAX_ALIGN * MAX_ALIGN][2];
+
+	for (size_t n = 0; n <= max; n = n ? n * 2 : 1) {
+		size_t np = 0;
+
+		/* the pairs worth timing at this length */
+		if (n > SWEEP_LIMIT) {
+			pairs[np][0] = 0, pairs[np++][1] = 0;
+			pairs[np][0] = 1, pairs[np++][1] = 0;
+			if (fn->two)
+				pairs[np][0] = 0, pairs[np++][1] = 1;
+		} else if (all) {
+			for (size_t s = 0; s < MAX_ALIGN; s++) {
+				for (size_t d = 0; d < (fn->two ? MAX_ALIGN : 1);
+				     d++)
+					pairs[np][0] = s, pairs[np++][1] = d;
+			}
+		} else {
+			for (size_t a = 0; a < NALIGNS; a++) {
+				pairs[np][0] = aligns[a], pairs[np++][1] = 0;
+				if (!fn->two || !aligns[a])
+					continue;
+				pairs[np][0] = aligns[a];
+				pairs[np++][1] = aligns[a];
+				pairs[np][0] = 0, pairs[np++][1] = aligns[a];
+			}
+		}
+		for (size_t p = 0; p < np; p++) {
+			struct cell c = { src + pairs[p][0], dst + pairs[p][1],
+					  n };
+
+			for (int cold = 0; cold < 2; cold++) {
+				if (!(caches & (1 << cold)))
+					continue;
+				for (int i = 0; i < 2; i++) {
+					size_t calls;
+					double ns = cell(fn, impls[i], &c, cold,
+							 budget, &calls);
+
+					printf("%s,%s,%zu,%zu,%zu,%s,%zu,%.2f,%.3f\n",
+					       fn->name, impls[i]->name, n,
+					       pairs[p][0], pairs[p][1],
+					       cold ? "cold" : "hot", calls, ns,
+					       ns > 0 ? n / ns : 0);
+				}
+			}
+		}
+		fflush(stdout);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	size_t max = 64 << 20;
+	double budget = 2000 * 1e3;
+	const char *only = NULL;
+	int caches = 3; /* bit 0 hot, bit 1 cold */
+	bool all = false;
+	char *src;
+	char *dst;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "m:t:f:c:a")) != -1) {
+		switch (opt) {
+		case 'm':
+			max = strtoull(optarg, NULL, 0);
+			break;
+		case 't':
+			budget = strtod(optarg, NULL) * 1e3;
+			break;
+		case 'f':
+			only = optarg;
+			break;
+		case 'c':
+			caches = strcmp(optarg, "cold") == 0 ? 2 : 1;
+			break;
+		case 'a':
+			all = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-m max_bytes] "
+					"[-t usec_per_cell] [-f func] "
+					"[-c hot|cold] [-a]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+
+	if (check_pages()) {
+		fprintf(stderr, "jstring_matrix: page boundary check failed\n");
+		return 1;
+	}
+	fprintf(stderr, "jstring_matrix: page boundary check passed\n");
+	calibrate();
+
+	/* room for the string, its '\0' and the largest misalignment */
+	src = map(max + 2 * MAX_ALIGN);
+	dst = map(max + 2 * MAX_ALIGN);
+	printf("func,impl,bytes,src_align,dst_align,cache,calls,ns_per_call,"
+	       "gb_per_s\n");
+	for (size_t i = 0; i < NFUNCS; i++) {
+		if (only && !strstr(funcs[i].name, only))
+			continue;
+		fprintf(stderr, "jstring_matrix: %s\n", funcs[i].name);
+		run(&funcs[i], src, dst, max, all, caches, budget);
+	}
+	return 0;
+}
@@ -0,0 +1,118 @@
+/* bench/jstring_strsort.c - String Sorting Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * jstrsort() against qsort() and jqsort() comparing with jstrcmp(), on the
+ * keys batch jobs sort: URLs, which share a scheme, a few hosts and path
+ * prefixes, and log keys, which share a date and most of a timestamp. The
+ * strings are allocated in shuffled order, as they are when they come from
+ * a hash table, so following a pointer is a cache miss.
+ *
+ * usage: jstring_strsort [keys] [rounds]
+ */
+
+#include "jstdlib.h"
+#include "jstring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t rnd(void)
+{
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+static int by_jstrcmp(const void *a, const void *b)
+{
+	return jstrcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int url(char *buf)
+{
+	static const char *hosts[] = { "www.example.com", "api.example.com",
+				       "cdn.example.net", "example.org" };
+	static const char *paths[] = { "/", "/static/js/", "/static/img/",
+				       "/api/v2/users/", "/api/v2/orders/",
+				       "/blog/2026/10/" };
+
+	return sprintf(buf, "https://%s%s%llu?session=%llx", hosts[rnd() % 4],
+		       paths[rnd() % 6], (unsigned long long)(rnd() % 100000),
+		       (unsigned long long)(rnd() % 0x1000000));
+}
+
+static int log_key(char *buf)
+{
+	static const char *levels[] = { "INFO", "WARN", "ERROR", "DEBUG" };
+	unsigned long long ms = rnd() % (3600ULL * 1000);
+
+	return sprintf(buf, "2026-10-19T14:%02llu:%02llu.%03lluZ host-%02llu %s",
+		       ms / 60000, ms / 1000 % 60, ms % 1000,
+		       (unsigned long long)(rnd() % 32), levels[rnd() % 4]);
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 3;
+	static const char *names[] = { "urls", "log keys" };
+	char *pool = malloc(n * 96);
+	char **keys = malloc(n * sizeof(*keys));
+	char **work = malloc(n * sizeof(*work));
+
+	printf("jstring_strsort: %zu keys, %zu rounds, ns per key\n", n, rounds);
+	printf("  %-9s %9s %9s %9s\n", "keys", "jstrsort", "qsort", "jqsort");
+	for (int d = 0; d < 2; d++) {
+		double ns[3] = { 0 };
+
+		for (size_t i = 0; i < n; i++) {
+			keys[i] = pool + i * 96;
+			(d ? log_key : url)(keys[i]);
+		}
+		/* scattered through memory, not in the order they're listed */
+		for (size_t i = n; i > 1; i--) {
+			size_t j = rnd() % i;
+			char *t = keys[i - 1];
+
+			keys[i - 1] = keys[j];
+			keys[j] = t;
+		}
+		for (size_t r = 0; r < rounds; r++) {
+			double t0;
+
+			memcpy(work, keys, n * sizeof(*work));
+			t0 = now();
+			jstrsort(work, n);
+			ns[0] += now() - t0;
+			memcpy(work, keys, n * sizeof(*work));
+			t0 = now();
+			qsort(work, n, sizeof(*work), by_jstrcmp);
+			ns[1] += now() - t0;
+			memcpy(work, keys, n * sizeof(*work));
+			t0 = now();
+			jqsort(work, n, sizeof(*work), by_jstrcmp);
+			ns[2] += now() - t0;
+		}
+		printf("  %-9s %9.1f %9.1f %9.1f\n", names[d],
+		       ns[0] / ((double)rounds * n), ns[1] / ((double)rounds * n),
+		       ns[2] / ((double)rounds * n));
+	}
+	free(pool);
+	free(keys);
+	free(work);
+	return 0;
+}
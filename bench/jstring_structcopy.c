@@ -0,0 +1,94 @@
+/* bench/jstring_structcopy.c - Constant Size jmem* Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * Struct copying and clearing the way real code does it, with jmemcpy() and
+ * jmemset() of a sizeof(). Each record size is timed three ways: through the
+ * inline expansion jstring.h does for small constant sizes, through the out
+ * of line function, and as a plain struct assignment for reference.
+ *
+ * usage: jstring_structcopy [rounds]
+ */
+
+#include "jstring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#define RECS 4096 /* per array, small enough to stay in the cache */
+
+#define REC(n)                   \
+	struct rec##n {          \
+		uint8_t b[n];    \
+	}
+
+REC(8);
+REC(16);
+REC(24);
+REC(48);
+REC(64);
+
+static volatile uint8_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+/*
+ * One timing per way of copying. The loops are written out for each record
+ * type, so `sizeof` stays a constant the compiler can see.
+ */
+#define BENCH(n, rounds)                                                      \
+	do {                                                                  \
+		static struct rec##n src[RECS], dst[RECS];                    \
+		double t;                                                     \
+		double ns[4];                                                 \
+		for (size_t i = 0; i < RECS; i++)                             \
+			src[i].b[0] = (uint8_t)i;                             \
+		t = now();                                                    \
+		for (size_t r = 0; r < rounds; r++)                           \
+			for (size_t i = 0; i < RECS; i++)                     \
+				jmemcpy(&dst[i], &src[(i + r) % RECS],        \
+					sizeof(dst[i]));                      \
+		ns[0] = (now() - t) / ((double)rounds * RECS);                \
+		t = now();                                                    \
+		for (size_t r = 0; r < rounds; r++)                           \
+			for (size_t i = 0; i < RECS; i++)                     \
+				(jmemcpy)(&dst[i], &src[(i + r) % RECS],      \
+					  sizeof(dst[i]));                    \
+		ns[1] = (now() - t) / ((double)rounds * RECS);                \
+		t = now();                                                    \
+		for (size_t r = 0; r < rounds; r++)                           \
+			for (size_t i = 0; i < RECS; i++)                     \
+				dst[i] = src[(i + r) % RECS];                 \
+		ns[2] = (now() - t) / ((double)rounds * RECS);                \
+		t = now();                                                    \
+		for (size_t r = 0; r < rounds; r++)                           \
+			for (size_t i = 0; i < RECS; i++)                     \
+				jmemset(&dst[i], (int)r, sizeof(dst[i]));     \
+		ns[3] = (now() - t) / ((double)rounds * RECS);                \
+		sink = dst[RECS - 1].b[0];                                    \
+		printf("  %3d bytes  %8.2f %8.2f %8.2f %8.2f\n", n, ns[0],    \
+		       ns[1], ns[2], ns[3]);                                  \
+	} while (0)
+
+int main(int argc, char **argv)
+{
+	size_t rounds = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+
+	printf("jstring_structcopy: %zu rounds of %d records, ns per record\n",
+	       rounds, RECS);
+	printf("  %9s  %8s %8s %8s %8s\n", "record", "inline", "call", "assign",
+	       "memset");
+	BENCH(8, rounds);
+	BENCH(16, rounds);
+	BENCH(24, rounds);
+	BENCH(48, rounds);
+	BENCH(64, rounds);
+	return 0;
+}
@@ -0,0 +1,134 @@
+/* bench/jstring_utf8.c - UTF-8 Validation Throughput Benchmark
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+/*
+ * jutf8_validate() and jutf8_count() against a plain byte at a time
+ * validator, on texts from all ASCII to all four byte sequences. Every text
+ * is valid, so each run goes through all of it.
+ *
+ * usage: jstring_utf8 [bytes] [rounds]
+ */
+
+#include "jstring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+static volatile size_t sink;
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+/* what one would write without thinking about speed */
+static bool reference(const unsigned char *s, size_t n)
+{
+	size_t i = 0;
+
+	while (i < n) {
+		unsigned char c = s[i];
+		uint32_t cp;
+		int len;
+
+		if (c < 0x80) {
+			i++;
+			continue;
+		}
+		if (c >= 0xf8 || c < 0xc0)
+			return false;
+		len = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : 2;
+		if (n - i < (size_t)len)
+			return false;
+		cp = c & (0x7f >> len);
+		for (int k = 1; k < len; k++) {
+			if ((s[i + k] & 0xc0) != 0x80)
+				return false;
+			cp = cp << 6 | (s[i + k] & 0x3f);
+		}
+		if (cp < (len == 2 ? 0x80 : len == 3 ? 0x800 : 0x10000) ||
+		    cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+			return false;
+		i += len;
+	}
+	return true;
+}
+
+/* a text of `n` bytes drawn from `chars`, which are valid UTF-8 */
+static unsigned char *text(size_t n, const char *const *chars, int nchars)
+{
+	unsigned char *t = malloc(n);
+	size_t i = 0;
+
+	srand(1);
+	while (i < n) {
+		const char *c = chars[rand() % nchars];
+		size_t len = jstrlen(c);
+
+		if (len > n - i)
+			c = "a", len = 1;
+		jmemcpy(t + i, c, len);
+		i += len;
+	}
+	return t;
+}
+
+/* GB/s of `expr` over `rounds` runs */
+#define RATE(expr)                                              \
+	({                                                      \
+		double t0 = now();                              \
+		for (size_t r = 0; r < rounds; r++)             \
+			sink += (expr);                         \
+		(double)n * rounds / (now() - t0);              \
+	})
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 1 << 20;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 200;
+	static const char *ascii[] = { "a", "b", " ", "e", "t", "\n" };
+	static const char *latin[] = { "a", "e", " ", "t", "r", "s",
+				       "\xc3\xa9", "o", "n", "i" };
+	static const char *greek[] = { "\xce\xb1", "\xce\xb2", " ", "\xce\xbb",
+				       "\xcf\x80" };
+	static const char *cjk[] = { "\xe6\x97\xa5", "\xe6\x9c\xac",
+				     "\xe8\xaa\x9e", "\xe3\x80\x82" };
+	static const char *emoji[] = { "\xf0\x9f\x98\x80", "\xf0\x9f\x8e\x89",
+				       "\xf0\x9f\x9a\x80" };
+	static const char *mixed[] = { "a", "\xc3\xa9", "\xe6\x97\xa5",
+				       "\xf0\x9f\x98\x80" };
+	const struct {
+		const char *name;
+		const char *const *chars;
+		int nchars;
+	} kinds[] = {
+		{ "ascii", ascii, 6 }, { "latin", latin, 10 },
+		{ "greek", greek, 5 }, { "cjk", cjk, 4 },
+		{ "emoji", emoji, 3 }, { "mixed", mixed, 4 },
+	};
+
+	printf("jstring_utf8: %zu bytes, %zu rounds, GB/s\n", n, rounds);
+	printf("  %-6s %10s %10s %10s\n", "text", "reference", "validate",
+	       "count");
+	for (size_t k = 0; k < sizeof(kinds) / sizeof(*kinds); k++) {
+		unsigned char *t = text(n, kinds[k].chars, kinds[k].nchars);
+
+		if (!reference(t, n) || !jutf8_validate(t, n)) {
+			fprintf(stderr, "jstring_utf8: %s text is invalid\n",
+				kinds[k].name);
+			return 1;
+		}
+		double ref = RATE(reference(t, n));
+		double val = RATE(jutf8_validate(t, n));
+		double cnt = RATE(jutf8_count(t, n));
+
+		printf("  %-6s %10.2f %10.2f %10.2f\n", kinds[k].name, ref, val,
+		       cnt);
+		free(t);
+	}
+	return 0;
+}
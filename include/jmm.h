@@ -19,6 +19,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 #include <stdalign.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 
 #if defined(__has_feature) && __has_feature(nullability)
@@ -30,11 +31,30 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 #define BLOCK_LIT 4096 /* always request 4096 bytes at least */
 #define BLOCK_MID 131072 /* 128 kibibytes */
 #define BLOCK_BIG 1048576 /* 1 mebibyte */
+#define MMAP_THRESHOLD BLOCK_BIG /* bigger blocks get their own mapping */
+
+/*
+ * jmallopt() parameters. Each one can also be set through the environment
+ * variable in brackets, which is read once before the first allocation.
+ */
+#define JM_GROWTH 1 /* sbrk() chunk growth factor, 1 turns it off [JMM_GROWTH] */
+#define JM_CHUNK_MAX 2 /* largest geometric chunk in bytes [JMM_CHUNK_MAX] */
+#define JM_PREFAULT 3 /* fault new memory in up front [JMM_PREFAULT] */
+#define JM_THP 4 /* huge page hint for regions this big, 0 is off [JMM_THP] */
+#define JM_REMOTE_FREE 5 /* queue jfree() on a busy heap [JMM_REMOTE_FREE] */
+#define JM_CACHE 6 /* small block cache, 1 per-CPU, 2 per-thread [JMM_CACHE] */
+#define JM_GUARD 7 /* blocks this big end at a guard page, 0 is off [JMM_GUARD] */
+#define JM_QUARANTINE 8 /* bytes of freed blocks kept from reuse [JMM_QUARANTINE] */
 
 typedef struct header header;
 struct __attribute__((aligned(16))) header {
 	size_t size; /* size of this block */
-	bool is_free; /* whether the block is free or not */
+	bool is_free : 1; /* whether the block is free or not */
+	bool is_mmap : 1; /* whether the block has its own mapping */
+	bool is_sampled : 1; /* whether the profiler is tracking the block */
+	bool is_guarded : 1; /* whether the block ends at a guard page */
+	uint16_t heap; /* id of the heap it came from, 0 for jmalloc() */
+	uint32_t check; /* header checksum, JMM_HARDENED builds only */
 	header *prev; /* the prev block if on free list */
 	header *next; /* the next block if on free list */
 };
@@ -44,6 +64,41 @@ struct __attribute__((aligned(16))) header {
  */
 extern header *upbrk(size_t size);
 
+/*
+ * Helper for calling mmap(), used for blocks above MMAP_THRESHOLD. The
+ * payload is aligned to `align` if that's bigger than the header.
+ */
+extern header *upmap(size_t size, size_t align);
+
+/*
+ * Takes and releases the heap lock. Every public function takes it, these are
+ * for code that has to keep the heap still across several calls.
+ */
+extern void jmm_lock(void);
+extern void jmm_unlock(void);
+
+/*
+ * Gives a block back to the heap without the checks and bookkeeping of
+ * jfree(), for jcache, whose blocks went through jfree() already. The
+ * _locked variant is for callers that hold the heap lock.
+ */
+extern void jmm_reclaim(void *p);
+extern void jmm_reclaim_locked(void *p);
+
+/*
+ * Handlers for pthread_atfork(), so a child forked while another thread was
+ * inside jmm gets a usable heap.
+ */
+extern void jmm_fork_prepare(void);
+extern void jmm_fork_parent(void);
+extern void jmm_fork_child(void);
+
+/*
+ * Adjusts the growth policy, like mallopt(). Returns 1 on success, 0 if
+ * `param` is unknown or `value` is out of range.
+ */
+extern int jmallopt(int param, int value);
+
 /*
  * Allocates memory of size `size`, returs the pointer
  */
@@ -58,4 +113,221 @@ extern void jfree(void *__jnullable p);
  * Reallocates the space used on the heap by `p` to size `size`.
  */
 extern void *jrealloc(void *__jnullable p, size_t size);
+
+/*
+ * Allocates zeroed memory for an array of `nmemb` elements of `size` bytes.
+ * Returns NULL with errno set to ENOMEM if the product overflows.
+ */
+extern void *jcalloc(size_t nmemb, size_t size);
+
+/*
+ * Allocates `size` bytes aligned to `alignment`, which must be a power of two,
+ * otherwise returns NULL with errno set to EINVAL. The block is released with
+ * jfree() like any other.
+ */
+extern void *jaligned_alloc(size_t alignment, size_t size);
+
+/*
+ * Returns the number of bytes that can be used in the block `p` points to,
+ * which may be more than was asked for. 0 if `p` is NULL.
+ */
+extern size_t jmalloc_usable_size(void *__jnullable p);
+
+/*
+ * Like jrealloc(p, nmemb * size), but returns NULL with errno set to ENOMEM
+ * instead of wrapping around if the product overflows. `p` is left alone
+ * then, as on any other failure.
+ */
+extern void *jreallocarray(void *__jnullable p, size_t nmemb, size_t size);
+
+/*
+ * Grows the array `p`, which has room for `*cap` elements of `size` bytes, so
+ * that it holds at least `min`. The capacity grows by half at a time and is
+ * rounded up to what the block can really hold; `*cap` is updated to match.
+ * Returns `p` untouched if it's big enough already, NULL with errno set to
+ * ENOMEM (and `p` still valid) if it can't grow, or EINVAL if `size` is 0.
+ */
+extern void *jgrow(void *__jnullable p, size_t *cap, size_t min, size_t size);
+
+/*
+ * ==========================================================================
+ *                              H E A P S
+ * ==========================================================================
+ */
+/*
+ * A heap of its own, with its own lock and memory, for data that lives and
+ * dies together. Destroying it releases everything that was allocated from
+ * it at once, without freeing block by block. A NULL heap stands for the
+ * default one jmalloc() uses, which can't be destroyed.
+ */
+#define JHEAP_MAX 1024 /* live heaps, the default one included */
+
+typedef struct jheap jheap_t;
+
+/*
+ * Creates an empty heap. Returns NULL with errno set to ENOMEM if out of
+ * memory or if JHEAP_MAX heaps exist already.
+ */
+extern jheap_t *jheap_create(void);
+
+/*
+ * Like jmalloc(), jfree() and jrealloc(), on `heap`. Blocks of any heap can
+ * also be given to jfree() and jrealloc(), they know where they came from.
+ */
+extern void *jheap_malloc(jheap_t *__jnullable heap, size_t size);
+extern void jheap_free(jheap_t *__jnullable heap, void *__jnullable p);
+extern void *jheap_realloc(jheap_t *__jnullable heap, void *__jnullable p,
+			   size_t size);
+
+/*
+ * Unmaps all the memory of `heap`, which invalidates every block still
+ * allocated from it. No other thread may be using the heap.
+ */
+extern void jheap_destroy(jheap_t *__jnullable heap);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                      A L L O C A T I O N   T R A C E
+ */
+/*
+ * One record per public call. Pointer ids are the addresses handed out, so
+ * an id can come back after it was freed; replaying in order keeps that
+ * unambiguous.
+ */
+#define JT_MALLOC 1
+#define JT_FREE 2
+#define JT_REALLOC 3
+
+#define JTRACE_RECS 4096 /* records buffered before a write() */
+
+struct jtrace_rec {
+	uint64_t ts; /* nanoseconds since the trace started */
+	uint64_t size; /* requested size, 0 for JT_FREE */
+	uint64_t ptr; /* pointer returned, 0 for JT_FREE or on failure */
+	uint64_t old; /* pointer passed in, 0 for JT_MALLOC */
+	uint32_t tid; /* calling thread */
+	uint8_t op; /* JT_* */
+	uint8_t pad[3];
+};
+
+extern bool jtrace_active;
+
+/*
+ * Starts writing allocation records to the file at `path`, truncating it.
+ * Also started when the library is loaded if JMM_TRACE is set to a path.
+ * Returns 0 on success, -1 with errno set otherwise.
+ */
+extern int jtrace_start(const char *path);
+
+/*
+ * Flushes the buffered records and closes the trace file. Called at exit if
+ * a trace is still running.
+ */
+extern void jtrace_stop(void);
+
+/*
+ * Stops tracing without flushing, for a forked child whose buffered records
+ * belong to the parent.
+ */
+extern void jtrace_drop(void);
+
+/*
+ * Appends a record to the ring buffer, flushing it to the file when full.
+ * The caller holds the heap lock.
+ */
+extern void jtrace_log(int op, size_t size, void *ptr, void *old);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                  S A M P L I N G   H E A P   P R O F I L E R
+ */
+/*
+ * Every byte allocated has a 1 in `rate` chance of being sampled, so the gaps
+ * between samples are geometrically distributed with mean `rate`. A sampled
+ * block keeps the stack of the call that allocated it until it's freed.
+ * Unsampled allocations only decrement jprof_countdown.
+ */
+#define JPROF_DEPTH 32 /* deepest stack kept per sample */
+#define JPROF_SLOTS 16384 /* most sampled blocks tracked at once */
+
+extern int64_t jprof_countdown;
+
+/*
+ * Starts sampling about once every `rate` allocated bytes, 0 stops it. Also
+ * started when the library is loaded if JMM_PROFILE is set to a rate; the
+ * profile is then written at exit to JMM_PROFILE_OUT, if that is set.
+ * Returns 0 on success, -1 with errno set otherwise.
+ */
+extern int jprof_start(size_t rate);
+
+/*
+ * Writes the live sampled blocks to `path` as a gperftools heap profile
+ * (heap_v2), which pprof reads and scales back up by the sampling rate.
+ * Returns 0 on success, -1 with errno set otherwise.
+ */
+extern int jprof_dump(const char *path);
+
+/*
+ * Records the stack of a block whose allocation crossed jprof_countdown, and
+ * draws the next countdown. The caller holds the heap lock.
+ */
+extern void jprof_sample(void *p, size_t size);
+
+/*
+ * Stops tracking a sampled block that is being freed or moved. The block
+ * itself isn't touched, it may be gone already; clearing is_sampled on one
+ * that stays is up to the caller, who holds the heap lock.
+ */
+extern void jprof_forget(void *p);
+
+extern bool jprof_active;
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                       S M A L L   B L O C K   C A C H E
+ */
+/*
+ * An optional front end that keeps freed small blocks in per-CPU stacks, so
+ * jmalloc() and jfree() can trade them without the heap lock. The stacks are
+ * pushed and popped inside rseq critical sections, so memory grows with the
+ * number of cores rather than threads. Without rseq (or with JM_CACHE set to
+ * 2) each thread gets its own stacks instead, flushed when it exits.
+ *
+ * Blocks in a cache still look allocated to the heap. The cache stays out of
+ * the way while tracing or profiling, which need to see every call.
+ */
+#define JCACHE_CLASSES 16 /* size classes, sizeof(header) apart */
+#define JCACHE_DEPTH 32 /* blocks kept per class and CPU */
+#define JCACHE_MAX ((JCACHE_CLASSES + 1) * sizeof(header)) /* largest block */
+
+extern bool jcache_active;
+
+/*
+ * Turns the cache off (0), on per-CPU (1) or on per-thread (2). Leaving
+ * the per-CPU mode gives the blocks in the per-CPU stacks back to the heap,
+ * turning the cache off does the same for the calling thread's stacks;
+ * other threads' go back when they exit. Returns 1 on success, 0 if `mode`
+ * is out of range. Called by jmallopt(JM_CACHE), with the heap lock held.
+ */
+extern int jcache_setup(int mode);
+
+/*
+ * Takes a cached block big enough for `size` bytes, NULL if there's none.
+ */
+extern void *jcache_pop(size_t size);
+
+/*
+ * Keeps the block `p` points to for later, false if it doesn't fit a size
+ * class or the stack is full. Called without the heap lock.
+ */
+extern bool jcache_push(void *p);
 #endif /* __JMM_H */
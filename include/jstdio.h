@@ -0,0 +1,263 @@
+#if !defined(__JSTDIO_H)
+# define __JSTDIO_H
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                       1 .   S T R E A M S
+ */
+/*
+ * 1. Streams
+ *     fopen ✔️
+ *     fdopen ✔️
+ *     fclose ✔️
+ *     fread ✔️
+ *     fwrite ✔️
+ *     fputs ✔️
+ *     fputc ✔️
+ *     fgetc ✔️
+ *     fgets ✔️
+ *     getline ✔️
+ *     fflush ✔️
+ *     flockfile ✔️
+ */
+/*
+ * A buffered stream over a file descriptor. Its buffers are JBUFSIZ bytes,
+ * page aligned and taken from jmalloc() the first time they're needed.
+ *
+ * Writes are gathered into up to four buffers, which go out together in a
+ * single writev() when the last one fills, on jfflush() and on jfclose().
+ * A write of JBUFSIZ bytes or more isn't copied at all: it goes out straight
+ * from the caller's memory, in the same writev() as whatever was queued
+ * before it. Large reads likewise go straight into the caller's memory,
+ * with the buffer refilled by the same readv().
+ *
+ * Every function locks the stream, so streams can be shared between
+ * threads. The _unlocked variants don't; they are for loops that own the
+ * stream, or that hold it with jflockfile().
+ */
+typedef struct jFILE jFILE;
+
+#define JBUFSIZ (64 * 1024)
+#define JEOF (-1)
+
+/*
+ * The standard streams. jstdout is line buffered when it is a terminal,
+ * jstderr isn't buffered. Every stream is flushed at exit.
+ */
+extern jFILE *const jstdin;
+extern jFILE *const jstdout;
+extern jFILE *const jstderr;
+
+/*
+ * The jfopen() function opens the file whose name is the string pointed to
+ * by path and associates a stream with it. mode is one of "r", "r+", "w",
+ * "w+", "a" and "a+" as for fopen(), optionally with 'b' (ignored), 'x'
+ * (O_EXCL) and 'e' (O_CLOEXEC). New files get mode 0666 minus the umask.
+ *
+ * The jfdopen() function associates a stream with the existing file
+ * descriptor fd, whose mode must be compatible with the mode of the stream.
+ *
+ * Upon successful completion they return a jFILE pointer. Otherwise, NULL is
+ * returned and errno is set to indicate the error.
+ */
+extern jFILE *jfopen(const char *restrict path, const char *restrict mode);
+extern jFILE *jfdopen(int fd, const char *mode);
+
+/*
+ * The jfclose() function flushes the stream pointed to by f and closes the
+ * underlying file descriptor. Returns 0, or JEOF with errno set if flushing
+ * or closing failed; the stream is gone either way. jstdin, jstdout and
+ * jstderr can't go away, anything done with them afterwards fails with
+ * EBADF.
+ */
+extern int jfclose(jFILE *f);
+
+/* The jfileno() function returns the file descriptor behind f. */
+extern int jfileno(jFILE *f);
+
+/*
+ * The jfread() function reads nmemb items of data, each size bytes long,
+ * from the stream pointed to by f, storing them at the location given by
+ * ptr. The jfwrite() function writes nmemb items of data, each size bytes
+ * long, to the stream pointed to by f, obtaining them from the location
+ * given by ptr.
+ *
+ * They return the number of items read or written, which is less than
+ * nmemb only at end of file (for jfread()) or on an error, which
+ * jfeof() and jferror() tell apart. A write whose buffers fail to go out
+ * counts the queued bytes that were lost against its own.
+ */
+extern size_t jfread(void *restrict ptr, size_t size, size_t nmemb,
+		     jFILE *restrict f);
+extern size_t jfwrite(const void *restrict ptr, size_t size, size_t nmemb,
+		      jFILE *restrict f);
+
+/*
+ * The jfputs() function writes the string s to f, without its terminating
+ * null byte, and returns a nonnegative number, or JEOF on error. jfputc()
+ * writes the character c, cast to an unsigned char, and returns it, or JEOF
+ * on error.
+ */
+extern int jfputs(const char *restrict s, jFILE *restrict f);
+extern int jfputc(int c, jFILE *f);
+
+/*
+ * The jfgetc() function reads the next character from f and returns it as
+ * an unsigned char cast to an int, or JEOF on end of file or error.
+ *
+ * The jfgets() function reads in at most one less than size characters from
+ * f and stores them into the buffer pointed to by s. Reading stops after an
+ * EOF or a newline. If a newline is read, it is stored into the buffer. A
+ * terminating null byte is stored after the last character in the buffer.
+ * It returns s on success, and NULL on error or when end of file occurs
+ * while no characters have been read.
+ */
+extern int jfgetc(jFILE *f);
+extern char *jfgets(char *restrict s, int size, jFILE *restrict f);
+
+/*
+ * The jgetline() function reads an entire line from f, storing the address
+ * of the buffer containing the text into *lineptr. The buffer is
+ * null-terminated and includes the newline character, if one was found.
+ *
+ * If *lineptr is NULL and *n is 0, jgetline() allocates a buffer for the
+ * line with jmalloc(), which should be freed with jfree() by the caller.
+ * If the buffer is too small, it is grown with jrealloc() and *lineptr and
+ * *n are updated.
+ *
+ * Returns the number of characters read, including the newline but not the
+ * null byte, or -1 on end of file with nothing read, or on error.
+ */
+extern ssize_t jgetline(char **restrict lineptr, size_t *restrict n,
+			jFILE *restrict f);
+
+/*
+ * For an output stream, jfflush() writes out all buffered data, in one
+ * writev(). For an input stream, it discards what was read ahead, seeking
+ * back over it where the file allows. If f is NULL, jfflush() flushes all
+ * open output streams. Returns 0, or JEOF with errno set on error; data
+ * that couldn't be written is dropped.
+ */
+extern int jfflush(jFILE *f);
+
+/*
+ * The jfeof() function tests the end-of-file indicator for f and jferror()
+ * its error indicator, which only jclearerr() clears.
+ */
+extern int jfeof(jFILE *f);
+extern int jferror(jFILE *f);
+extern void jclearerr(jFILE *f);
+
+/*
+ * The jflockfile() function makes the calling thread the owner of f,
+ * waiting for another owner to release it first, and jfunlockfile()
+ * releases it. Ownership nests: f is released after as many unlocks as
+ * there were locks.
+ */
+extern void jflockfile(jFILE *f);
+extern void jfunlockfile(jFILE *f);
+
+/*
+ * The same as the functions above without locking f; the caller must own
+ * it, or be the only thread using it.
+ */
+extern size_t jfread_unlocked(void *restrict ptr, size_t size, size_t nmemb,
+			      jFILE *restrict f);
+extern size_t jfwrite_unlocked(const void *restrict ptr, size_t size,
+			       size_t nmemb, jFILE *restrict f);
+extern int jfputs_unlocked(const char *restrict s, jFILE *restrict f);
+extern int jfputc_unlocked(int c, jFILE *f);
+extern int jfgetc_unlocked(jFILE *f);
+extern char *jfgets_unlocked(char *restrict s, int size, jFILE *restrict f);
+extern ssize_t jgetline_unlocked(char **restrict lineptr, size_t *restrict n,
+				 jFILE *restrict f);
+extern int jfflush_unlocked(jFILE *f);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                  2 .   M A P P E D   F I L E S
+ */
+/*
+ * 2. Mapped Files
+ *     jmapfile ✔️
+ */
+/*
+ * A file mapped read-only into memory, for scanning big files line by line
+ * without copying them. The records jmapfile_next() gives are slices of the
+ * mapping itself: nothing is read into a buffer, and nothing is written,
+ * so the last one doesn't need a terminator put after it.
+ *
+ * The kernel is told the file will be read front to back, and to start
+ * reading it in right away. pos is where the next record starts; setting
+ * it back to 0 goes over the file again. As with any mapping, a file cut
+ * short by someone else while it's mapped raises SIGBUS past its new end.
+ */
+typedef struct jmapfile jmapfile;
+struct jmapfile {
+	const char *data; /* the file's bytes, NULL if it's empty */
+	size_t size;
+	size_t pos;
+};
+
+/*
+ * The jmapfile_open() function maps the regular file at path into m, and
+ * jmapfile_fdopen() the one open as fd, which it leaves open. They return
+ * 0, or -1 with errno set to indicate the error.
+ */
+extern int jmapfile_open(jmapfile *m, const char *path);
+extern int jmapfile_fdopen(jmapfile *m, int fd);
+
+/*
+ * The jmapfile_next() function finds the next record in m, the bytes up to
+ * the next delim byte or the end of the file, and stores where it starts
+ * into *p and its length, delim not included, into *len. A delim at the
+ * very end of the file doesn't start another, empty record.
+ *
+ * Returns true, or false when there are no more records. jmapfile_line()
+ * does the same for lines; a "\r\n" line keeps its '\r'.
+ */
+extern bool jmapfile_next(jmapfile *restrict m, int delim,
+			  const char **restrict p, size_t *restrict len);
+
+static inline bool jmapfile_line(jmapfile *restrict m, const char **restrict p,
+				 size_t *restrict len)
+{
+	return jmapfile_next(m, '\n', p, len);
+}
+
+/*
+ * The jmapfile_close() function unmaps m; the records it gave go with it.
+ * Returns 0, or -1 with errno set on error.
+ */
+extern int jmapfile_close(jmapfile *m);
+
+/*
+ * ==========================================================================
+ */
+
+#endif /* __JSTDIO_H */
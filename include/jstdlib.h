@@ -0,0 +1,189 @@
+#if !defined(__JSTDLIB_H)
+# define __JSTDLIB_H
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stddef.h>
+
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *              1 .   N U M E R I C   C O N V E R S I O N
+ */
+/*
+ * 1. Numeric Conversion
+ *     strtol ✔️
+ *     strtoull ✔️
+ *     strtod ✔️
+ *     utoa ✔️
+ *     itoa ✔️
+ *     dtoa ✔️
+ */
+/*
+ * The strtol() function converts the initial part of the string in nptr to a
+ * long integer value according to the given base, which must be between 2
+ * and 36 inclusive, or be the special value 0.
+ *
+ * The string may begin with an arbitrary amount of white space followed by a
+ * single optional '+' or '-' sign. If base is zero or 16, the string may then
+ * include a "0x" or "0X" prefix, and the number will be read in base 16;
+ * otherwise, a zero base is taken as 10 (decimal) unless the next character
+ * is '0', in which case it is taken as 8 (octal).
+ *
+ * If endptr is not NULL, strtol() stores the address of the first invalid
+ * character in *endptr. If there were no digits at all, strtol() stores the
+ * original value of nptr in *endptr and returns 0.
+ *
+ * If the correct value would overflow, strtol() returns LONG_MAX or LONG_MIN
+ * and sets errno to ERANGE. A base outside the range sets errno to EINVAL.
+ */
+extern long jstrtol(const char *restrict nptr, char **restrict endptr,
+		    int base);
+
+/*
+ * The strtoull() function works just like strtol() but returns an unsigned
+ * long long. A leading '-' negates the result in unsigned arithmetic. If the
+ * magnitude doesn't fit, it returns ULLONG_MAX and sets errno to ERANGE.
+ */
+extern unsigned long long jstrtoull(const char *restrict nptr,
+				    char **restrict endptr, int base);
+
+/*
+ * The strtod() function converts the initial portion of the string pointed
+ * to by nptr to double, rounded to nearest, ties to even.
+ *
+ * The expected form is optional leading white space, an optional sign, and
+ * then either a nonempty sequence of decimal digits optionally containing a
+ * radix character, optionally followed by a decimal exponent ('e' or 'E', an
+ * optional sign and digits); a "0x" or "0X", then a nonempty sequence of
+ * hexadecimal digits optionally containing a radix character, optionally
+ * followed by a binary exponent ('p' or 'P'); "INF" or "INFINITY"; or "NAN",
+ * optionally followed by a parenthesized sequence of letters, digits and
+ * underscores. Case is ignored. The radix character is always '.'.
+ *
+ * If endptr is not NULL, a pointer to the character after the last one used
+ * in the conversion is stored there. If no conversion is performed, zero is
+ * returned and nptr is stored there.
+ *
+ * If the correct value would overflow, plus or minus HUGE_VAL is returned,
+ * and errno is set to ERANGE. If a nonzero value would come out as zero,
+ * zero is returned and errno is set to ERANGE. Subnormal results are
+ * returned without touching errno.
+ */
+extern double jstrtod(const char *restrict nptr, char **restrict endptr);
+
+/*
+ * Like the functions above, but they read at most n bytes from s, which
+ * needs no '\0' after them. Parsing stops at the first byte that can't
+ * continue the number or after n bytes, whichever comes first.
+ */
+extern long jstrntol(const char *s, size_t n, char **endptr, int base);
+extern unsigned long long jstrntoull(const char *s, size_t n, char **endptr,
+				     int base);
+extern double jstrntod(const char *s, size_t n, char **endptr);
+
+/* Buffer sizes for the functions below, the '\0' included */
+#define JITOA_MAX 21 /* "-9223372036854775808", "18446744073709551615" */
+#define JDTOA_MAX 26 /* "-0.0000012345678901234567" */
+
+/*
+ * The jutoa() and jitoa() functions write v in decimal, with a leading '-'
+ * if it is negative, and a terminating null byte to dst. They return a
+ * pointer to that null byte, like stpcpy(). Nothing is allocated and no
+ * locale is consulted; dst must have room for JITOA_MAX bytes.
+ */
+extern char *jutoa(char *dst, unsigned long long v);
+extern char *jitoa(char *dst, long long v);
+
+/*
+ * The jdtoa() function writes d to dst with the fewest digits that strtod()
+ * reads back as the same double, the one nearest to d when several are that
+ * short, and returns a pointer to the terminating null byte.
+ *
+ * Numbers from 1e-6 up to 1e21 are written plainly ("0.001", "123.5",
+ * "100"), others in exponential form ("1e+21", "2.5e-7"), as in JavaScript.
+ * Negative zero is "-0", the others are "inf", "-inf" and "nan". dst must
+ * have room for JDTOA_MAX bytes.
+ */
+extern char *jdtoa(char *dst, double d);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *          2 .   S O R T I N G   A N D   S E A R C H I N G
+ */
+/*
+ * 2. Sorting and Searching
+ *     qsort ✔️
+ *     qsort_r ✔️
+ *     bsearch ✔️
+ *     lower_bound ✔️
+ */
+/*
+ * The qsort() function sorts an array with nmemb elements of size size.
+ * The base argument points to the start of the array. The contents are
+ * sorted in ascending order according to a comparison function pointed to
+ * by compar, which is called with two arguments that point to the objects
+ * being compared. It must return an integer less than, equal to, or greater
+ * than zero if the first argument is considered to be respectively less
+ * than, equal to, or greater than the second. The sort is not stable.
+ *
+ * It is an introspective quicksort (pattern-defeating quicksort), O(n log n)
+ * in the worst case and linear on sorted, reversed and all equal input.
+ * Nothing is allocated.
+ */
+extern void jqsort(void *base, size_t nmemb, size_t size,
+		   int (*compar)(const void *, const void *));
+
+/*
+ * The qsort_r() function is identical to qsort() except that the comparison
+ * function takes a third argument, arg, passed through unchanged.
+ */
+extern void jqsort_r(void *base, size_t nmemb, size_t size,
+		     int (*compar)(const void *, const void *, void *),
+		     void *arg);
+
+/*
+ * The bsearch() function searches an array of nmemb objects, the initial
+ * member of which is pointed to by base, for a member that matches the
+ * object pointed to by key. The array must be sorted by compar, which is
+ * called with key first and returns how key compares to the member.
+ *
+ * It returns a pointer to the first matching member, or NULL if there is
+ * none.
+ */
+extern void *jbsearch(const void *key, const void *base, size_t nmemb,
+		      size_t size, int (*compar)(const void *, const void *));
+
+/*
+ * The jlower_bound() function is bsearch() for where key goes: it returns a
+ * pointer to the first member that doesn't compare less than key, one past
+ * the end of the array if every member does.
+ */
+extern void *jlower_bound(const void *key, const void *base, size_t nmemb,
+			  size_t size,
+			  int (*compar)(const void *, const void *));
+
+/*
+ * ==========================================================================
+ */
+
+#endif /* __JSTDLIB_H */
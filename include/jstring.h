@@ -16,7 +16,9 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 
 /*
@@ -60,6 +62,99 @@ extern void *jmemset(void *s, int c, size_t n);
  */
 extern int jmemcmp(const void *s1, const void *s2, size_t n);
 
+/*
+ * Calls with a small constant size, such as jmemcpy(&a, &b, sizeof(a)), are
+ * expanded right where they are into a few loads and stores. Any other call
+ * goes to the functions above. Define JSTR_NO_INLINE before including this
+ * header to always call them, and write (jmemcpy)(...) to call one anyway.
+ */
+#if !defined(JSTR_NO_INLINE)
+#define JSTR_INLINE_MAX 64 /* biggest size expanded inline */
+
+typedef uint16_t __jstr_u16 __attribute__((may_alias, aligned(1)));
+typedef uint32_t __jstr_u32 __attribute__((may_alias, aligned(1)));
+typedef uint64_t __jstr_u64 __attribute__((may_alias, aligned(1)));
+typedef unsigned char __jstr_v16
+	__attribute__((vector_size(16), may_alias, aligned(1)));
+
+#define __jstr_small(n) (__builtin_constant_p(n) && (n) <= JSTR_INLINE_MAX)
+
+/*
+ * Two loads that may overlap cover any size between one width and twice that,
+ * four cover up to 64. Everything is loaded before anything is stored, so it
+ * works for jmemmove() too. With `n` known, all but one branch fold away.
+ */
+static inline __attribute__((always_inline)) void *
+__jmemcpy_small(void *d, const void *s, size_t n)
+{
+	unsigned char *dd = (unsigned char *)d;
+	const unsigned char *ss = (const unsigned char *)s;
+
+	if (n > 32) {
+		__jstr_v16 a = *(const __jstr_v16 *)ss;
+		__jstr_v16 b = *(const __jstr_v16 *)(ss + 16);
+		__jstr_v16 c = *(const __jstr_v16 *)(ss + n - 32);
+		__jstr_v16 e = *(const __jstr_v16 *)(ss + n - 16);
+		*(__jstr_v16 *)dd = a;
+		*(__jstr_v16 *)(dd + 16) = b;
+		*(__jstr_v16 *)(dd + n - 32) = c;
+		*(__jstr_v16 *)(dd + n - 16) = e;
+	} else if (n > 16) {
+		__jstr_v16 a = *(const __jstr_v16 *)ss;
+		__jstr_v16 b = *(const __jstr_v16 *)(ss + n - 16);
+		*(__jstr_v16 *)dd = a;
+		*(__jstr_v16 *)(dd + n - 16) = b;
+	} else if (n > 8) {
+		uint64_t a = *(const __jstr_u64 *)ss;
+		uint64_t b = *(const __jstr_u64 *)(ss + n - 8);
+		*(__jstr_u64 *)dd = a;
+		*(__jstr_u64 *)(dd + n - 8) = b;
+	} else if (n >= 4) {
+		uint32_t a = *(const __jstr_u32 *)ss;
+		uint32_t b = *(const __jstr_u32 *)(ss + n - 4);
+		*(__jstr_u32 *)dd = a;
+		*(__jstr_u32 *)(dd + n - 4) = b;
+	} else if (n >= 2) {
+		uint16_t a = *(const __jstr_u16 *)ss;
+		uint16_t b = *(const __jstr_u16 *)(ss + n - 2);
+		*(__jstr_u16 *)dd = a;
+		*(__jstr_u16 *)(dd + n - 2) = b;
+	} else if (n == 1) {
+		*dd = *ss;
+	}
+	return d;
+}
+
+static inline __attribute__((always_inline)) void *
+__jmemset_small(void *d, int c, size_t n)
+{
+	unsigned char *dd = (unsigned char *)d;
+	uint64_t w = (unsigned char)c * 0x0101010101010101ULL;
+
+	if (n >= 8) {
+		for (size_t i = 0; i + 8 <= n; i += 8)
+			*(__jstr_u64 *)(dd + i) = w;
+		*(__jstr_u64 *)(dd + n - 8) = w;
+	} else if (n >= 4) {
+		*(__jstr_u32 *)dd = (uint32_t)w;
+		*(__jstr_u32 *)(dd + n - 4) = (uint32_t)w;
+	} else if (n >= 2) {
+		*(__jstr_u16 *)dd = (uint16_t)w;
+		*(__jstr_u16 *)(dd + n - 2) = (uint16_t)w;
+	} else if (n == 1) {
+		*dd = (unsigned char)c;
+	}
+	return d;
+}
+
+#define jmemcpy(d, s, n) \
+	(__jstr_small(n) ? __jmemcpy_small(d, s, n) : (jmemcpy)(d, s, n))
+#define jmemmove(d, s, n) \
+	(__jstr_small(n) ? __jmemcpy_small(d, s, n) : (jmemmove)(d, s, n))
+#define jmemset(d, c, n) \
+	(__jstr_small(n) ? __jmemset_small(d, c, n) : (jmemset)(d, c, n))
+#endif
+
 /*
  * ==========================================================================
  */
@@ -196,6 +291,372 @@ extern char *jstrndup(const char *s, size_t n);
 // extern char *jstrdupa(const char *s);
 // extern char *jstrdupa(size_t n; const char *s[n], size_t n);
 
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                 4 .   C O U N T E D   S T R I N G S
+ */
+/*
+ * 4. Counted Strings
+ *     jstr ✔️
+ */
+/*
+ * A string that knows its length, so asking for it is O(1) and appending
+ * doesn't rescan what's there. It may hold null bytes, and the byte after
+ * the last one is always '\0' so the contents can be passed as a C string.
+ *
+ * Up to JSTR_SSO bytes are stored inside the struct itself, longer strings
+ * go to a jmalloc() block. The last byte of the struct tells which: the
+ * length of a short string, or JSTR_LONG. A zeroed jstr is an empty string,
+ * so `jstr s = {0};` is all the setup it needs.
+ */
+#define JSTR_SSO (3 * sizeof(size_t) - 2) /* longest string kept inline */
+#define JSTR_LONG 0xff
+#define JSTR_NPOS ((size_t)-1) /* "not found" for the find functions */
+
+typedef struct jstr jstr;
+struct jstr {
+	union {
+		struct {
+			char *ptr;
+			size_t len;
+			/* the top byte is left for the tag */
+			size_t cap : sizeof(size_t) * 8 - 8;
+		} big;
+		/* the bytes, a '\0', then the tag */
+		unsigned char small[3 * sizeof(size_t)];
+	};
+};
+
+#define JSTR_TAG(s) ((s)->small[sizeof((s)->small) - 1])
+
+static inline size_t jstr_len(const jstr *s)
+{
+	return JSTR_TAG(s) == JSTR_LONG ? s->big.len : JSTR_TAG(s);
+}
+
+/*
+ * The contents as a C string, without copying. Valid until `s` is changed
+ * or freed.
+ */
+static inline const char *jstr_cstr(const jstr *s)
+{
+	return JSTR_TAG(s) == JSTR_LONG ? s->big.ptr : (const char *)s->small;
+}
+
+/*
+ * Bytes `s` can hold without allocating.
+ */
+extern size_t jstr_cap(const jstr *s);
+
+/*
+ * Makes room for at least `cap` bytes. The functions below that can grow a
+ * string return 0 on success and -1 with errno set to ENOMEM if they can't,
+ * leaving the string as it was.
+ */
+extern int jstr_reserve(jstr *s, size_t cap);
+
+/*
+ * Replaces the contents of `s` with the `n` bytes at `p`.
+ */
+extern int jstr_set(jstr *s, const char *p, size_t n);
+
+/*
+ * Appends the `n` bytes at `p`, which may point into `s` itself.
+ */
+extern int jstr_append(jstr *s, const char *p, size_t n);
+
+/*
+ * Inserts the `n` bytes at `p` before offset `pos`, which may be the length
+ * to append. Fails with EINVAL if `pos` is past the end.
+ */
+extern int jstr_insert(jstr *s, size_t pos, const char *p, size_t n);
+
+/*
+ * Cuts `s` down to the `n` bytes starting at `pos`, or to the end if fewer
+ * are left. Fails with EINVAL if `pos` is past the end, never allocates.
+ */
+extern int jstr_slice(jstr *s, size_t pos, size_t n);
+
+/*
+ * Compares the two strings byte by byte as unsigned char, a prefix comes
+ * first. Returns a negative, zero or positive value like memcmp().
+ */
+extern int jstr_cmp(const jstr *a, const jstr *b);
+
+/*
+ * Returns the offset of the first occurrence of the `n` bytes at `p` in `s`
+ * at or after `from`, or JSTR_NPOS if there is none.
+ */
+extern size_t jstr_find(const jstr *s, const char *p, size_t n, size_t from);
+
+/*
+ * Releases the memory of `s`, which is left an empty string.
+ */
+extern void jstr_free(jstr *s);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                  5 .   S T R I N G   B U I L D E R
+ */
+/*
+ * 5. String Builder
+ *     jsb ✔️
+ */
+/*
+ * Builds a string out of many pieces, where jstrcat() would rescan all of
+ * it for each one. The bytes go to a buffer that grows geometrically, so
+ * appending is amortized O(1). A zeroed jsb is empty and ready to use.
+ *
+ * Large buffers the caller owns can be added by reference with jsb_ref().
+ * They are not copied, jsb_iov() lists them between the builder's own bytes
+ * for writev(). The buffer given by jsb_take() is handed over as is unless
+ * there are references to copy in.
+ */
+struct iovec;
+
+typedef struct jsb jsb;
+struct jsb {
+	char *buf; /* the bytes appended so far */
+	size_t len;
+	size_t cap;
+	struct jsb_ref *refs; /* by reference, in order */
+	size_t nrefs;
+	size_t refcap;
+	size_t reflen; /* bytes in refs */
+};
+
+/*
+ * Makes room for `n` more bytes. This and the append functions below return
+ * 0 on success and -1 with errno set to ENOMEM if they can't grow the
+ * builder, which keeps what it had.
+ */
+extern int jsb_reserve(jsb *sb, size_t n);
+
+/*
+ * Append `n` bytes at `p`, the string `s`, the byte `c`, or the decimal form
+ * of `v`.
+ */
+extern int jsb_append(jsb *sb, const void *p, size_t n);
+extern int jsb_puts(jsb *sb, const char *s);
+extern int jsb_putc(jsb *sb, int c);
+extern int jsb_int(jsb *sb, long long v);
+extern int jsb_uint(jsb *sb, unsigned long long v);
+
+/*
+ * Appends the output of vsnprintf(fmt, ...). Also fails with EINVAL or
+ * EOVERFLOW when vsnprintf() does.
+ */
+extern int jsb_printf(jsb *sb, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+/*
+ * Appends the `n` bytes at `p` without copying them. They must stay valid
+ * and unchanged until the builder is done with them.
+ */
+extern int jsb_ref(jsb *sb, const void *p, size_t n);
+
+/*
+ * Returns the length of the whole string, referenced bytes included.
+ */
+extern size_t jsb_len(const jsb *sb);
+
+/*
+ * Describes the string as `iovcnt` pieces for writev(), filling in at most
+ * `max` entries of `iov`. Returns how many are needed, so a call with `max`
+ * 0 tells how big `iov` has to be. The pieces are valid until the builder
+ * is changed.
+ */
+extern int jsb_iov(const jsb *sb, struct iovec *iov, int max);
+
+/*
+ * Hands the string over as a '\0' terminated jmalloc() block, and its length
+ * through `len` if not NULL. The builder is left empty. Returns NULL with
+ * errno set to ENOMEM if the block can't be made.
+ */
+extern char *jsb_take(jsb *sb, size_t *len);
+
+/*
+ * Empties the builder but keeps its memory for the next string.
+ */
+extern void jsb_clear(jsb *sb);
+
+/*
+ * Releases the memory of the builder, which is left empty.
+ */
+extern void jsb_free(jsb *sb);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                 6 .   S T R I N G   I N T E R N I N G
+ */
+/*
+ * 6. String Interning
+ *     jintern ✔️
+ */
+/*
+ * Maps strings to canonical copies, so two strings interned in the same
+ * table are equal if and only if the pointers are. The copies live as long
+ * as the table, in memory of its own that jintern_destroy() releases at once.
+ *
+ * A table made with JINTERN_SHARED can be used from any number of threads,
+ * lookups of strings already in it run in parallel. Without it the table
+ * takes no locks and belongs to one thread at a time.
+ */
+#define JINTERN_SHARED 1
+
+typedef struct jintern jintern_t;
+
+/*
+ * Creates an empty table. Returns NULL with errno set to ENOMEM if out of
+ * memory, or EINVAL if `flags` is unknown.
+ */
+extern jintern_t *jintern_create(int flags);
+
+/*
+ * Returns the canonical copy of the `n` bytes at `s`, adding it if it's new.
+ * The copy is '\0' terminated, and may hold null bytes itself. Returns NULL
+ * with errno set to ENOMEM if it can't be added.
+ */
+extern const char *jintern(jintern_t *t, const char *s, size_t n);
+extern const char *jintern_cstr(jintern_t *t, const char *s);
+
+/*
+ * Like jintern(), but returns NULL instead of adding the string.
+ */
+extern const char *jintern_lookup(jintern_t *t, const char *s, size_t n);
+
+/*
+ * Returns the length of `s`, which came from jintern(), in O(1).
+ */
+extern size_t jintern_len(const char *s);
+
+/*
+ * Returns the number of distinct strings in the table.
+ */
+extern size_t jintern_count(jintern_t *t);
+
+/*
+ * Releases the table and every string in it.
+ */
+extern void jintern_destroy(jintern_t *t);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                     7 .   C A S E   F O L D I N G
+ */
+/*
+ * 7. Case Folding (ASCII only)
+ *     strcasecmp ✔️
+ *     strncasecmp ✔️
+ *     memcasecmp ✔️
+ *     strtolower ✔️
+ *     strtoupper ✔️
+ *     memtolower ✔️
+ *     memtoupper ✔️
+ */
+/* Only 'A' to 'Z' and 'a' to 'z' are folded, whatever the locale. Bytes
+ * above 0x7f are compared as they are. */
+/*
+ * The strcasecmp() function performs a byte-by-byte comparison of the strings
+ * s1 and s2, ignoring the case of the characters. It returns an integer less
+ * than, equal to, or greater than zero if s1 is found, respectively, to be
+ * less than, to match, or be greater than s2.
+ *
+ * The strncasecmp() function is similar, except that it compares no more
+ * than n bytes of s1 and s2.
+ */
+extern int jstrcasecmp(const char *s1, const char *s2);
+extern int jstrncasecmp(const char *s1, const char *s2, size_t n);
+
+/*
+ * Like memcmp(), but ignoring case. Null bytes are compared like any other.
+ */
+extern int jmemcasecmp(const void *s1, const void *s2, size_t n);
+
+/*
+ * Convert the string s to lower or upper case in place. Return s.
+ */
+extern char *jstrtolower(char *s);
+extern char *jstrtoupper(char *s);
+
+/*
+ * Copy n bytes from src to dest converted to lower or upper case. dest may be
+ * src itself, but they must not overlap otherwise. Return dest.
+ */
+extern void *jmemtolower(void *dest, const void *src, size_t n);
+extern void *jmemtoupper(void *dest, const void *src, size_t n);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                            8 .   U T F - 8
+ */
+/*
+ * 8. UTF-8
+ *     utf8_validate ✔️
+ *     utf8_count ✔️
+ *     utf8_find_invalid ✔️
+ */
+/* Everywhere else in this header a character is a byte. These take the
+ * bytes as UTF-8 as RFC 3629 has it: no overlong forms, no surrogates and
+ * nothing past U+10FFFF. */
+/*
+ * Return whether the n bytes at s are valid UTF-8. The empty string is.
+ */
+extern bool jutf8_validate(const void *s, size_t n);
+
+/*
+ * Return the offset of the first sequence in the n bytes at s that isn't
+ * valid UTF-8, or of the first byte of a sequence the input ends in the
+ * middle of. JSTR_NPOS if all of it is valid.
+ */
+extern size_t jutf8_find_invalid(const void *s, size_t n);
+
+/*
+ * Return the number of code points in the n bytes at s, which is the number
+ * of bytes that aren't continuation bytes. Invalid input isn't checked for;
+ * each of its other bytes is counted as a code point.
+ */
+extern size_t jutf8_count(const void *s, size_t n);
+
+/*
+ * ==========================================================================
+ */
+
+/*
+ *                         9 .   S O R T I N G
+ */
+/*
+ * 9. Sorting
+ *     strsort ✔️
+ */
+/*
+ * Sort the n strings pointed to by v into the order jstrcmp() gives them,
+ * bytes compared as unsigned char. It is a radix-style sort that looks at
+ * each character about once, where qsort() with a string comparator goes
+ * back over the common prefixes on every comparison, so it pays off most on
+ * many keys that share long prefixes, like URLs and paths. Equal strings
+ * end up next to each other in no particular order.
+ *
+ * It takes 16 bytes of scratch per string from jmalloc(); if that can't be
+ * had it sorts with jqsort() instead.
+ */
+extern void jstrsort(char **v, size_t n);
+
 /*
  * ==========================================================================
  */
@@ -17,6 +17,8 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
 #include "jmm.h"
+#include "jstdio.h"
+#include "jstdlib.h"
 #include "jstring.h"
 
 #endif /* __JSTDLIB__ */
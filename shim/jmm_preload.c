@@ -0,0 +1,128 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * Exports the libc allocation functions on top of jmm, so that it can replace
+ * malloc in an existing binary:
+ *
+ *     LD_PRELOAD=./libjmm.so ./server
+ *
+ * Nothing here may allocate, use TLS, or call into the dynamic linker, since
+ * malloc is called long before the process is fully set up.
+ */
+
+#include "jmm.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define JMM_EXPORT __attribute__((visibility("default")))
+
+/*
+ * Runs before main() but after libc is up, pthread_atfork() itself may
+ * allocate, which is fine here since no lock is held yet.
+ */
+__attribute__((constructor)) static void jmm_preload_init(void)
+{
+	pthread_atfork(jmm_fork_prepare, jmm_fork_parent, jmm_fork_child);
+}
+
+/* glibc hands out a unique pointer for 0 bytes and callers rely on it */
+JMM_EXPORT void *malloc(size_t size)
+{
+	void *p = jmalloc(size ? size : 1);
+	if (!p)
+		errno = ENOMEM;
+	return p;
+}
+
+JMM_EXPORT void free(void *p)
+{
+	jfree(p);
+}
+
+JMM_EXPORT void *calloc(size_t nmemb, size_t size)
+{
+	void *p = jcalloc(nmemb, size);
+	if (!p && nmemb && size)
+		errno = ENOMEM;
+	else if (!p)
+		p = jcalloc(1, 1);
+	return p;
+}
+
+JMM_EXPORT void *realloc(void *p, size_t size)
+{
+	void *n = jrealloc(p, size);
+	if (!n && size)
+		errno = ENOMEM;
+	return n;
+}
+
+/* glibc's own would call its internal realloc on a jmm block */
+JMM_EXPORT void *reallocarray(void *p, size_t nmemb, size_t size)
+{
+	void *n = jreallocarray(p, nmemb, size);
+	if (!n && nmemb && size)
+		errno = ENOMEM;
+	return n;
+}
+
+JMM_EXPORT void *aligned_alloc(size_t alignment, size_t size)
+{
+	void *p;
+
+	if (alignment == 0 || (alignment & (alignment - 1))) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (!(p = jaligned_alloc(alignment, size ? size : 1)))
+		errno = ENOMEM;
+	return p;
+}
+
+JMM_EXPORT void *memalign(size_t alignment, size_t size)
+{
+	return aligned_alloc(alignment, size);
+}
+
+JMM_EXPORT int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+	void *p;
+
+	if (alignment < sizeof(void *) || (alignment & (alignment - 1)))
+		return EINVAL;
+	if (!(p = jaligned_alloc(alignment, size ? size : 1)))
+		return ENOMEM;
+	*memptr = p;
+	return 0;
+}
+
+JMM_EXPORT void *valloc(size_t size)
+{
+	return aligned_alloc(4096, size);
+}
+
+JMM_EXPORT void *pvalloc(size_t size)
+{
+	return aligned_alloc(4096, (size + 4095) & ~(size_t)4095);
+}
+
+JMM_EXPORT size_t malloc_usable_size(void *p)
+{
+	return jmalloc_usable_size(p);
+}
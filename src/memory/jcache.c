@@ -0,0 +1,336 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jmm.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#if defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>) && __has_include(<linux/membarrier.h>)
+#include <sys/rseq.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define JCACHE_RSEQ
+#endif
+#endif
+
+/*
+ * One stack of free blocks per size class. Class `c` holds blocks whose
+ * total size, header included, is (c + 2) * sizeof(header).
+ */
+struct jcache {
+	uint32_t top[JCACHE_CLASSES];
+	header *slot[JCACHE_CLASSES][JCACHE_DEPTH];
+};
+
+bool jcache_active;
+
+/*
+ * sysconf() may allocate, so room is reserved for JCACHE_CPUS slabs up front.
+ * Only the slabs of CPUs that run jmm ever get paged in.
+ */
+#define JCACHE_CPUS 1024
+
+static struct jcache *percpu;
+static bool use_rseq;
+
+/* fallback, the cache is mmap()ed too so jmm never allocates for itself */
+static __thread struct jcache *tcache __attribute__((tls_model("initial-exec")));
+static __thread bool exiting __attribute__((tls_model("initial-exec")));
+static pthread_key_t key;
+static bool have_key;
+
+static struct jcache *mapcache(size_t n)
+{
+	void *p = mmap(NULL, n * sizeof(struct jcache), PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return p == MAP_FAILED ? NULL : p;
+}
+
+#if defined(JCACHE_RSEQ)
+static struct rseq *rseq_area(void)
+{
+	char *tp;
+
+	__asm__("movq %%fs:0, %0" : "=r"(tp));
+	return (struct rseq *)(tp + __rseq_offset);
+}
+
+/*
+ * The two critical sections below run on the slab of whatever CPU the thread
+ * is on. The kernel restarts them at the abort label if the thread is
+ * preempted, migrated or signalled before the single store that commits, so
+ * no other thread can ever see a half done push or pop. Each one checks
+ * use_rseq inside, so once it's cleared and drain_percpu() has restarted
+ * the sections in flight, none of them touches a slab again.
+ *
+ * The descriptor goes in __rseq_cs, the abort handler in __rseq_failure after
+ * the signature the kernel checks for.
+ */
+static header *rseq_pop(uint64_t cls)
+{
+	struct rseq *abi = rseq_area();
+	header *ret;
+
+retry:
+	__asm__ goto(".pushsection __rseq_cs, \"aw\"\n\t"
+		     ".balign 32\n\t"
+		     "3:\n\t"
+		     ".long 0, 0\n\t"
+		     ".quad 1f, 2f - 1f, 4f\n\t"
+		     ".popsection\n\t"
+		     "leaq 3b(%%rip), %%rax\n\t"
+		     "movq %%rax, %c[cs](%[abi])\n\t"
+		     "1:\n\t"
+		     "cmpb $0, %[on]\n\t"
+		     "je %l[off]\n\t"
+		     "movl %c[cpu](%[abi]), %%eax\n\t"
+		     "imulq %[stride], %%rax, %%rax\n\t"
+		     "addq %[base], %%rax\n\t"
+		     "movl (%%rax, %[cls], 4), %%ecx\n\t"
+		     "testl %%ecx, %%ecx\n\t"
+		     "jz %l[empty]\n\t"
+		     "subl $1, %%ecx\n\t"
+		     "leaq (%[row], %%rcx), %%rdx\n\t"
+		     "movq %c[slot](%%rax, %%rdx, 8), %%rdx\n\t"
+		     "movq %%rdx, (%[out])\n\t"
+		     "movl %%ecx, (%%rax, %[cls], 4)\n\t"
+		     "2:\n\t"
+		     ".pushsection __rseq_failure, \"ax\"\n\t"
+		     ".byte 0x0f, 0xb9, 0x3d\n\t"
+		     ".long %c[sig]\n\t"
+		     "4:\n\t"
+		     "jmp %l[abort]\n\t"
+		     ".popsection\n\t"
+		     :
+		     : [abi] "r"(abi), [base] "r"(percpu), [cls] "r"(cls),
+		       [row] "r"(cls * JCACHE_DEPTH), [out] "r"(&ret),
+		       [on] "m"(use_rseq),
+		       [cs] "i"(offsetof(struct rseq, rseq_cs)),
+		       [cpu] "i"(offsetof(struct rseq, cpu_id)),
+		       [stride] "i"(sizeof(struct jcache)),
+		       [slot] "i"(offsetof(struct jcache, slot)),
+		       [sig] "i"(RSEQ_SIG)
+		     : "rax", "rcx", "rdx", "memory", "cc"
+		     : empty, abort, off);
+	return ret;
+abort:
+	goto retry;
+empty:
+off:
+	return NULL;
+}
+
+static bool rseq_push(uint64_t cls, header *h)
+{
+	struct rseq *abi = rseq_area();
+
+retry:
+	__asm__ goto(".pushsection __rseq_cs, \"aw\"\n\t"
+		     ".balign 32\n\t"
+		     "3:\n\t"
+		     ".long 0, 0\n\t"
+		     ".quad 1f, 2f - 1f, 4f\n\t"
+		     ".popsection\n\t"
+		     "leaq 3b(%%rip), %%rax\n\t"
+		     "movq %%rax, %c[cs](%[abi])\n\t"
+		     "1:\n\t"
+		     "cmpb $0, %[on]\n\t"
+		     "je %l[off]\n\t"
+		     "movl %c[cpu](%[abi]), %%eax\n\t"
+		     "imulq %[stride], %%rax, %%rax\n\t"
+		     "addq %[base], %%rax\n\t"
+		     "movl (%%rax, %[cls], 4), %%ecx\n\t"
+		     "cmpl %[depth], %%ecx\n\t"
+		     "jae %l[full]\n\t"
+		     "leaq (%[row], %%rcx), %%rdx\n\t"
+		     "movq %[h], %c[slot](%%rax, %%rdx, 8)\n\t"
+		     "addl $1, %%ecx\n\t"
+		     "movl %%ecx, (%%rax, %[cls], 4)\n\t"
+		     "2:\n\t"
+		     ".pushsection __rseq_failure, \"ax\"\n\t"
+		     ".byte 0x0f, 0xb9, 0x3d\n\t"
+		     ".long %c[sig]\n\t"
+		     "4:\n\t"
+		     "jmp %l[abort]\n\t"
+		     ".popsection\n\t"
+		     :
+		     : [abi] "r"(abi), [base] "r"(percpu), [cls] "r"(cls),
+		       [row] "r"(cls * JCACHE_DEPTH), [h] "r"(h),
+		       [on] "m"(use_rseq),
+		       [depth] "i"(JCACHE_DEPTH),
+		       [cs] "i"(offsetof(struct rseq, rseq_cs)),
+		       [cpu] "i"(offsetof(struct rseq, cpu_id)),
+		       [stride] "i"(sizeof(struct jcache)),
+		       [slot] "i"(offsetof(struct jcache, slot)),
+		       [sig] "i"(RSEQ_SIG)
+		     : "rax", "rcx", "rdx", "memory", "cc"
+		     : full, abort, off);
+	return true;
+abort:
+	goto retry;
+full:
+off:
+	return false;
+}
+
+/*
+ * glibc registered rseq for this thread, the CPU ids fit the slabs, and
+ * the kernel can fence the critical sections so the slabs can be drained
+ */
+static bool rseq_usable(void)
+{
+	static int fence; /* 1 registered, -1 not available */
+	uint32_t cpu;
+
+	if (__rseq_size == 0)
+		return false;
+	cpu = rseq_area()->cpu_id;
+	if ((int32_t)cpu < 0 || cpu >= JCACHE_CPUS)
+		return false;
+	if (!fence)
+		fence = syscall(__NR_membarrier,
+				MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED_RSEQ, 0,
+				0) == 0 ? 1 : -1;
+	return fence > 0;
+}
+#endif
+
+/* gives every block in c back to the heap */
+static void empty(struct jcache *c, void (*reclaim)(void *))
+{
+	for (int i = 0; i < JCACHE_CLASSES; i++) {
+		while (c->top[i])
+			reclaim(c->slot[i][--c->top[i]] + 1);
+	}
+}
+
+#if defined(JCACHE_RSEQ)
+/*
+ * Called with use_rseq just cleared and the heap lock held. The fence
+ * restarts every critical section running on another CPU, and a restarted
+ * or preempted one sees use_rseq off before it can commit, so the slabs
+ * are left to this thread. Without the fence they're left as they are.
+ */
+static void drain_percpu(void)
+{
+	if (syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ, 0,
+		    0) != 0)
+		return;
+	for (int cpu = 0; cpu < JCACHE_CPUS; cpu++)
+		empty(&percpu[cpu], jmm_reclaim_locked);
+}
+#endif
+
+/* hands a dying thread's blocks back to the heap */
+static void flush(void *arg)
+{
+	struct jcache *c = arg;
+
+	exiting = true;
+	tcache = NULL;
+	empty(c, jmm_reclaim);
+	munmap(c, sizeof(*c));
+}
+
+static struct jcache *mine(void)
+{
+	if (tcache || exiting || !have_key)
+		return tcache;
+	if ((tcache = mapcache(1)) == NULL)
+		return NULL;
+	pthread_setspecific(key, tcache);
+	return tcache;
+}
+
+__attribute__((constructor)) static void jcache_ctor(void)
+{
+	have_key = pthread_key_create(&key, flush) == 0;
+}
+
+int jcache_setup(int m)
+{
+	if (m < 0 || m > 2)
+		return 0;
+#if defined(JCACHE_RSEQ)
+	if (use_rseq && m != 1) {
+		use_rseq = false;
+		drain_percpu();
+	}
+	if (m == 1 && !use_rseq) {
+		if (!percpu)
+			percpu = mapcache(JCACHE_CPUS);
+		use_rseq = percpu && rseq_usable();
+	}
+#endif
+	/* other threads' stacks go back when they exit */
+	if (m == 0 && tcache)
+		empty(tcache, jmm_reclaim_locked);
+	jcache_active = m != 0;
+	return 1;
+}
+
+static int class_of(size_t total)
+{
+	if (total < 2 * sizeof(header) || total > JCACHE_MAX ||
+	    total % sizeof(header))
+		return -1;
+	return (int)(total / sizeof(header)) - 2;
+}
+
+void *jcache_pop(size_t size)
+{
+	struct jcache *c;
+	header *h;
+	int cls;
+
+	if (size == 0 || size > JCACHE_MAX)
+		return NULL;
+	cls = class_of((size + sizeof(header) * 2 - 1) & ~(sizeof(header) - 1));
+	if (cls < 0)
+		return NULL;
+#if defined(JCACHE_RSEQ)
+	if (use_rseq) {
+		h = rseq_pop((uint64_t)cls);
+		return h ? h + 1 : NULL;
+	}
+#endif
+	if ((c = mine()) == NULL || !c->top[cls])
+		return NULL;
+	h = c->slot[cls][--c->top[cls]];
+	return h + 1;
+}
+
+bool jcache_push(void *p)
+{
+	header *h = (header *)p - 1;
+	struct jcache *c;
+	int cls;
+
+	if (h->is_mmap || h->is_sampled || (cls = class_of(h->size)) < 0)
+		return false;
+#if defined(JCACHE_RSEQ)
+	if (use_rseq)
+		return rseq_push((uint64_t)cls, h);
+#endif
+	if ((c = mine()) == NULL || c->top[cls] == JCACHE_DEPTH)
+		return false;
+	c->slot[cls][c->top[cls]++] = h;
+	return true;
+}
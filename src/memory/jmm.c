@@ -14,6 +14,7 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
+#define _GNU_SOURCE /* mremap() */
 #include "jmm.h"
 #include "jstring.h"
 #include <sys/mman.h>
@@ -21,7 +22,14 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 #include <stdint.h>
 #include <stdbool.h>
 #include <sys/types.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <errno.h>
 #include <unistd.h>
+#if defined(JMM_HARDENED)
+#include <sys/auxv.h>
+#endif
 #if defined(DEBUG_JMALLOC) || defined(DEBUG_JFREE) || defined(DEBUG_JREALLOC)
 #include <stdio.h>
 #endif
@@ -31,47 +39,761 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 #define JMM_ALIGN(x) (x + (sizeof(header) - 1)) & ~(sizeof(header) - 1)
 #endif
 
-/* head of the linked list */
-header *head;
+#if !defined(JMM_PAGE)
+#define JMM_PAGE(x) (((x) + (pagesz() - 1)) & ~(pagesz() - 1))
+#endif
+
+/* a mapped block is on no list, its prev holds the start of the mapping */
+#define MAPBASE(h) ((void *)(h)->prev)
 
 /*
- * The only place where sbrk() is actually called.
+ * Segregated free lists, TLSF style. A free block of size s lives in bin
+ * [fl][sl], where fl is the index of the highest bit of s and sl the next
+ * JMM_SL_LOG bits below it. flmap has bit fl set if any bin in row fl is
+ * non-empty, slmap[fl] does the same for the bins of that row, so finding a
+ * good fit is two bit scans and no list walk.
  */
-header *upbrk(size_t size)
+#define JMM_FL 64
+#define JMM_SL_LOG 5
+#define JMM_SL (1 << JMM_SL_LOG)
+#define JMM_BIN_PEEK 8 /* blocks of the exact bin looked at for a best fit */
+/* smaller free blocks can't hold the links, nor fit any request */
+#define JMM_MIN_FREE (2 * sizeof(header))
+
+struct flink {
+	header *prev; /* the prev block in the same bin */
+	header *next; /* the next block in the same bin */
+};
+#define FLINK(h) ((struct flink *)((h) + 1))
+
+/*
+ * Every mapping of a heap other than the default one starts with one of
+ * these, so jheap_destroy() can find them all.
+ */
+struct chunk {
+	struct chunk *prev;
+	struct chunk *next;
+	size_t len; /* of the whole mapping */
+	size_t pad; /* keeps the block after it aligned */
+};
+
+/*
+ * A heap is a list of blocks, the bins indexing its free ones and a lock.
+ * jmalloc() and friends use the default heap, which grows with sbrk(). Any
+ * other heap grows in mmap()ed chunks that are never shared with another one.
+ */
+struct jheap {
+	/*
+	 * A bare atomic flag, so it works before pthreads or TLS are set up,
+	 * which matters when jmm replaces malloc.
+	 */
+	atomic_flag lock;
+	/*
+	 * Blocks freed while another thread held the lock, linked through their
+	 * payload. Any number of threads push, only the lock holder pops.
+	 */
+	_Atomic(header *) remote;
+	header *head; /* head and tail of the linked list */
+	header *tail;
+	header *bins[JMM_FL][JMM_SL];
+	uint64_t flmap;
+	uint32_t slmap[JMM_FL];
+	size_t last; /* size of the last chunk */
+	struct chunk *chunks; /* NULL for the default heap */
+	uint16_t id; /* index in heaps[] */
+};
+
+static struct jheap main_heap = { .lock = ATOMIC_FLAG_INIT };
+
+/* live heaps by id, only changed with the default heap's lock held */
+static struct jheap *heaps[JHEAP_MAX] = { &main_heap };
+
+#define HEAP_OF(h) (heaps[(h)->heap])
+
+static void heap_lock(struct jheap *hp)
+{
+	for (int spins = 0;
+	     atomic_flag_test_and_set_explicit(&hp->lock, memory_order_acquire);
+	     spins++) {
+		if (spins >= 64)
+			sched_yield();
+	}
+}
+
+static void heap_unlock(struct jheap *hp)
+{
+	atomic_flag_clear_explicit(&hp->lock, memory_order_release);
+}
+
+static bool heap_trylock(struct jheap *hp)
+{
+	return !atomic_flag_test_and_set_explicit(&hp->lock,
+						  memory_order_acquire);
+}
+
+void jmm_lock(void)
+{
+	heap_lock(&main_heap);
+}
+
+void jmm_unlock(void)
+{
+	heap_unlock(&main_heap);
+}
+
+/*
+ * pthread_atfork() handlers, the child gets the heaps in a consistent state
+ * and doesn't write the parent's trace records a second time.
+ */
+void jmm_fork_prepare(void)
+{
+	jmm_lock();
+	for (int i = 1; i < JHEAP_MAX; i++) {
+		if (heaps[i])
+			heap_lock(heaps[i]);
+	}
+}
+
+static void fork_unlock(void)
+{
+	for (int i = JHEAP_MAX - 1; i > 0; i--) {
+		if (heaps[i])
+			heap_unlock(heaps[i]);
+	}
+	jmm_unlock();
+}
+
+void jmm_fork_parent(void)
+{
+	fork_unlock();
+}
+
+void jmm_fork_child(void)
+{
+	jtrace_drop();
+	fork_unlock();
+}
+
+/* stdio may allocate, and the heap is in no state for that */
+__attribute__((noreturn)) static void jmm_panic(const char *what)
+{
+	write(STDERR_FILENO, "jmm: ", 5);
+	write(STDERR_FILENO, what, jstrlen(what));
+	write(STDERR_FILENO, "\n", 1);
+	abort();
+}
+
+#if defined(JMM_SAFE_LINK)
+/*
+ * Safe-linking, as in glibc: a link kept in a free block's payload is stored
+ * xored with its own address shifted past the page offset. A stale pointer
+ * write can't aim it somewhere useful without knowing where the heap is, and
+ * most garbage doesn't decode to an aligned pointer.
+ */
+#define PROTECT(pos, v) ((header *)(((uintptr_t)(pos) >> 12) ^ (uintptr_t)(v)))
+
+static header *reveal(header *const *pos)
+{
+	header *v = PROTECT(pos, *pos);
+
+	if ((uintptr_t)v % alignof(header))
+		jmm_panic("corrupted free list");
+	return v;
+}
+#else
+#define PROTECT(pos, v) (v)
+#define reveal(pos) (*(pos))
+#endif
+#define LPREV(h) reveal(&FLINK(h)->prev)
+#define LNEXT(h) reveal(&FLINK(h)->next)
+#define SET_LPREV(h, v) (FLINK(h)->prev = PROTECT(&FLINK(h)->prev, (v)))
+#define SET_LNEXT(h, v) (FLINK(h)->next = PROTECT(&FLINK(h)->next, (v)))
+
+static size_t pagesz(void)
 {
+	static size_t page;
+	if (!page)
+		page = (size_t)sysconf(_SC_PAGESIZE);
+	return page;
+}
+
+static void mapping(size_t size, unsigned *fl, unsigned *sl)
+{
+	*fl = 63 - __builtin_clzll(size);
+	*sl = (size >> (*fl - JMM_SL_LOG)) & (JMM_SL - 1);
+}
+
+static void bin_insert(struct jheap *hp, header *h)
+{
+	unsigned fl, sl;
+
+	if (h->size < JMM_MIN_FREE)
+		return;
+	mapping(h->size, &fl, &sl);
+	SET_LPREV(h, NULL);
+	SET_LNEXT(h, hp->bins[fl][sl]);
+	if (hp->bins[fl][sl])
+		SET_LPREV(hp->bins[fl][sl], h);
+	hp->bins[fl][sl] = h;
+	hp->flmap |= 1ULL << fl;
+	hp->slmap[fl] |= 1U << sl;
+}
+
+static void bin_remove(struct jheap *hp, header *h)
+{
+	unsigned fl, sl;
+	header *prev;
+	header *next;
+
+	if (h->size < JMM_MIN_FREE)
+		return;
+	mapping(h->size, &fl, &sl);
+	prev = LPREV(h);
+	next = LNEXT(h);
+	if (prev)
+		SET_LNEXT(prev, next);
+	else
+		hp->bins[fl][sl] = next;
+	if (next)
+		SET_LPREV(next, prev);
+	if (!hp->bins[fl][sl]) {
+		hp->slmap[fl] &= ~(1U << sl);
+		if (!hp->slmap[fl])
+			hp->flmap &= ~(1ULL << fl);
+	}
+}
+
+/*
+ * Returns a free block of at least `size` bytes, or NULL. Failing a close fit
+ * in the exact bin, the size is rounded up to the next bin boundary, so any
+ * block in the bin that's found fits.
+ */
+static header *bin_search(struct jheap *hp, size_t size)
+{
+	unsigned fl, sl;
+	uint64_t map;
 	header *p;
-	size_t aligned;
-	if (size <= BLOCK_LIT) {
-		if ((p = sbrk(BLOCK_LIT)) != (void *)-1)
-			p->size = BLOCK_LIT;
-		else
-			p = NULL;
-	} else if (BLOCK_LIT < size && size <= BLOCK_MID) {
-		if ((p = sbrk(BLOCK_MID)) != (void *)-1)
-			p->size = BLOCK_MID;
-		else
-			p = NULL;
-	} else if (BLOCK_MID < size && size <= BLOCK_BIG) {
-		if ((p = sbrk(BLOCK_BIG)) != (void *)-1)
-			p->size = BLOCK_BIG;
-		else
-			p = NULL;
-	} else {
-		aligned = (size / sizeof(header) + 1) * sizeof(header);
-		if ((p = sbrk(aligned)) != (void *)-1)
-			p->size = aligned;
+	header *best;
+
+	/*
+	 * the exact bin may hold a closer fit than the rounded up one, look at
+	 * a few of its blocks and take the smallest that fits
+	 */
+	mapping(size, &fl, &sl);
+	best = NULL;
+	p = hp->bins[fl][sl];
+	for (int i = 0; p && i < JMM_BIN_PEEK; i++, p = LNEXT(p)) {
+		if (p->size < size)
+			continue;
+		if (!best || p->size < best->size ||
+		    (p->size == best->size && p < best))
+			best = p;
+	}
+	if (best)
+		return best;
+
+	size += (1ULL << (fl - JMM_SL_LOG)) - 1;
+	mapping(size, &fl, &sl);
+	map = hp->slmap[fl] & (~0U << sl);
+	if (!map) {
+		if (fl + 1 >= JMM_FL)
+			return NULL;
+		map = hp->flmap & (~0ULL << (fl + 1));
+		if (!map)
+			return NULL;
+		fl = __builtin_ctzll(map);
+		map = hp->slmap[fl];
+	}
+	sl = __builtin_ctz(map);
+
+	/* all of these fit, prefer low addresses to keep the heap compact */
+	best = hp->bins[fl][sl];
+	p = LNEXT(best);
+	for (int i = 1; p && i < JMM_BIN_PEEK; i++, p = LNEXT(p)) {
+		if (p < best)
+			best = p;
+	}
+	return best;
+}
+
+/*
+ * sbrk() chunks are only contiguous if nobody else moved the break in
+ * between, so neighbours on the list aren't necessarily neighbours in memory.
+ */
+static bool adjacent(header *a, header *b)
+{
+	return b && (void *)a + a->size == (void *)b;
+}
+
+/* puts `n` right after `a` on the linked list */
+static void link_after(struct jheap *hp, header *a, header *n)
+{
+	n->prev = a;
+	n->next = a->next;
+	a->next = n;
+	if (n->next)
+		n->next->prev = n;
+	else
+		hp->tail = n;
+}
+
+/* takes `n` off the linked list */
+static void unlink_block(struct jheap *hp, header *n)
+{
+	if (n->prev)
+		n->prev->next = n->next;
+	else
+		hp->head = n->next;
+	if (n->next)
+		n->next->prev = n->prev;
+	else
+		hp->tail = n->prev;
+}
+
+/*
+ * Merges the free block `b`, which is on no bin, with its free neighbours.
+ * Returns the merged block, which isn't on a bin either.
+ */
+static header *coalesce(struct jheap *hp, header *b)
+{
+	header *next = b->next;
+	header *prev = b->prev;
+
+	/* there is a free block after b */
+	if (next && next->is_free && adjacent(b, next)) {
+		bin_remove(hp, next);
+		b->size += next->size;
+		unlink_block(hp, next);
+	}
+
+	/* there is a free block before b */
+	if (prev && prev->is_free && adjacent(prev, b)) {
+		bin_remove(hp, prev);
+		prev->size += b->size;
+		unlink_block(hp, b);
+		b = prev;
+	}
+	return b;
+}
+
+/*
+ * Cuts `p` down to `size` bytes if what's left can be a block of its own, and
+ * hands the rest back to the bins.
+ */
+static void split(struct jheap *hp, header *p, size_t size)
+{
+	header *n;
+
+	if (p->size - size < sizeof(header))
+		return; /* accept fragmentation */
+	n = (header *)((void *)p + size);
+	n->size = p->size - size;
+	n->is_free = true;
+	n->is_mmap = false;
+	n->is_sampled = false;
+	n->is_guarded = false;
+	n->heap = p->heap;
+	p->size = size;
+	link_after(hp, p, n);
+	bin_insert(hp, coalesce(hp, n));
+}
+
+/*
+ * Growth policy, see jmallopt(). Filled from the environment on first use.
+ */
+static struct {
+	bool ready;
+	size_t growth; /* factor between consecutive sbrk() chunks */
+	size_t chunk_max; /* geometric growth stops here */
+	bool prefault; /* fault the pages in before handing them out */
+	size_t thp; /* madvise(MADV_HUGEPAGE) regions at least this big */
+	bool remote_free; /* jfree() defers to the lock holder if it's busy */
+	size_t guard; /* blocks this big get a guard page, 0 is off */
+	size_t quarantine; /* bytes of freed blocks held back, 0 is off */
+} policy = { .growth = 2, .chunk_max = 4 * BLOCK_BIG, .remote_free = true };
+
+static int setopt(int param, int value)
+{
+	if (value < 0)
+		return 0;
+	switch (param) {
+	case JM_GROWTH:
+		policy.growth = (size_t)value;
+		return 1;
+	case JM_CHUNK_MAX:
+		policy.chunk_max = (size_t)value;
+		return 1;
+	case JM_PREFAULT:
+		policy.prefault = value != 0;
+		return 1;
+	case JM_THP:
+		policy.thp = (size_t)value;
+		return 1;
+	case JM_REMOTE_FREE:
+		policy.remote_free = value != 0;
+		return 1;
+	case JM_CACHE:
+		return jcache_setup(value);
+	case JM_GUARD:
+		policy.guard = (size_t)value;
+		return 1;
+	case JM_QUARANTINE:
+		policy.quarantine = (size_t)value;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static void envopt(const char *name, int param)
+{
+	const char *v = getenv(name);
+	if (v && *v)
+		setopt(param, (int)strtol(v, NULL, 0));
+}
+
+#if defined(JMM_HARDENED)
+static uint64_t secret; /* keys the block seals, see seal() */
+#endif
+
+/* set once jmm_init() is done, policy.ready only keeps it from nesting */
+static atomic_bool loaded;
+
+static void jmm_init(void)
+{
+	if (policy.ready)
+		return;
+	policy.ready = true;
+	envopt("JMM_GROWTH", JM_GROWTH);
+	envopt("JMM_CHUNK_MAX", JM_CHUNK_MAX);
+	envopt("JMM_PREFAULT", JM_PREFAULT);
+	envopt("JMM_THP", JM_THP);
+	envopt("JMM_REMOTE_FREE", JM_REMOTE_FREE);
+	envopt("JMM_CACHE", JM_CACHE);
+	envopt("JMM_GUARD", JM_GUARD);
+	envopt("JMM_QUARANTINE", JM_QUARANTINE);
+#if defined(JMM_HARDENED)
+	/* the kernel's 16 random bytes, glibc keys its stack guard with the rest */
+	jmemcpy(&secret, (char *)getauxval(AT_RANDOM) + 8, sizeof(secret));
+#endif
+	atomic_store_explicit(&loaded, true, memory_order_release);
+}
+
+/*
+ * The public entry points start with this, so the environment is read
+ * before the first call decides anything by the policy: the cache, guard
+ * mode and the quarantine, not only the growth of the first chunk.
+ */
+static inline void jmm_start(void)
+{
+	if (atomic_load_explicit(&loaded, memory_order_acquire))
+		return;
+	jmm_lock();
+	jmm_init();
+	jmm_unlock();
+}
+
+int jmallopt(int param, int value)
+{
+	int ret;
+
+	jmm_lock();
+	jmm_init();
+	ret = setopt(param, value);
+	jmm_unlock();
+	return ret;
+}
+
+/*
+ * Applies the prefault and huge page parts of the policy to a fresh region.
+ * madvise() wants page aligned ranges, so only the pages fully inside
+ * [p, p + len) are advised.
+ */
+static void advise(void *p, size_t len, bool populated)
+{
+	void *start = (void *)JMM_PAGE((uintptr_t)p);
+	void *end = (void *)(((uintptr_t)p + len) & ~(pagesz() - 1));
+
+	if (start >= end)
+		return;
+#if defined(MADV_HUGEPAGE)
+	if (policy.thp && len >= policy.thp)
+		madvise(start, end - start, MADV_HUGEPAGE);
+#endif
+	if (!policy.prefault || populated)
+		return;
+#if defined(MADV_POPULATE_WRITE)
+	if (madvise(start, end - start, MADV_POPULATE_WRITE) == 0)
+		return;
+#endif
+	/* older kernels, touch every page by hand */
+	for (volatile char *c = start; (void *)c < end; c += pagesz())
+		*c = 0;
+}
+
+/*
+ * How much a heap grows by. Requests are rounded up to their size class, and
+ * each chunk is at least `growth` times the previous one until `chunk_max`,
+ * so a steady stream of allocations ends up asking the kernel for memory a
+ * logarithmic number of times.
+ */
+static size_t chunk_len(struct jheap *hp, size_t size)
+{
+	size_t len;
+	size_t grow;
+
+	if (size <= BLOCK_LIT)
+		len = BLOCK_LIT;
+	else if (size <= BLOCK_MID)
+		len = BLOCK_MID;
+	else if (size <= BLOCK_BIG)
+		len = BLOCK_BIG;
+	else
+		len = (size / sizeof(header) + 1) * sizeof(header);
+	if (policy.growth > 1 && hp->last) {
+		if (hp->last <= policy.chunk_max / policy.growth)
+			grow = hp->last * policy.growth;
 		else
-			p = NULL;
+			grow = policy.chunk_max;
+		if (len < grow)
+			len = grow;
 	}
-	if (p) {
-		p->is_free = true;
-		p->prev = NULL;
-		p->next = NULL;
+	return len;
+}
+
+/* The only place where sbrk() is actually called, for the default heap. */
+header *upbrk(size_t size)
+{
+	header *p;
+	size_t len;
+
+	jmm_init();
+	len = chunk_len(&main_heap, size);
+	if ((p = sbrk(len)) == (void *)-1)
+		return NULL;
+	main_heap.last = len;
+	advise(p, len, false);
+	p->size = len;
+	p->is_free = true;
+	p->is_mmap = false;
+	p->is_sampled = false;
+	p->is_guarded = false;
+	p->heap = 0;
+	p->prev = NULL;
+	p->next = NULL;
+	return p;
+}
+
+static void chunk_link(struct jheap *hp, struct chunk *c, size_t len)
+{
+	c->len = len;
+	c->prev = NULL;
+	c->next = hp->chunks;
+	if (c->next)
+		c->next->prev = c;
+	hp->chunks = c;
+}
+
+static void chunk_unlink(struct jheap *hp, struct chunk *c)
+{
+	if (c->prev)
+		c->prev->next = c->next;
+	else
+		hp->chunks = c->next;
+	if (c->next)
+		c->next->prev = c->prev;
+}
+
+/* the kernel moved a chunk, its neighbours still point at the old place */
+static void chunk_moved(struct jheap *hp, struct chunk *c, size_t len)
+{
+	c->len = len;
+	if (c->prev)
+		c->prev->next = c;
+	else
+		hp->chunks = c;
+	if (c->next)
+		c->next->prev = c;
+}
+
+/* sbrk() for the other heaps, a chunk of blocks behind its struct chunk */
+static header *newchunk(struct jheap *hp, size_t size)
+{
+	struct chunk *c;
+	header *p;
+	size_t len;
+
+	jmm_init();
+	len = JMM_PAGE(chunk_len(hp, size + sizeof(*c)));
+	c = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+		 -1, 0);
+	if (c == MAP_FAILED)
+		return NULL;
+	hp->last = len;
+	advise(c, len, false);
+	chunk_link(hp, c, len);
+	p = (header *)(c + 1);
+	p->size = len - sizeof(*c);
+	p->is_free = true;
+	p->is_mmap = false;
+	p->is_sampled = false;
+	p->is_guarded = false;
+	p->heap = hp->id;
+	p->prev = NULL;
+	p->next = NULL;
+	return p;
+}
+
+/*
+ * Grows `curr` in place up to `need` bytes by moving the program break. Only
+ * possible in the default heap, when `curr` (or `curr` and the free block
+ * after it) ends right at the current break. The break moves by a whole
+ * chunk as upbrk() sizes it, and what `curr` doesn't need stays behind as a
+ * free block for the next growth to expand into.
+ */
+static bool topgrow(struct jheap *hp, header *curr, size_t need)
+{
+	header *next = curr->next;
+	size_t have = curr->size;
+	header *n;
+
+	if (hp != &main_heap)
+		return false;
+	if (next) {
+		if (next->next || !next->is_free || !adjacent(curr, next))
+			return false;
+		have += next->size;
 	}
+	if ((void *)curr + have != sbrk(0))
+		return false;
+	if ((n = upbrk(need - have)) == NULL)
+		return false;
+	if ((void *)curr + have != (void *)n) {
+		/* somebody else moved the break in between, keep the chunk */
+		link_after(hp, hp->tail, n);
+		bin_insert(hp, n);
+		return false;
+	}
+	if (next) {
+		bin_remove(hp, next);
+		unlink_block(hp, next);
+	}
+	curr->size = have + n->size;
+	split(hp, curr, need);
+	return true;
+}
+
+static header *grow(struct jheap *hp, size_t size)
+{
+	return hp == &main_heap ? upbrk(size) : newchunk(hp, size);
+}
+
+/*
+ * Maps a block of its own. The mapping is page aligned and never goes onto
+ * the linked list. For an `align` above the header size the header is pushed
+ * into the first page so that the payload lands on the boundary. Outside the
+ * default heap the mapping also starts with a struct chunk.
+ */
+static header *mapblock(struct jheap *hp, size_t size, size_t align)
+{
+	header *p;
+	void *base;
+	size_t lead = 0;
+	size_t len;
+	size_t extra = 0;
+	bool populate;
+
+	jmm_init();
+	if (align > sizeof(header))
+		lead = (align < pagesz() ? align : pagesz()) - sizeof(header);
+	if (hp != &main_heap && lead < sizeof(struct chunk))
+		lead = sizeof(struct chunk);
+	len = JMM_PAGE(lead + size);
+	if (len < size)
+		return NULL;
+	/* mmap() only promises page alignment, map more and cut it off */
+	if (align > pagesz())
+		extra = align;
+	/* huge pages have to be asked for before the first fault */
+	populate = policy.prefault && !(policy.thp && len >= policy.thp);
+	base = mmap(NULL, len + extra, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | (populate ? MAP_POPULATE : 0),
+		    -1, 0);
+	if (base == MAP_FAILED)
+		return NULL;
+	if (extra) {
+		void *raw = base;
+		base = (void *)((((uintptr_t)raw + pagesz() + align - 1) &
+				 ~(align - 1)) - pagesz());
+		if (base != raw)
+			munmap(raw, base - raw);
+		if (raw + len + extra != base + len)
+			munmap(base + len, (raw + len + extra) - (base + len));
+	}
+	advise(base, len, populate);
+	if (hp != &main_heap)
+		chunk_link(hp, base, len);
+	p = base + lead;
+	p->size = len;
+	p->is_free = false;
+	p->is_mmap = true;
+	p->is_sampled = false;
+	p->is_guarded = false;
+	p->heap = hp->id;
+	p->prev = base;
+	p->next = NULL;
 	return p;
 }
 
-void *jmalloc(size_t size)
+header *upmap(size_t size, size_t align)
+{
+	return mapblock(&main_heap, size, align);
+}
+
+/*
+ * Guard mode, see jmallopt(JM_GUARD). The block gets a mapping of its own with
+ * an inaccessible page right after it, and the payload is pushed up against
+ * that page, so running off its end faults on the spot.
+ */
+static void *guarded(size_t size, size_t align)
+{
+	size_t room;
+	size_t len;
+	void *base;
+	header *h;
+
+	if (align < alignof(header))
+		align = alignof(header);
+	room = (size + align - 1) & ~(align - 1);
+	len = JMM_PAGE(room + sizeof(header));
+	if (room < size || len < room)
+		return NULL;
+	base = mmap(NULL, len + pagesz(), PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+		return NULL;
+	mprotect(base + len, pagesz(), PROT_NONE);
+	h = (header *)(base + len - room) - 1;
+	h->size = len + pagesz();
+	h->is_free = false;
+	h->is_mmap = true;
+	h->is_sampled = false;
+	h->is_guarded = true;
+	h->heap = 0;
+	h->prev = base;
+	h->next = NULL;
+	return (void *)(h + 1);
+}
+
+/* where the block's payload ends */
+static void *block_end(header *h)
+{
+	if (!h->is_mmap)
+		return (void *)h + h->size;
+	return MAPBASE(h) + h->size - (h->is_guarded ? pagesz() : 0);
+}
+
+static void *jmm_malloc(struct jheap *hp, size_t size)
 {
 	header *p;
 	header *n;
@@ -92,54 +814,45 @@ void *jmalloc(size_t size)
 		return NULL;
 	}
 
+	if (hp == &main_heap && policy.guard && size >= policy.guard)
+		return guarded(size, 0);
+
+	/* big enough to deserve its own mapping */
+	if (total > MMAP_THRESHOLD) {
+		if ((p = mapblock(hp, total, 0)) == NULL)
+			return NULL;
+		return (void *)(++p);
+	}
+
 	/* list doesn't exist yet */
-	if (head == NULL)
-		head = upbrk(BLOCK_LIT);
+	if (hp->head == NULL) {
+		if ((hp->head = hp->tail = grow(hp, BLOCK_LIT)) == NULL)
+			return NULL;
+		bin_insert(hp, hp->head);
+	}
 #ifdef DEBUG_JMALLOC
 	fprintf(stderr, "[DEBUG] requested size: %d\n", (int)size);
 	fprintf(stderr, "[DEBUG] total_size: %d\n", (int)total);
 #endif
-	p = head;
-	while (p != NULL) {
-#ifdef DEBUG_JMALLOC
-		fprintf(stderr, "[DEBUG] p->size : %d\n", (int)p->size);
-#endif
-		if (p->is_free && p->size >= total) {
-			/* claim the block. there is enough space */
-			if (p->size - total >= sizeof(header)) { /* trim */
-				/* there is enough space for a second block */
-				n = (header *)((void *)p + total);
-				n->is_free = true;
-				n->size = p->size - total;
-
-				p->is_free = false;
-				p->size = total;
-
-				n->prev = p;
-				n->next = p->next;
-				p->next = n;
-				if (n->next)
-					n->next->prev = n;
-			} else {
-				/*
-				 * either there isn't enough space for a second
-				 * block, or we have the perfect case
-				 * (size == total)
-				 */
-				p->is_free = false;
-			}
-			break;
-		} else if (p->next == NULL) {
-			/* we don't have a free block */
-			n = upbrk(total);
-			p->next = n;
-			n->prev = p;
+	if ((p = bin_search(hp, total)) != NULL) {
+		bin_remove(hp, p);
+	} else {
+		/* we don't have a free block */
+		if ((n = grow(hp, total)) == NULL)
+			return NULL;
+		if (hp->tail->is_free && adjacent(hp->tail, n)) {
+			bin_remove(hp, hp->tail);
+			hp->tail->size += n->size;
+			p = hp->tail;
+		} else {
+			link_after(hp, hp->tail, n);
 			p = n;
-			p->is_free = false;
-			break;
 		}
-		p = p->next;
 	}
+	/* claim the block, the trim goes back to the bins */
+	p->is_free = false;
+	p->is_sampled = false; /* a moved block leaves its flag behind */
+	split(hp, p, total);
 
 #ifdef DEBUG_JMALLOC
 	fprintf(stderr, "[DEBUG] p->is_free : %b\n", p->is_free);
@@ -150,124 +863,661 @@ void *jmalloc(size_t size)
 	return (void *)(++p);
 }
 
-void jfree(void *__jnullable p)
+/* gives a block back for good, whatever the quarantine says */
+static void discard(struct jheap *hp, header *dead)
 {
-	header *prev = NULL;
-	header *dead = NULL;
-	header *next = NULL;
-	if (p)
-		dead = (header *)p - 1;
-	else
+	if (dead->is_mmap) {
+		if (hp != &main_heap)
+			chunk_unlink(hp, MAPBASE(dead));
+		munmap(MAPBASE(dead), dead->size);
 		return;
+	}
+
+	dead->is_free = true;
+	bin_insert(hp, coalesce(hp, dead));
+}
+
+/*
+ * Quarantine, see jmallopt(JM_QUARANTINE). Freed blocks wait in a FIFO until
+ * the bytes held pass the limit. A mapped block is made inaccessible while it
+ * waits; a heap block shares its pages, so it's filled with JMM_POISON
+ * instead, and checked for stray writes when it finally goes back.
+ */
+#define JMM_QUARANTINE_SLOTS 65536
+#define JMM_POISON 0xdf
+
+struct qent {
+	header *h;
+	void *base; /* the mapping, for a mapped block */
+	size_t size;
+};
 
-	/* find prev */
-	if (dead->prev)
-		prev = dead->prev;
+static struct qent *qring; /* mmap()ed */
+static size_t qfirst;
+static size_t qcount;
+static size_t qbytes;
 
-	/* find next */
-	if (dead->next)
-		next = dead->next;
+static void evict(void)
+{
+	struct qent *e = &qring[qfirst];
+	const uint64_t *w;
+	const uint64_t *end;
 
-	/* there is a free block after dead */
-	if (next && next->is_free) {
-		dead->size += next->size;
-		dead->next = next->next;
-		if (dead->next)
-			dead->next->prev = dead;
-		next = NULL;
+	qfirst = (qfirst + 1) % JMM_QUARANTINE_SLOTS;
+	qcount--;
+	qbytes -= e->size;
+	if (e->base) {
+		munmap(e->base, e->size);
+		return;
 	}
+	w = (const uint64_t *)(e->h + 1);
+	end = (const uint64_t *)((void *)e->h + e->size);
+	for (; w < end; w++) {
+		if (*w != JMM_POISON * 0x0101010101010101ULL)
+			jmm_panic("free(): write to a block after it was freed");
+	}
+	discard(&main_heap, e->h);
+}
+
+static void quarantine(header *h)
+{
+	struct qent *e;
 
-	/* there is a free block before dead */
-	if (prev && prev->is_free) {
-		prev->size += dead->size;
-		prev->next = dead->next;
-		if (prev->next)
-			prev->next->prev = prev;
-		dead = prev;
-		prev = NULL;
+	if (!qring) {
+		qring = mmap(NULL, JMM_QUARANTINE_SLOTS * sizeof(*qring),
+			     PROT_READ | PROT_WRITE,
+			     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (qring == MAP_FAILED) {
+			qring = NULL;
+			discard(&main_heap, h);
+			return;
+		}
+	}
+	if (qcount == JMM_QUARANTINE_SLOTS)
+		evict();
+	e = &qring[(qfirst + qcount++) % JMM_QUARANTINE_SLOTS];
+	e->h = h;
+	e->size = h->size;
+	if (h->is_mmap) {
+		e->base = MAPBASE(h);
+		mprotect(e->base, e->size, PROT_NONE);
+	} else {
+		e->base = NULL;
+		jmemset(h + 1, JMM_POISON, h->size - sizeof(header));
 	}
+	qbytes += e->size;
+	while (qbytes > policy.quarantine)
+		evict();
+}
 
-	dead->is_free = true;
-	return;
+static void jmm_free(struct jheap *hp, void *__jnullable p)
+{
+	if (!p)
+		return;
+	/* after the limit drops to 0 the next free empties the quarantine */
+	if (hp == &main_heap && (policy.quarantine || qcount))
+		quarantine((header *)p - 1);
+	else
+		discard(hp, (header *)p - 1);
 }
 
-void *jrealloc(void *__jnullable p, size_t size)
+static void *jmm_realloc(struct jheap *hp, void *__jnullable p, size_t size)
 {
-	size_t left = 0;
+	void *base;
+	size_t lead;
 	size_t need = 0;
 	header *curr = NULL;
 	header *next = NULL;
 
 	if (!p)
-		return jmalloc(size);
+		return jmm_malloc(hp, size);
 	if (size == 0) {
-		jfree(p);
+		jmm_free(hp, p);
 		return NULL;
 	}
 
 	curr = (header *)p - 1;
 	need = sizeof(header) + size;
 	need = JMM_ALIGN(need);
-	if (need <= curr->size) {
+	if (need < size)
+		return NULL;
+	if (curr->is_guarded ||
+	    (hp == &main_heap && policy.guard && size >= policy.guard)) {
 		/*
-                 *        P A T H   1 :   S H R I N K
+		 * The payload ends at the guard page, so it can only move. A
+		 * block that grows into guard mode moves too, to a guarded one.
+		 */
+		if ((next = jmm_malloc(hp, size)) == NULL)
+			return NULL;
+		lead = block_end(curr) - p;
+		jmemcpy(next, p, lead < size ? lead : size);
+		jmm_free(hp, p);
+		return next;
+	} else if (curr->is_mmap) {
+		/*
+                 *        P A T H   0 :   R E M A P
                  */
-		left = curr->size - need;
-		left = JMM_ALIGN(left);
-		if (left >= sizeof(header)) {
-			/* new block */
-			next = (header *)((void *)curr + need);
-			next->is_free = true;
-			curr->size = need;
-			next->size = left;
-			next->prev = curr;
-			next->next = curr->next;
-			curr->next = next;
-			if (next->next)
-				next->next->prev = next;
-			return p;
-		} else {
-			/* no new block, accept fragmentation */
+		base = MAPBASE(curr);
+		lead = (void *)curr - base;
+		if (JMM_PAGE(lead + need) < need)
+			return NULL;
+		if (JMM_PAGE(lead + need) == curr->size)
 			return p;
-		}
-	} else if (curr->next && curr->next->is_free &&
+		/* the kernel moves the page table entries, no bytes are copied */
+		base = mremap(base, curr->size, JMM_PAGE(lead + need),
+			      MREMAP_MAYMOVE);
+		if (base == MAP_FAILED)
+			return NULL;
+		next = base + lead;
+		next->size = JMM_PAGE(lead + need);
+		next->prev = base;
+		if (hp != &main_heap)
+			chunk_moved(hp, base, next->size);
+		return (void *)(next + 1);
+	} else if (need <= curr->size) {
+		/*
+                 *        P A T H   1 :   S H R I N K
+                 */
+		split(hp, curr, need);
+		return p;
+	} else if (need <= MMAP_THRESHOLD && curr->next &&
+		   curr->next->is_free && adjacent(curr, curr->next) &&
 		   curr->size + curr->next->size >= need) {
 		/*
                  *        P A T H   2 :   E X P A N D
                  */
-		left = (curr->size + curr->next->size) - need;
-		if (left >= sizeof(header)) {
-			/* new block */
-			next = (header *)((void *)curr + need);
-			next->is_free = true;
-			curr->size = need;
-			next->size = left;
-			next->prev = curr;
-			next->next = curr->next->next;
-			curr->next = next;
-			if (next->next)
-				next->next->prev = next;
-			return p;
-		} else {
-			/* no new block, accept fragmentation */
-			curr->size += curr->next->size;
-			curr->next = curr->next->next;
-			if (curr->next)
-				curr->next->prev = curr;
-			return p;
-		}
+		next = curr->next;
+		bin_remove(hp, next);
+		curr->size += next->size;
+		unlink_block(hp, next);
+		split(hp, curr, need);
+		return p;
+	} else if (need <= MMAP_THRESHOLD && topgrow(hp, curr, need)) {
+		/*
+                 *        P A T H   3 :   G R O W   A T   T H E   T O P
+                 */
+		return p;
 	} else {
 		/*
-                 *        P A T H   3 :   R E L O C A T E
+                 *        P A T H   4 :   R E L O C A T E
                  */
-		if ((next = jmalloc(size)) == NULL) {
+		/* past MMAP_THRESHOLD this lands in a mapping of its own */
+		if ((next = jmm_malloc(hp, size)) == NULL) {
 			/* jmalloc failed, return NULL */
 			return NULL;
 		} else {
 			/* copy old data */
 			jmemcpy(next, p, curr->size - sizeof(header));
-			jfree(p);
+			jmm_free(hp, p);
 			return next;
 		}
 	}
 }
+
+/*
+ * Over-allocates by `align`, then gives the bytes in front of the first
+ * aligned payload that leaves room for a header back as a free block.
+ */
+static void *jmm_memalign(struct jheap *hp, size_t align, size_t size)
+{
+	header *h;
+	header *n;
+	size_t total;
+	size_t lead;
+	bool guard;
+	void *p;
+
+	if (align <= alignof(header))
+		return jmm_malloc(hp, size);
+	total = JMM_ALIGN(size + sizeof(header));
+	if (total < size || total + align < total)
+		return NULL;
+	/* as jmm_malloc() would see it, a guarded block can't be split below */
+	guard = hp == &main_heap && policy.guard &&
+		total + align >= policy.guard;
+	if (guard && align <= pagesz())
+		return guarded(size, align);
+	if (total + align > MMAP_THRESHOLD || guard) {
+		if ((h = mapblock(hp, total, align)) == NULL)
+			return NULL;
+		return (void *)(h + 1);
+	}
+	if ((p = jmm_malloc(hp, total + align)) == NULL)
+		return NULL;
+	h = (header *)p - 1;
+	if ((uintptr_t)p % align) {
+		lead = (((uintptr_t)p + sizeof(header) + align - 1) &
+			~(align - 1)) -
+		       (uintptr_t)p;
+		n = (header *)((void *)h + lead);
+		n->size = h->size - lead;
+		n->is_free = false;
+		n->is_mmap = false;
+		n->is_sampled = false;
+		n->is_guarded = false;
+		n->heap = h->heap;
+		h->size = lead;
+		link_after(hp, h, n);
+		h->is_free = true;
+		bin_insert(hp, coalesce(hp, h));
+		h = n;
+	}
+	split(hp, h, total);
+	return (void *)(h + 1);
+}
+
+/*
+ * Hardened builds seal every block they hand out, with a checksum of the
+ * header kept in its padding and a canary in the last word of the block.
+ * jfree() and jrealloc() check both and abort on a mismatch, so a double free,
+ * a wild pointer or a linear overflow is caught at the free instead of
+ * corrupting the lists for something else to trip over later. Both values
+ * are keyed with a per-process secret, they can't be forged blindly.
+ */
+#if defined(JMM_HARDENED)
+#define JMM_TAIL sizeof(uint64_t) /* room for the canary */
+
+static uint32_t checksum(header *h)
+{
+	uint64_t x = secret ^ (uintptr_t)h ^ h->size ^
+		     ((uint64_t)h->heap << 48) ^ ((uint64_t)h->is_mmap << 63);
+
+	return (uint32_t)((x * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static uint64_t *canary(header *h)
+{
+	return (uint64_t *)block_end(h) - 1;
+}
+
+static void seal(void *__jnullable p)
+{
+	header *h;
+
+	if (!p)
+		return;
+	h = (header *)p - 1;
+	h->check = checksum(h);
+	*canary(h) = secret ^ (uintptr_t)h;
+}
+
+/* a freed block fails verify() until it's handed out again */
+static void unseal(void *p)
+{
+	header *h = (header *)p - 1;
+
+	h->check = ~checksum(h);
+}
+
+static void verify(void *p)
+{
+	header *h = (header *)p - 1;
+
+	if ((uintptr_t)p % alignof(header))
+		jmm_panic("free(): invalid pointer");
+	if (h->is_free)
+		jmm_panic("free(): double free detected");
+	if (h->check != checksum(h))
+		jmm_panic("free(): corrupted header or double free");
+	if (*canary(h) != (secret ^ (uintptr_t)h))
+		jmm_panic("free(): write past the end of the block");
+}
+
+/* what the core is asked for, with room for the canary */
+static size_t padded(size_t size)
+{
+	if (size > SIZE_MAX - JMM_TAIL)
+		return SIZE_MAX;
+	return size ? size + JMM_TAIL : 0;
+}
+#else
+#define JMM_TAIL 0
+#define seal(p) ((void)0)
+#define unseal(p) ((void)0)
+#define verify(p) ((void)0)
+#define padded(size) (size)
+#endif
+
+static size_t jmm_usable_size(void *__jnullable p)
+{
+	header *h;
+
+	if (!p)
+		return 0;
+	h = (header *)p - 1;
+	return block_end(h) - p - JMM_TAIL;
+}
+
+/*
+ * Everything that has to happen when a block goes back, lock held. Only the
+ * default heap is traced and profiled.
+ */
+static void release(struct jheap *hp, void *p)
+{
+	if (hp == &main_heap) {
+		if (((header *)p - 1)->is_sampled) {
+			((header *)p - 1)->is_sampled = false;
+			jprof_forget(p);
+		}
+		if (jtrace_active)
+			jtrace_log(JT_FREE, 0, NULL, p);
+	}
+	jmm_free(hp, p);
+}
+
+/* one CAS when uncontended, the block's payload is dead already */
+static void push_remote(struct jheap *hp, void *p)
+{
+	header *h = (header *)p - 1;
+	header *old = atomic_load_explicit(&hp->remote, memory_order_relaxed);
+
+	do {
+		SET_LNEXT(h, old);
+	} while (!atomic_compare_exchange_weak_explicit(
+		&hp->remote, &old, h, memory_order_release,
+		memory_order_relaxed));
+}
+
+/* frees everything other threads left behind, in one batch */
+static void drain_remote(struct jheap *hp)
+{
+	header *h;
+	header *next;
+
+	if (!atomic_load_explicit(&hp->remote, memory_order_relaxed))
+		return;
+	h = atomic_exchange_explicit(&hp->remote, NULL, memory_order_acquire);
+	for (; h; h = next) {
+		next = LNEXT(h);
+		release(hp, h + 1);
+	}
+}
+
+/* takes the heap lock on behalf of an allocation */
+static void lock_heap(struct jheap *hp)
+{
+	heap_lock(hp);
+	drain_remote(hp);
+}
+
+/* the cache would hide calls from the trace, the profiler and the debug modes */
+static bool cacheable(void)
+{
+	return jcache_active && !jtrace_active && !jprof_active &&
+	       !policy.guard && !policy.quarantine;
+}
+
+/*
+ * The public entry points wrap the allocator so that internal calls, like
+ * jrealloc() relocating through jmalloc(), don't show up in a trace.
+ */
+void *jmalloc(size_t size)
+{
+	void *p;
+
+	jmm_start();
+	if (cacheable() && (p = jcache_pop(padded(size)))) {
+		seal(p);
+		return p;
+	}
+	lock_heap(&main_heap);
+	p = jmm_malloc(&main_heap, padded(size));
+	if (p && (jprof_countdown -= (int64_t)size) < 0)
+		jprof_sample(p, size);
+	if (jtrace_active)
+		jtrace_log(JT_MALLOC, size, p, NULL);
+	jmm_unlock();
+	seal(p);
+	return p;
+}
+
+/* a block knows its heap, so jfree() works for all of them */
+void jfree(void *__jnullable p)
+{
+	struct jheap *hp;
+
+	if (!p)
+		return;
+	jmm_start();
+	verify(p);
+	unseal(p);
+	hp = HEAP_OF((header *)p - 1);
+	if (hp == &main_heap && cacheable() && jcache_push(p))
+		return;
+	if (!policy.remote_free) {
+		heap_lock(hp);
+	} else if (!heap_trylock(hp)) {
+		/* somebody else has the heap, they free it on their next call */
+		push_remote(hp, p);
+		return;
+	}
+	drain_remote(hp);
+	release(hp, p);
+	heap_unlock(hp);
+}
+
+void *jrealloc(void *__jnullable p, size_t size)
+{
+	void *n;
+	bool sampled;
+
+	jmm_start();
+	if (p && ((header *)p - 1)->heap)
+		return jheap_realloc(HEAP_OF((header *)p - 1), p, size);
+	if (p)
+		verify(p);
+	lock_heap(&main_heap);
+	sampled = p && ((header *)p - 1)->is_sampled;
+	n = jmm_realloc(&main_heap, p, padded(size));
+	/*
+	 * The profile sees a moved or resized block as a new one. A failed
+	 * jrealloc() leaves the block live, and tracked, where it was.
+	 */
+	if (sampled && (n || size == 0)) {
+		if (n == p)
+			((header *)n - 1)->is_sampled = false;
+		jprof_forget(p);
+	}
+	if (n && (jprof_countdown -= (int64_t)size) < 0)
+		jprof_sample(n, size);
+	if (jtrace_active)
+		jtrace_log(JT_REALLOC, size, n, p);
+	jmm_unlock();
+	seal(n);
+	return n;
+}
+
+void *jcalloc(size_t nmemb, size_t size)
+{
+	size_t total;
+	void *p;
+
+	jmm_start();
+	if (__builtin_mul_overflow(nmemb, size, &total)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	lock_heap(&main_heap);
+	p = jmm_malloc(&main_heap, padded(total));
+	if (p && (jprof_countdown -= (int64_t)total) < 0)
+		jprof_sample(p, total);
+	if (jtrace_active)
+		jtrace_log(JT_MALLOC, total, p, NULL);
+	jmm_unlock();
+	/* fresh mappings are zero already */
+	if (p && !((header *)p - 1)->is_mmap)
+		jmemset(p, 0, total);
+	seal(p);
+	return p;
+}
+
+void *jaligned_alloc(size_t alignment, size_t size)
+{
+	void *p;
+
+	jmm_start();
+	if (alignment & (alignment - 1)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	lock_heap(&main_heap);
+	p = jmm_memalign(&main_heap, alignment, padded(size));
+	if (p && (jprof_countdown -= (int64_t)size) < 0)
+		jprof_sample(p, size);
+	if (jtrace_active)
+		jtrace_log(JT_MALLOC, size, p, NULL);
+	jmm_unlock();
+	seal(p);
+	return p;
+}
+
+void *jreallocarray(void *__jnullable p, size_t nmemb, size_t size)
+{
+	size_t total;
+
+	if (__builtin_mul_overflow(nmemb, size, &total)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	return jrealloc(p, total);
+}
+
+void *jgrow(void *__jnullable p, size_t *cap, size_t min, size_t size)
+{
+	size_t want;
+	size_t total;
+	void *n;
+
+	if (size == 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (min <= *cap)
+		return p;
+	/* by half, not double, so a freed old block can hold a later one */
+	want = *cap + *cap / 2;
+	if (want < min || __builtin_mul_overflow(want, size, &total))
+		want = min;
+	if (__builtin_mul_overflow(want, size, &total)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	if ((n = jrealloc(p, total)) == NULL) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	/* the tail of the block is ours anyway, count it in */
+	*cap = jmalloc_usable_size(n) / size;
+	return n;
+}
+
+void jmm_reclaim(void *p)
+{
+	lock_heap(&main_heap);
+	jmm_free(&main_heap, p);
+	jmm_unlock();
+}
+
+void jmm_reclaim_locked(void *p)
+{
+	jmm_free(&main_heap, p);
+}
+
+size_t jmalloc_usable_size(void *__jnullable p)
+{
+	/* only reads the block's own header, no need for the lock */
+	return jmm_usable_size(p);
+}
+
+jheap_t *jheap_create(void)
+{
+	struct jheap *hp;
+
+	hp = mmap(NULL, sizeof(*hp), PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (hp == MAP_FAILED)
+		return NULL;
+	atomic_flag_clear(&hp->lock);
+	jmm_lock();
+	jmm_init();
+	for (int i = 1; i < JHEAP_MAX; i++) {
+		if (!heaps[i]) {
+			hp->id = (uint16_t)i;
+			heaps[i] = hp;
+			break;
+		}
+	}
+	jmm_unlock();
+	if (!hp->id) {
+		munmap(hp, sizeof(*hp));
+		errno = ENOMEM;
+		return NULL;
+	}
+	return hp;
+}
+
+void *jheap_malloc(jheap_t *__jnullable heap, size_t size)
+{
+	void *p;
+
+	if (!heap)
+		return jmalloc(size);
+	lock_heap(heap);
+	p = jmm_malloc(heap, padded(size));
+	heap_unlock(heap);
+	seal(p);
+	return p;
+}
+
+void jheap_free(jheap_t *__jnullable heap, void *__jnullable p)
+{
+#if defined(JMM_HARDENED)
+	if (p && HEAP_OF((header *)p - 1) != (heap ? heap : &main_heap))
+		jmm_panic("free(): block belongs to another heap");
+#else
+	(void)heap;
+#endif
+	jfree(p);
+}
+
+void *jheap_realloc(jheap_t *__jnullable heap, void *__jnullable p,
+		    size_t size)
+{
+	void *n;
+
+	if (p) {
+		verify(p);
+#if defined(JMM_HARDENED)
+		if (HEAP_OF((header *)p - 1) != (heap ? heap : &main_heap))
+			jmm_panic("realloc(): block belongs to another heap");
+#endif
+		/* the block decides the heap, like jfree() */
+		heap = HEAP_OF((header *)p - 1);
+	}
+	if (!heap || heap == &main_heap)
+		return jrealloc(p, size);
+	lock_heap(heap);
+	n = jmm_realloc(heap, p, padded(size));
+	heap_unlock(heap);
+	seal(n);
+	return n;
+}
+
+void jheap_destroy(jheap_t *__jnullable heap)
+{
+	struct chunk *c;
+	struct chunk *next;
+
+	if (!heap || heap == &main_heap)
+		return;
+	jmm_lock();
+	heaps[heap->id] = NULL;
+	jmm_unlock();
+	/* let whoever is still inside finish */
+	heap_lock(heap);
+	for (c = heap->chunks; c; c = next) {
+		next = c->next;
+		munmap(c, c->len);
+	}
+	munmap(heap, sizeof(*heap));
+}
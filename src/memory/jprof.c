@@ -0,0 +1,296 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/* the frames of jprof_sample() and the jmm entry point */
+#define JPROF_SKIP 2
+
+struct sample {
+	void *ptr; /* NULL if the slot is empty */
+	size_t size;
+	int depth;
+	void *stack[JPROF_DEPTH];
+};
+
+int64_t jprof_countdown = INT64_MAX;
+bool jprof_active;
+
+static size_t rate;
+static uint64_t rng;
+static struct sample *table; /* mmap()ed, jmm can't allocate for itself */
+static size_t used;
+
+static uint64_t next_rand(void)
+{
+	/* xorshift64* */
+	rng ^= rng >> 12;
+	rng ^= rng << 25;
+	rng ^= rng >> 27;
+	return rng * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Natural log of r / 2^53 for 1 <= r <= 2^53. Splits off the power of two
+ * and uses the atanh series on the mantissa, good to about 1e-6, which is
+ * plenty for drawing sample gaps and doesn't need libm.
+ */
+static double log_unit(uint64_t r)
+{
+	const double ln2 = 0.69314718055994530942;
+	int k = 63 - __builtin_clzll(r);
+	double m = (double)r / (double)(1ULL << k);
+	double z = (m - 1) / (m + 1);
+	double z2 = z * z;
+	double lnm = 2 * z * (1 + z2 * (1.0 / 3 + z2 * (1.0 / 5 +
+		     z2 * (1.0 / 7 + z2 * (1.0 / 9)))));
+	return (k - 53) * ln2 + lnm;
+}
+
+/* exponentially distributed with mean `rate`, the gap to the next sample */
+static int64_t next_gap(void)
+{
+	uint64_t r = (next_rand() >> 11) + 1;
+	double gap = -log_unit(r) * (double)rate;
+	return gap < (double)INT64_MAX ? (int64_t)gap : INT64_MAX;
+}
+
+static size_t slot(void *p)
+{
+	uint64_t h = (uintptr_t)p;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return (size_t)h & (JPROF_SLOTS - 1);
+}
+
+void jprof_sample(void *p, size_t size)
+{
+	void *frames[JPROF_DEPTH + JPROF_SKIP];
+	struct sample *s;
+	size_t i;
+	int n;
+
+	if (!rate) {
+		jprof_countdown = INT64_MAX;
+		return;
+	}
+	jprof_countdown = next_gap();
+	/* keep probe chains short, losing a sample only adds variance */
+	if (used >= JPROF_SLOTS / 4 * 3)
+		return;
+
+	for (i = slot(p); table[i].ptr; i = (i + 1) & (JPROF_SLOTS - 1))
+		;
+	s = &table[i];
+	n = backtrace(frames, JPROF_DEPTH + JPROF_SKIP) - JPROF_SKIP;
+	s->depth = n > 0 ? n : 0;
+	for (int k = 0; k < s->depth; k++)
+		s->stack[k] = frames[k + JPROF_SKIP];
+	s->ptr = p;
+	s->size = size;
+	used++;
+	((header *)p - 1)->is_sampled = true;
+}
+
+void jprof_forget(void *p)
+{
+	size_t i, j, k;
+
+	for (i = slot(p); table[i].ptr != p; i = (i + 1) & (JPROF_SLOTS - 1)) {
+		if (!table[i].ptr)
+			return;
+	}
+	/* backward shift deletion, no tombstones */
+	for (j = (i + 1) & (JPROF_SLOTS - 1); table[j].ptr;
+	     j = (j + 1) & (JPROF_SLOTS - 1)) {
+		k = slot(table[j].ptr);
+		if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+			table[i] = table[j];
+			i = j;
+		}
+	}
+	table[i].ptr = NULL;
+	used--;
+}
+
+int jprof_start(size_t r)
+{
+	void *warm[1];
+
+	/*
+	 * glibc loads the unwinder on the first backtrace(), which allocates.
+	 * Get that done now, while the heap lock isn't held.
+	 */
+	backtrace(warm, 1);
+
+	jmm_lock();
+	if (!table) {
+		table = mmap(NULL, JPROF_SLOTS * sizeof(*table),
+			     PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+			     -1, 0);
+		if (table == MAP_FAILED) {
+			table = NULL;
+			jmm_unlock();
+			return -1;
+		}
+	}
+	if (!rng)
+		rng = (uintptr_t)&warm ^ (uint64_t)time(NULL) ^ 0x9E3779B97F4A7C15ULL;
+	rate = r;
+	jprof_active = rate != 0;
+	jprof_countdown = rate ? next_gap() : INT64_MAX;
+	jmm_unlock();
+	return 0;
+}
+
+/*
+ * Small buffered writer. snprintf() may allocate and the heap lock is held
+ * while the table is walked, so numbers are formatted by hand.
+ */
+struct out {
+	int fd;
+	size_t len;
+	char buf[4096];
+};
+
+static void out_flush(struct out *o)
+{
+	const char *b = o->buf;
+	ssize_t n;
+
+	while (o->len) {
+		if ((n = write(o->fd, b, o->len)) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		b += n;
+		o->len -= (size_t)n;
+	}
+	o->len = 0;
+}
+
+static void out_str(struct out *o, const char *s)
+{
+	while (*s) {
+		if (o->len == sizeof(o->buf))
+			out_flush(o);
+		o->buf[o->len++] = *s++;
+	}
+}
+
+static void out_num(struct out *o, uint64_t v, unsigned base)
+{
+	char tmp[24];
+	char *t = tmp + sizeof(tmp) - 1;
+
+	*t = '\0';
+	do {
+		*--t = "0123456789abcdef"[v % base];
+		v /= base;
+	} while (v);
+	if (base == 16)
+		out_str(o, "0x");
+	out_str(o, t);
+}
+
+int jprof_dump(const char *path)
+{
+	struct out o;
+	size_t objs = 0, bytes = 0;
+	char maps[4096];
+	ssize_t n;
+	int fd;
+
+	if ((o.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			 0644)) < 0)
+		return -1;
+	o.len = 0;
+
+	jmm_lock();
+	for (size_t i = 0; table && i < JPROF_SLOTS; i++) {
+		if (table[i].ptr) {
+			objs++;
+			bytes += table[i].size;
+		}
+	}
+	out_str(&o, "heap profile: ");
+	out_num(&o, objs, 10);
+	out_str(&o, ": ");
+	out_num(&o, bytes, 10);
+	out_str(&o, " [");
+	out_num(&o, objs, 10);
+	out_str(&o, ": ");
+	out_num(&o, bytes, 10);
+	out_str(&o, "] @ heap_v2/");
+	out_num(&o, rate, 10);
+	out_str(&o, "\n");
+	for (size_t i = 0; table && i < JPROF_SLOTS; i++) {
+		struct sample *s = &table[i];
+		if (!s->ptr)
+			continue;
+		out_str(&o, "1: ");
+		out_num(&o, s->size, 10);
+		out_str(&o, " [1: ");
+		out_num(&o, s->size, 10);
+		out_str(&o, "] @");
+		for (int k = 0; k < s->depth; k++) {
+			out_str(&o, " ");
+			out_num(&o, (uintptr_t)s->stack[k], 16);
+		}
+		out_str(&o, "\n");
+	}
+	jmm_unlock();
+
+	/* pprof symbolizes the addresses with the mappings */
+	out_str(&o, "\nMAPPED_LIBRARIES:\n");
+	out_flush(&o);
+	if ((fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC)) >= 0) {
+		while ((n = read(fd, maps, sizeof(maps))) > 0) {
+			jmemcpy(o.buf, maps, (size_t)n);
+			o.len = (size_t)n;
+			out_flush(&o);
+		}
+		close(fd);
+	}
+	return close(o.fd);
+}
+
+__attribute__((constructor)) static void jprof_env(void)
+{
+	const char *r = getenv("JMM_PROFILE");
+	if (r && *r)
+		jprof_start(strtoul(r, NULL, 0));
+}
+
+__attribute__((destructor)) static void jprof_exit(void)
+{
+	const char *path = getenv("JMM_PROFILE_OUT");
+	if (rate && path && *path)
+		jprof_dump(path);
+}
@@ -0,0 +1,149 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#define _GNU_SOURCE /* gettid() */
+#include "jmm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+bool jtrace_active;
+
+static int fd = -1;
+static struct jtrace_rec *ring; /* mmap()ed, jmm can't allocate for itself */
+static size_t used;
+static uint64_t epoch;
+
+/* the first call from a thread pays for the syscall, the rest are free */
+static __thread __attribute__((tls_model("initial-exec"))) uint32_t tid;
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void flush(void)
+{
+	const char *buf = (const char *)ring;
+	size_t left = used * sizeof(*ring);
+	ssize_t n;
+
+	while (left) {
+		if ((n = write(fd, buf, left)) < 0) {
+			if (errno == EINTR)
+				continue;
+			break; /* nothing sensible to do from inside malloc */
+		}
+		buf += n;
+		left -= (size_t)n;
+	}
+	used = 0;
+}
+
+static void stop(void)
+{
+	if (!jtrace_active)
+		return;
+	jtrace_active = false;
+	flush();
+	close(fd);
+	fd = -1;
+	munmap(ring, JTRACE_RECS * sizeof(*ring));
+	ring = NULL;
+}
+
+static int start(const char *path)
+{
+	stop();
+	ring = mmap(NULL, JTRACE_RECS * sizeof(*ring), PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring == MAP_FAILED) {
+		ring = NULL;
+		return -1;
+	}
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		munmap(ring, JTRACE_RECS * sizeof(*ring));
+		ring = NULL;
+		return -1;
+	}
+	used = 0;
+	epoch = now();
+	jtrace_active = true;
+	return 0;
+}
+
+int jtrace_start(const char *path)
+{
+	int ret;
+
+	jmm_lock();
+	ret = start(path);
+	jmm_unlock();
+	return ret;
+}
+
+__attribute__((destructor)) void jtrace_stop(void)
+{
+	jmm_lock();
+	stop();
+	jmm_unlock();
+}
+
+void jtrace_drop(void)
+{
+	if (!jtrace_active)
+		return;
+	jtrace_active = false;
+	used = 0;
+	close(fd);
+	fd = -1;
+	munmap(ring, JTRACE_RECS * sizeof(*ring));
+	ring = NULL;
+}
+
+__attribute__((constructor)) static void jtrace_env(void)
+{
+	const char *path = getenv("JMM_TRACE");
+	if (path && *path)
+		jtrace_start(path);
+}
+
+void jtrace_log(int op, size_t size, void *ptr, void *old)
+{
+	struct jtrace_rec *r;
+
+	if (!tid)
+		tid = (uint32_t)gettid();
+	r = &ring[used];
+	r->ts = now() - epoch;
+	r->size = size;
+	r->ptr = (uintptr_t)ptr;
+	r->old = (uintptr_t)old;
+	r->tid = tid;
+	r->op = (uint8_t)op;
+	r->pad[0] = r->pad[1] = r->pad[2] = 0;
+	if (++used == JTRACE_RECS)
+		flush();
+}
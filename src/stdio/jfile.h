@@ -0,0 +1,78 @@
+#if !defined(__JFILE_H)
+# define __JFILE_H
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * What's behind a jFILE, shared by the stream sources and nobody else.
+ *
+ * Reading has one buffer, rbuf[rpos, rend) being what's read but not taken
+ * yet. Writing has up to QUEUE of them: the ones before wcur are full, the
+ * current one holds wpos bytes, and flushing hands all of it to a single
+ * writev(). Either side's buffers are only allocated when first needed.
+ */
+
+#include "jstdio.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PAGE 4096 /* buffers are aligned to this */
+#define QUEUE 4	  /* write buffers gathered into one writev() */
+
+enum {
+	F_READ = 1 << 0,    /* opened for reading */
+	F_WRITE = 1 << 1,   /* opened for writing */
+	F_READING = 1 << 2, /* the last thing done was a read */
+	F_EOF = 1 << 3,
+	F_ERR = 1 << 4,
+	F_UNBUF = 1 << 5,   /* every write goes straight out */
+	F_LINE = 1 << 6,    /* a write with a newline flushes */
+	F_TTY = 1 << 7,	    /* line buffered if a terminal, not looked at yet */
+	F_STATIC = 1 << 8,  /* one of the standard streams, never freed */
+	F_CLOSED = 1 << 9,  /* a standard stream that was closed */
+};
+
+struct jFILE {
+	int fd;
+	int flags;
+	pthread_mutex_t lock; /* recursive, jflockfile() nests */
+	char *rbuf;
+	size_t rpos;
+	size_t rend;
+	char *wbuf[QUEUE];
+	size_t wcur;
+	size_t wpos;
+	struct jFILE *prev; /* the open streams, for jfflush(NULL) */
+	struct jFILE *next;
+};
+
+/*
+ * Writes out whatever is queued, then the n bytes at p, in one writev()
+ * where it can. Returns how many bytes didn't make it, 0 when all did, and
+ * sets F_ERR if some didn't. The queue is empty afterwards either way.
+ */
+extern size_t jfile_drain(jFILE *f, const void *p, size_t n);
+
+/* gets f ready to read or write after it did the other, false on failure */
+extern bool jfile_reading(jFILE *f);
+extern bool jfile_writing(jFILE *f);
+
+/* the open streams, for flushing them all */
+extern pthread_mutex_t jfile_list_lock;
+extern jFILE *jfile_list;
+
+#endif /* __JFILE_H */
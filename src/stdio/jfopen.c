@@ -0,0 +1,287 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#define _GNU_SOURCE /* PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP */
+
+#include "jfile.h"
+#include "jmm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define STREAM_LOCK PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+
+static jFILE std[3] = {
+	{ .fd = 0, .flags = F_READ | F_STATIC, .lock = STREAM_LOCK,
+	  .next = &std[1] },
+	{ .fd = 1, .flags = F_WRITE | F_TTY | F_STATIC, .lock = STREAM_LOCK,
+	  .prev = &std[0], .next = &std[2] },
+	{ .fd = 2, .flags = F_WRITE | F_UNBUF | F_STATIC, .lock = STREAM_LOCK,
+	  .prev = &std[1] },
+};
+
+jFILE *const jstdin = &std[0];
+jFILE *const jstdout = &std[1];
+jFILE *const jstderr = &std[2];
+
+pthread_mutex_t jfile_list_lock = PTHREAD_MUTEX_INITIALIZER;
+jFILE *jfile_list = &std[0];
+
+/* the stream flags and open() flags for mode, -1 if it isn't one */
+static int parse_mode(const char *mode, int *oflags)
+{
+	int flags;
+
+	switch (*mode) {
+	case 'r':
+		flags = F_READ;
+		*oflags = O_RDONLY;
+		break;
+	case 'w':
+		flags = F_WRITE;
+		*oflags = O_WRONLY | O_CREAT | O_TRUNC;
+		break;
+	case 'a':
+		flags = F_WRITE;
+		*oflags = O_WRONLY | O_CREAT | O_APPEND;
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+	while (*++mode) {
+		if (*mode == '+') {
+			flags |= F_READ | F_WRITE;
+			*oflags = (*oflags & ~O_ACCMODE) | O_RDWR;
+		} else if (*mode == 'x') {
+			*oflags |= O_EXCL;
+		} else if (*mode == 'e') {
+			*oflags |= O_CLOEXEC;
+		}
+	}
+	return flags;
+}
+
+static jFILE *stream(int fd, int flags)
+{
+	pthread_mutexattr_t attr;
+	jFILE *f;
+
+	if (!(f = jcalloc(1, sizeof(*f))))
+		return NULL;
+	f->fd = fd;
+	f->flags = flags;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&f->lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	pthread_mutex_lock(&jfile_list_lock);
+	f->next = jfile_list;
+	if (jfile_list)
+		jfile_list->prev = f;
+	jfile_list = f;
+	pthread_mutex_unlock(&jfile_list_lock);
+	return f;
+}
+
+jFILE *jfopen(const char *restrict path, const char *restrict mode)
+{
+	int oflags;
+	int flags = parse_mode(mode, &oflags);
+	int fd;
+	jFILE *f;
+
+	if (flags < 0 || (fd = open(path, oflags, 0666)) < 0)
+		return NULL;
+	if (!(f = stream(fd, flags)))
+		close(fd);
+	return f;
+}
+
+jFILE *jfdopen(int fd, const char *mode)
+{
+	int oflags;
+	int flags = parse_mode(mode, &oflags);
+	int fl;
+
+	if (flags < 0 || (fl = fcntl(fd, F_GETFL)) < 0)
+		return NULL;
+	/* the mode can't ask for more than the fd was opened for */
+	if (((flags & F_READ) && (fl & O_ACCMODE) == O_WRONLY) ||
+	    ((flags & F_WRITE) && (fl & O_ACCMODE) == O_RDONLY)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return stream(fd, flags);
+}
+
+int jfclose(jFILE *f)
+{
+	int ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfflush_unlocked(f);
+	if (close(f->fd) < 0)
+		ret = JEOF;
+	if (f->flags & F_STATIC) {
+		/*
+		 * It stays on the list, so it can't keep the fd: the number
+		 * may be reused by the next open(). Reads and writes fail
+		 * with EBADF from now on.
+		 */
+		f->fd = -1;
+		f->flags = F_STATIC | F_CLOSED;
+		pthread_mutex_unlock(&f->lock);
+		return ret;
+	}
+	pthread_mutex_unlock(&f->lock);
+
+	pthread_mutex_lock(&jfile_list_lock);
+	if (f->prev)
+		f->prev->next = f->next;
+	else
+		jfile_list = f->next;
+	if (f->next)
+		f->next->prev = f->prev;
+	pthread_mutex_unlock(&jfile_list_lock);
+
+	jfree(f->rbuf);
+	for (int i = 0; i < QUEUE; i++)
+		jfree(f->wbuf[i]);
+	pthread_mutex_destroy(&f->lock);
+	jfree(f);
+	return ret;
+}
+
+int jfileno(jFILE *f)
+{
+	return f->fd;
+}
+
+/*
+ * Gives back what was read ahead, by seeking back over it. Where the file
+ * can't seek (a pipe, a socket, a terminal) it's kept for the next read
+ * instead, those don't share a position between reading and writing.
+ */
+static void unread(jFILE *f)
+{
+	off_t ahead = (off_t)(f->rend - f->rpos);
+
+	if (ahead && lseek(f->fd, -ahead, SEEK_CUR) < 0)
+		return;
+	f->rpos = 0;
+	f->rend = 0;
+}
+
+bool jfile_reading(jFILE *f)
+{
+	if (!(f->flags & F_READ)) {
+		f->flags |= F_ERR;
+		errno = EBADF;
+		return false;
+	}
+	if (f->flags & F_READING)
+		return true;
+	if ((f->wcur || f->wpos) && jfile_drain(f, NULL, 0))
+		return false;
+	f->flags |= F_READING;
+	return true;
+}
+
+bool jfile_writing(jFILE *f)
+{
+	if (!(f->flags & F_WRITE)) {
+		f->flags |= F_ERR;
+		errno = EBADF;
+		return false;
+	}
+	if (f->flags & F_READING) {
+		unread(f);
+		f->flags &= ~F_READING;
+	}
+	return true;
+}
+
+int jfflush_unlocked(jFILE *f)
+{
+	if (f->flags & F_CLOSED) {
+		errno = EBADF;
+		return JEOF;
+	}
+	if (f->flags & F_READING) {
+		unread(f);
+		return 0;
+	}
+	if ((f->wcur || f->wpos) && jfile_drain(f, NULL, 0))
+		return JEOF;
+	return 0;
+}
+
+int jfflush(jFILE *f)
+{
+	int ret = 0;
+
+	if (f) {
+		pthread_mutex_lock(&f->lock);
+		ret = jfflush_unlocked(f);
+		pthread_mutex_unlock(&f->lock);
+		return ret;
+	}
+	/* every output stream, input ones keep what they read ahead */
+	pthread_mutex_lock(&jfile_list_lock);
+	for (f = jfile_list; f; f = f->next) {
+		pthread_mutex_lock(&f->lock);
+		if (!(f->flags & (F_READING | F_CLOSED)) &&
+		    jfflush_unlocked(f))
+			ret = JEOF;
+		pthread_mutex_unlock(&f->lock);
+	}
+	pthread_mutex_unlock(&jfile_list_lock);
+	return ret;
+}
+
+__attribute__((destructor)) static void flush_at_exit(void)
+{
+	jfflush(NULL);
+}
+
+int jfeof(jFILE *f)
+{
+	return !!(f->flags & F_EOF);
+}
+
+int jferror(jFILE *f)
+{
+	return !!(f->flags & F_ERR);
+}
+
+void jclearerr(jFILE *f)
+{
+	pthread_mutex_lock(&f->lock);
+	f->flags &= ~(F_EOF | F_ERR);
+	pthread_mutex_unlock(&f->lock);
+}
+
+void jflockfile(jFILE *f)
+{
+	pthread_mutex_lock(&f->lock);
+}
+
+void jfunlockfile(jFILE *f)
+{
+	pthread_mutex_unlock(&f->lock);
+}
@@ -0,0 +1,249 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jfile.h"
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static char *buffer(jFILE *f)
+{
+	if (!f->rbuf && !(f->rbuf = jaligned_alloc(PAGE, JBUFSIZ)))
+		f->flags |= F_ERR;
+	return f->rbuf;
+}
+
+/* sets the flag a read of r bytes calls for, false if it got nothing */
+static bool got(jFILE *f, ssize_t r)
+{
+	if (r > 0)
+		return true;
+	f->flags |= r ? F_ERR : F_EOF;
+	return false;
+}
+
+/* reads the next buffer's worth, false at end of file or on an error */
+static bool refill(jFILE *f)
+{
+	ssize_t r;
+
+	if ((f->flags & F_EOF) || !buffer(f))
+		return false;
+	/* a prompt on a terminal should be out before we wait for input */
+	if (f == jstdin && (jstdout->flags & F_LINE))
+		jfflush(jstdout);
+	do
+		r = read(f->fd, f->rbuf, JBUFSIZ);
+	while (r < 0 && errno == EINTR);
+	if (!got(f, r))
+		return false;
+	f->rpos = 0;
+	f->rend = (size_t)r;
+	return true;
+}
+
+/* reads up to n bytes from f into dst, returns how many it got */
+static size_t get(jFILE *f, char *dst, size_t n)
+{
+	size_t done = 0;
+	size_t k;
+	ssize_t r;
+
+	if (!jfile_reading(f))
+		return 0;
+	while (done < n) {
+		k = f->rend - f->rpos;
+		if (k) {
+			if (k > n - done)
+				k = n - done;
+			jmemcpy(dst + done, f->rbuf + f->rpos, k);
+			f->rpos += k;
+			done += k;
+		} else if (n - done >= JBUFSIZ) {
+			/* straight into dst, with the buffer topped up too */
+			struct iovec iov[2] = {
+				{ dst + done, n - done },
+				{ buffer(f), JBUFSIZ },
+			};
+
+			if (!iov[1].iov_base || (f->flags & F_EOF))
+				break;
+			do
+				r = readv(f->fd, iov, 2);
+			while (r < 0 && errno == EINTR);
+			if (!got(f, r))
+				break;
+			if ((size_t)r <= n - done) {
+				done += (size_t)r;
+			} else {
+				f->rpos = 0;
+				f->rend = (size_t)r - (n - done);
+				done = n;
+			}
+		} else if (!refill(f)) {
+			break;
+		}
+	}
+	return done;
+}
+
+size_t jfread_unlocked(void *restrict ptr, size_t size, size_t nmemb,
+		       jFILE *restrict f)
+{
+	size_t n;
+
+	if (__builtin_mul_overflow(size, nmemb, &n)) {
+		f->flags |= F_ERR;
+		errno = EOVERFLOW;
+		return 0;
+	}
+	if (n == 0)
+		return 0;
+	return get(f, ptr, n) / size;
+}
+
+int jfgetc_unlocked(jFILE *f)
+{
+	unsigned char c;
+
+	if ((f->flags & F_READING) && f->rpos < f->rend)
+		return (unsigned char)f->rbuf[f->rpos++];
+	return get(f, (char *)&c, 1) ? c : JEOF;
+}
+
+/*
+ * How much of what's buffered belongs to the current line, at most max
+ * bytes, refilling first if nothing is. *nl is set when it ends the line.
+ * 0 at end of file or on an error.
+ */
+static size_t line_part(jFILE *f, size_t max, bool *nl)
+{
+	size_t k;
+	char *p;
+
+	if (f->rpos == f->rend && !refill(f))
+		return 0;
+	k = f->rend - f->rpos;
+	if (k > max)
+		k = max;
+	p = memchr(f->rbuf + f->rpos, '\n', k);
+	*nl = p != NULL;
+	return p ? (size_t)(p - (f->rbuf + f->rpos)) + 1 : k;
+}
+
+char *jfgets_unlocked(char *restrict s, int size, jFILE *restrict f)
+{
+	int err = f->flags & F_ERR;
+	size_t done = 0;
+	size_t k;
+	bool nl = false;
+
+	if (size <= 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (!jfile_reading(f))
+		return NULL;
+	while (!nl && done < (size_t)size - 1 &&
+	       (k = line_part(f, (size_t)size - 1 - done, &nl))) {
+		jmemcpy(s + done, f->rbuf + f->rpos, k);
+		f->rpos += k;
+		done += k;
+	}
+	if ((done == 0 && size > 1) || (f->flags & F_ERR) != err)
+		return NULL;
+	s[done] = '\0';
+	return s;
+}
+
+ssize_t jgetline_unlocked(char **restrict lineptr, size_t *restrict n,
+			  jFILE *restrict f)
+{
+	int err = f->flags & F_ERR;
+	size_t len = 0;
+	size_t k;
+	bool nl = false;
+	char *line;
+
+	if (!lineptr || !n) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (!*lineptr)
+		*n = 0;
+	if (!jfile_reading(f))
+		return -1;
+	while (!nl && (k = line_part(f, SIZE_MAX, &nl))) {
+		if (!(line = jgrow(*lineptr, n, len + k + 1, 1))) {
+			f->flags |= F_ERR;
+			return -1;
+		}
+		*lineptr = line;
+		jmemcpy(line + len, f->rbuf + f->rpos, k);
+		f->rpos += k;
+		len += k;
+	}
+	if (len == 0 || (f->flags & F_ERR) != err)
+		return -1;
+	(*lineptr)[len] = '\0';
+	return (ssize_t)len;
+}
+
+size_t jfread(void *restrict ptr, size_t size, size_t nmemb,
+	      jFILE *restrict f)
+{
+	size_t ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfread_unlocked(ptr, size, nmemb, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
+
+int jfgetc(jFILE *f)
+{
+	int ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfgetc_unlocked(f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
+
+char *jfgets(char *restrict s, int size, jFILE *restrict f)
+{
+	char *ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfgets_unlocked(s, size, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
+
+ssize_t jgetline(char **restrict lineptr, size_t *restrict n,
+		 jFILE *restrict f)
+{
+	ssize_t ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jgetline_unlocked(lineptr, n, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
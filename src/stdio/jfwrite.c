@@ -0,0 +1,183 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jfile.h"
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* the buffer being filled, allocated on first use */
+static char *current(jFILE *f)
+{
+	char **b = &f->wbuf[f->wcur];
+
+	if (*b)
+		return *b;
+	if (f->flags & F_TTY) {
+		if (isatty(f->fd))
+			f->flags |= F_LINE;
+		f->flags &= ~F_TTY;
+	}
+	if (!(*b = jaligned_alloc(PAGE, JBUFSIZ)))
+		f->flags |= F_ERR;
+	return *b;
+}
+
+size_t jfile_drain(jFILE *f, const void *p, size_t n)
+{
+	struct iovec iov[QUEUE + 1];
+	struct iovec *v = iov;
+	int cnt = 0;
+	size_t left = f->wcur * JBUFSIZ + f->wpos + n;
+	ssize_t r;
+
+	for (size_t i = 0; i < f->wcur; i++)
+		iov[cnt++] = (struct iovec){ f->wbuf[i], JBUFSIZ };
+	if (f->wpos)
+		iov[cnt++] = (struct iovec){ f->wbuf[f->wcur], f->wpos };
+	if (n)
+		iov[cnt++] = (struct iovec){ (void *)p, n };
+	f->wcur = 0;
+	f->wpos = 0;
+
+	while (cnt) {
+		r = writev(f->fd, v, cnt);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0) {
+			f->flags |= F_ERR;
+			break;
+		}
+		left -= (size_t)r;
+		/* a short write, go on from where it stopped */
+		while (cnt && (size_t)r >= v->iov_len) {
+			r -= (ssize_t)v->iov_len;
+			v++;
+			cnt--;
+		}
+		if (cnt) {
+			v->iov_base = (char *)v->iov_base + r;
+			v->iov_len -= (size_t)r;
+		}
+	}
+	return left;
+}
+
+/*
+ * Writes n bytes from p to f, returns how many were taken. When a drain
+ * fails, what it lost is counted against the last bytes queued, these.
+ */
+static size_t put(jFILE *f, const char *p, size_t n)
+{
+	size_t done = 0;
+	size_t k;
+	char *b;
+
+	if (!jfile_writing(f))
+		return 0;
+	/* too big to be worth copying, it goes out with what's queued */
+	if (n >= JBUFSIZ || (f->flags & F_UNBUF)) {
+		k = jfile_drain(f, p, n);
+		return n - (k < n ? k : n);
+	}
+	while (done < n && (b = current(f))) {
+		k = JBUFSIZ - f->wpos;
+		if (k > n - done)
+			k = n - done;
+		jmemcpy(b + f->wpos, p + done, k);
+		f->wpos += k;
+		done += k;
+		if (f->wpos == JBUFSIZ) {
+			f->wpos = 0;
+			if (++f->wcur == QUEUE && (k = jfile_drain(f, NULL, 0)))
+				return done - (k < done ? k : done);
+		}
+	}
+	if ((f->flags & F_LINE) && memchr(p, '\n', done) &&
+	    (k = jfile_drain(f, NULL, 0)))
+		done -= k < done ? k : done;
+	return done;
+}
+
+size_t jfwrite_unlocked(const void *restrict ptr, size_t size, size_t nmemb,
+			jFILE *restrict f)
+{
+	size_t n;
+
+	if (__builtin_mul_overflow(size, nmemb, &n)) {
+		f->flags |= F_ERR;
+		errno = EOVERFLOW;
+		return 0;
+	}
+	if (n == 0)
+		return 0;
+	return put(f, ptr, n) / size;
+}
+
+int jfputs_unlocked(const char *restrict s, jFILE *restrict f)
+{
+	size_t n = jstrlen(s);
+
+	return put(f, s, n) == n ? 0 : JEOF;
+}
+
+int jfputc_unlocked(int c, jFILE *f)
+{
+	unsigned char ch = (unsigned char)c;
+	char *b = f->wbuf[f->wcur];
+
+	/* room to spare and nothing to flush for, the usual case */
+	if (b && f->wpos < JBUFSIZ - 1 &&
+	    !(f->flags & (F_READING | F_UNBUF | F_LINE))) {
+		b[f->wpos++] = (char)ch;
+		return ch;
+	}
+	return put(f, (const char *)&ch, 1) ? ch : JEOF;
+}
+
+size_t jfwrite(const void *restrict ptr, size_t size, size_t nmemb,
+	       jFILE *restrict f)
+{
+	size_t ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfwrite_unlocked(ptr, size, nmemb, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
+
+int jfputs(const char *restrict s, jFILE *restrict f)
+{
+	int ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfputs_unlocked(s, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
+
+int jfputc(int c, jFILE *f)
+{
+	int ret;
+
+	pthread_mutex_lock(&f->lock);
+	ret = jfputc_unlocked(c, f);
+	pthread_mutex_unlock(&f->lock);
+	return ret;
+}
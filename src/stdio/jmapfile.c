@@ -0,0 +1,169 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+
+#include "jstdio.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BLOCK 64
+
+typedef uint64_t __attribute__((may_alias, aligned(1))) u64u;
+
+/*
+ * The first c in [p, end), NULL if there's none. Nothing outside of it is
+ * loaded, the end of the mapping may well be the end of its last page.
+ *
+ * SSE2 compares a block of four vectors at once and only looks for where
+ * the match is once the block has one. Without it, words with no c in them
+ * are skipped eight bytes at a time, x being zero where the word has c:
+ * (x - 0x01..) & ~x & 0x80.. isn't zero exactly when some byte of x is.
+ */
+static const char *find(const char *p, const char *end, char c)
+{
+#if defined(__SSE2__)
+	__m128i cc = _mm_set1_epi8(c);
+
+	for (; end - p >= BLOCK; p += BLOCK) {
+		__m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), cc);
+		__m128i e1 = _mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)(p + 16)), cc);
+		__m128i e2 = _mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)(p + 32)), cc);
+		__m128i e3 = _mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)(p + 48)), cc);
+		uint64_t bits;
+
+		if (!_mm_movemask_epi8(
+			    _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3))))
+			continue;
+		bits = (uint64_t)(unsigned)_mm_movemask_epi8(e0) |
+		       (uint64_t)(unsigned)_mm_movemask_epi8(e1) << 16 |
+		       (uint64_t)(unsigned)_mm_movemask_epi8(e2) << 32 |
+		       (uint64_t)(unsigned)_mm_movemask_epi8(e3) << 48;
+		return p + __builtin_ctzll(bits);
+	}
+	for (; end - p >= 16; p += 16) {
+		int bits = _mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), cc));
+
+		if (bits)
+			return p + __builtin_ctz((unsigned)bits);
+	}
+#else
+	const uint64_t ones = 0x0101010101010101ULL;
+	uint64_t cc = ones * (unsigned char)c;
+
+	for (; end - p >= 8; p += 8) {
+		uint64_t x = *(const u64u *)p ^ cc;
+
+		if ((x - ones) & ~x & (ones << 7))
+			break;
+	}
+#endif
+	for (; p < end; p++) {
+		if (*p == c)
+			return p;
+	}
+	return NULL;
+}
+
+int jmapfile_fdopen(jmapfile *m, int fd)
+{
+	struct stat st;
+	void *p;
+
+	*m = (jmapfile){ 0 };
+	if (fstat(fd, &st) < 0)
+		return -1;
+	if (!S_ISREG(st.st_mode)) {
+		errno = S_ISDIR(st.st_mode) ? EISDIR : ENODEV;
+		return -1;
+	}
+	if ((uintmax_t)st.st_size > SIZE_MAX) {
+		errno = EFBIG;
+		return -1;
+	}
+	/* mmap() takes no empty mappings, and an empty file needs none */
+	if (st.st_size == 0)
+		return 0;
+	p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		return -1;
+	/* only advice: a kernel that doesn't take it reads the file all the same */
+	madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+	madvise(p, (size_t)st.st_size, MADV_WILLNEED);
+	m->data = p;
+	m->size = (size_t)st.st_size;
+	return 0;
+}
+
+int jmapfile_open(jmapfile *m, const char *path)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	int ret;
+	int err;
+
+	if (fd < 0) {
+		*m = (jmapfile){ 0 };
+		return -1;
+	}
+	ret = jmapfile_fdopen(m, fd);
+	err = errno;
+	close(fd); /* the mapping stays */
+	errno = err;
+	return ret;
+}
+
+bool jmapfile_next(jmapfile *restrict m, int delim, const char **restrict p,
+		   size_t *restrict len)
+{
+	const char *s;
+	const char *end;
+	const char *q;
+
+	/* an empty file has no data to add pos to */
+	if (m->pos >= m->size)
+		return false;
+	s = m->data + m->pos;
+	end = m->data + m->size;
+	q = find(s, end, (char)delim);
+	*p = s;
+	if (q) {
+		*len = (size_t)(q - s);
+		m->pos += *len + 1;
+	} else {
+		/* the last record, with no delim after it */
+		*len = (size_t)(end - s);
+		m->pos = m->size;
+	}
+	return true;
+}
+
+int jmapfile_close(jmapfile *m)
+{
+	int ret = m->data ? munmap((void *)m->data, m->size) : 0;
+
+	*m = (jmapfile){ 0 };
+	return ret;
+}
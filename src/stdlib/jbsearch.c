@@ -0,0 +1,54 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstdlib.h"
+#include <stdint.h>
+
+/*
+ * Branchless lower bound: each step keeps the lower or the upper half by
+ * adding 0 or half of it to the base, so there is nothing to mispredict,
+ * and the two places the next step can look at are prefetched while the
+ * comparator runs. Past the cache, that overlaps the misses of two steps.
+ */
+void *jlower_bound(const void *key, const void *base, size_t nmemb,
+		   size_t size, int (*compar)(const void *, const void *))
+{
+	const char *p = base;
+	size_t n = nmemb;
+
+	if (n == 0)
+		return (void *)p;
+	while (n > 1) {
+		size_t half = n / 2;
+		size_t next = (n - half) / 2;
+
+		__builtin_prefetch(p + next * size);
+		__builtin_prefetch(p + (half + next) * size);
+		p += (size_t)(compar(key, p + half * size) > 0) * half * size;
+		n -= half;
+	}
+	return (void *)(p + (compar(key, p) > 0) * size);
+}
+
+void *jbsearch(const void *key, const void *base, size_t nmemb, size_t size,
+	       int (*compar)(const void *, const void *))
+{
+	const char *p = jlower_bound(key, base, nmemb, size, compar);
+
+	if (p == (const char *)base + nmemb * size || compar(key, p) != 0)
+		return NULL;
+	return (void *)p;
+}
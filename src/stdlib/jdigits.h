@@ -0,0 +1,161 @@
+#if !defined(__JDIGITS_H)
+# define __JDIGITS_H
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * What the number parsers and printers share. The parsers all take the end
+ * of their input as a pointer, NULL for a string that ends in '\0'.
+ */
+
+#include "jstring.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PAGE 4096 /* the smallest page size there is */
+
+/* the byte at p, 0 at the end */
+static inline unsigned char peek(const char *p, const char *end)
+{
+	return p != end ? (unsigned char)*p : 0;
+}
+
+static inline bool space(unsigned char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/*
+ * How many bytes from p on can be read. Past the '\0' of a string that is
+ * as far as its page goes, nothing smaller than a page can be unmapped.
+ */
+static inline size_t room(const char *p, const char *end)
+{
+	return end ? (size_t)(end - p) : PAGE - ((uintptr_t)p & (PAGE - 1));
+}
+
+/*
+ * Eight digits a load. Adding 0x46 to a byte sets its top bit above '9',
+ * subtracting 0x30 does below '0', so a word is all digits when neither
+ * does in any byte.
+ */
+static inline uint64_t load8(const char *p)
+{
+	uint64_t v;
+
+	jmemcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+static inline bool eight_digits(uint64_t v)
+{
+	return (((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) &
+		0x8080808080808080ULL) == 0;
+}
+
+/*
+ * Joins the digits pairwise, then the pairs, then the fours: three
+ * multiplies for the eight of them. The first digit is in the low byte.
+ */
+static inline uint32_t parse_eight(uint64_t v)
+{
+	const uint64_t mask = 0x000000ff000000ffULL;
+	const uint64_t mul1 = 100 + (1000000ULL << 32);
+	const uint64_t mul2 = 1 + (10000ULL << 32);
+
+	v -= 0x3030303030303030ULL;
+	v = v * 10 + (v >> 8);
+	return (uint32_t)(((v & mask) * mul1 + ((v >> 16) & mask) * mul2) >>
+			  32);
+}
+
+/* And the way back: "00" to "99", two digits a store */
+static const char pairs[200] = "00010203040506070809"
+			       "10111213141516171819"
+			       "20212223242526272829"
+			       "30313233343536373839"
+			       "40414243444546474849"
+			       "50515253545556575859"
+			       "60616263646566676869"
+			       "70717273747576777879"
+			       "80818283848586878889"
+			       "90919293949596979899";
+
+static const uint64_t tens[20] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+/* how many digits v has; 1233/4096 is a hair over log10(2) */
+static inline unsigned ndigits(uint64_t v)
+{
+	unsigned t = (64 - __builtin_clzll(v | 1)) * 1233 >> 12;
+
+	return t + ((v | 1) >= tens[t]);
+}
+
+/*
+ * Writes the n digits of v to p, from the right. The eight-digit chunks
+ * below the top one are cut off in 64 bits, the rest is done in 32.
+ */
+static inline char *put_digits(char *p, uint64_t v, unsigned n)
+{
+	char *q = p + n;
+	uint32_t w;
+
+	while (v >= 100000000) {
+		w = (uint32_t)(v % 100000000);
+		v /= 100000000;
+		for (int i = 0; i < 4; i++, w /= 100) {
+			q -= 2;
+			jmemcpy(q, pairs + w % 100 * 2, 2);
+		}
+	}
+	for (w = (uint32_t)v; w >= 100; w /= 100) {
+		q -= 2;
+		jmemcpy(q, pairs + w % 100 * 2, 2);
+	}
+	if (w >= 10) {
+		q -= 2;
+		jmemcpy(q, pairs + w * 2, 2);
+	} else {
+		*--q = (char)('0' + w);
+	}
+	return p + n;
+}
+
+#endif /* __JDIGITS_H */
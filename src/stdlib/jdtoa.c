@@ -0,0 +1,184 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * Shortest round trip formatting with Schubfach (Giulietti, "The Schubfach
+ * way to render doubles"), Ryu's simpler cousin. The interval of reals that
+ * read back as the double is scaled by one 128-bit power of ten so that it
+ * holds one or two integers; the shortest of them, closest to the double
+ * when there's a choice, is the answer. Three products and no loop, where
+ * printf("%.17g") does big number arithmetic and still isn't the shortest.
+ */
+
+#include "jstdlib.h"
+#include "jdigits.h"
+#include "jpow10.h"
+
+#define MANT 52 /* mantissa bits, not counting the implicit one */
+#define BIAS 1075 /* the exponent bias, the mantissa taken as an integer */
+#define INF_EXP 0x7ff
+
+/* floor(log10(2^e)), floor(log10(3/4 * 2^e)) and floor(log2(10^e)) */
+static inline int log10_pow2(int e)
+{
+	return (e * 1262611) >> 22;
+}
+
+static inline int log10_three_quarters_pow2(int e)
+{
+	return (e * 1262611 - 524031) >> 22;
+}
+
+static inline int log2_pow10(int e)
+{
+	return (e * 1741647) >> 19;
+}
+
+/*
+ * The top 64 bits of the 192-bit g * cp, with the lowest one set when any
+ * of the rest is. That's all the rounding Schubfach needs to tell the ends
+ * of the interval apart from the integers.
+ */
+static inline uint64_t round_to_odd(const uint64_t g[2], uint64_t cp)
+{
+	__uint128_t x = (__uint128_t)g[1] * cp;
+	__uint128_t y = (__uint128_t)g[0] * cp;
+	uint64_t mid = (uint64_t)y + (uint64_t)(x >> 64);
+	uint64_t hi = (uint64_t)(y >> 64) + (mid < (uint64_t)y);
+
+	return hi | (mid > 1);
+}
+
+/* the shortest s * 10^*k that reads back as the double m, e */
+static uint64_t shortest(uint64_t m, int e, int *k)
+{
+	uint64_t c = m;
+	int q = 1 - BIAS;
+
+	*k = 0;
+	if (e) {
+		c |= 1ULL << MANT;
+		q = e - BIAS;
+		/* integers are exact */
+		if (q <= 0 && q > -MANT - 1 && !(c & ((1ULL << -q) - 1)))
+			return c >> -q;
+	}
+
+	bool even = !(c & 1);
+	/* at a power of two, the next double down is half as far */
+	bool closer = m == 0 && e > 1;
+	*k = closer ? log10_three_quarters_pow2(q) : log10_pow2(q);
+
+	/* c * 2^q * 10^-k times 4, ends of the interval included */
+	const uint64_t *g = pow10[-*k - POW10_MIN];
+	int h = q + log2_pow10(-*k) + 1;
+	uint64_t vbl = round_to_odd(g, (4 * c - 2 + closer) << h);
+	uint64_t vb = round_to_odd(g, 4 * c << h);
+	uint64_t vbr = round_to_odd(g, (4 * c + 2) << h);
+	uint64_t lower = vbl + !even;
+	uint64_t upper = vbr - !even;
+	uint64_t s = vb / 4;
+
+	/* one digit less, if either neighbour of the ten is in */
+	if (s >= 10) {
+		uint64_t sp = s / 10;
+		bool up = lower <= 40 * sp;
+		bool wp = 40 * sp + 40 <= upper;
+
+		if (up != wp) {
+			++*k;
+			return sp + wp;
+		}
+	}
+
+	bool u = lower <= 4 * s;
+	bool w = 4 * s + 4 <= upper;
+
+	if (u != w)
+		return s + w;
+	/* both in, the nearer wins, ties to even */
+	return s + (vb > 4 * s + 2 || (vb == 4 * s + 2 && (s & 1)));
+}
+
+/*
+ * Lays the digits out the way JavaScript does: plainly from 1e-6 up to 1e21,
+ * "1.5e+300" outside of that.
+ */
+static char *format(char *p, uint64_t s, int k)
+{
+	unsigned n;
+	int point;
+
+	while (s % 10 == 0) {
+		s /= 10;
+		k++;
+	}
+	n = ndigits(s);
+	point = k + (int)n; /* the digits are 0.ddd * 10^point */
+
+	if ((int)n <= point && point <= 21) {
+		p = put_digits(p, s, n);
+		jmemset(p, '0', point - n);
+		p += point - n;
+	} else if (point > 0 && point <= 21) {
+		put_digits(p + 1, s, n);
+		jmemmove(p, p + 1, point);
+		p[point] = '.';
+		p += n + 1;
+	} else if (point > -6 && point <= 0) {
+		*p++ = '0';
+		*p++ = '.';
+		jmemset(p, '0', -point);
+		p = put_digits(p - point, s, n);
+	} else {
+		put_digits(p + 1, s, n);
+		p[0] = p[1];
+		if (n > 1)
+			p[1] = '.';
+		p += n + (n > 1);
+		*p++ = 'e';
+		*p++ = point > 0 ? '+' : '-';
+		point = point > 0 ? point - 1 : 1 - point;
+		p = put_digits(p, point, ndigits(point));
+	}
+	return p;
+}
+
+char *jdtoa(char *dst, double d)
+{
+	uint64_t bits;
+	uint64_t m;
+	int e;
+	int k;
+
+	jmemcpy(&bits, &d, sizeof(bits));
+	m = bits & ((1ULL << MANT) - 1);
+	e = (int)(bits >> MANT) & INF_EXP;
+	if (bits >> 63)
+		*dst++ = '-';
+	if (e == INF_EXP) {
+		jmemcpy(dst, m ? "nan" : "inf", 4);
+		return dst + 3;
+	}
+	if (e == 0 && m == 0) {
+		jmemcpy(dst, "0", 2);
+		return dst + 1;
+	}
+	m = shortest(m, e, &k);
+	dst = format(dst, m, k);
+	*dst = '\0';
+	return dst;
+}
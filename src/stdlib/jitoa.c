@@ -0,0 +1,36 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstdlib.h"
+#include "jdigits.h"
+
+char *jutoa(char *dst, unsigned long long v)
+{
+	char *p = put_digits(dst, v, ndigits(v));
+
+	*p = '\0';
+	return p;
+}
+
+char *jitoa(char *dst, long long v)
+{
+	/* the magnitude of LLONG_MIN only fits unsigned */
+	if (v < 0) {
+		*dst++ = '-';
+		return jutoa(dst, -(unsigned long long)v);
+	}
+	return jutoa(dst, (unsigned long long)v);
+}
@@ -0,0 +1,452 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * Pattern-defeating quicksort (Peters, "pdqsort"), for elements that are
+ * only ever seen through a size and a comparator:
+ *
+ *	- fewer than INSERTION elements are insertion sorted;
+ *	- the pivot is the median of three, of three medians of three above
+ *	  NINTHER elements;
+ *	- partitioning is by blocks (Edelkamp and Weiß, "BlockQuicksort"): the
+ *	  comparisons of a block only record offsets, so their outcome never
+ *	  decides a branch, and the swaps are done afterwards;
+ *	- runs of a pivot's equals go to the left partition in one go, sorted
+ *	  input is caught by a bounded insertion sort, and too many lopsided
+ *	  partitions shuffle the elements, then fall back to heapsort.
+ *
+ * The whole sort is one inline function, instantiated for 4, 8 and 16 byte
+ * elements so their swaps are single loads and stores, and once for any
+ * other size.
+ */
+
+#include "jstdlib.h"
+#include "jstring.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define INSERTION 24	   /* below this many, insertion sort */
+#define NINTHER 128	   /* above this many, the pivot is a ninther */
+#define PARTIAL_MOVES 8	   /* shifts allowed to sorting that looks sorted */
+#define BLOCK 64	   /* offsets buffered by the block partition */
+#define STACK 64	   /* half of what's left each push, 2^64 is enough */
+
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+/* a partition left for later */
+struct part {
+	char *begin;
+	char *end;
+	int bad; /* lopsided partitions left before heapsort */
+	bool leftmost;
+};
+
+struct order {
+	int (*cmp)(const void *, const void *);
+	int (*cmp_r)(const void *, const void *, void *);
+	void *arg;
+};
+
+ALWAYS_INLINE bool less(const struct order *o, const char *a, const char *b)
+{
+	return (o->cmp_r ? o->cmp_r(a, b, o->arg) : o->cmp(a, b)) < 0;
+}
+
+ALWAYS_INLINE void swap(char *a, char *b, size_t size)
+{
+	if (size == 4) {
+		uint32_t x, y;
+
+		jmemcpy(&x, a, 4);
+		jmemcpy(&y, b, 4);
+		jmemcpy(a, &y, 4);
+		jmemcpy(b, &x, 4);
+	} else if (size == 8) {
+		uint64_t x, y;
+
+		jmemcpy(&x, a, 8);
+		jmemcpy(&y, b, 8);
+		jmemcpy(a, &y, 8);
+		jmemcpy(b, &x, 8);
+	} else if (size == 16) {
+		uint64_t x[2], y[2];
+
+		jmemcpy(x, a, 16);
+		jmemcpy(y, b, 16);
+		jmemcpy(a, y, 16);
+		jmemcpy(b, x, 16);
+	} else {
+		uint64_t x, y;
+		char t;
+
+		for (; size >= 8; size -= 8, a += 8, b += 8) {
+			jmemcpy(&x, a, 8);
+			jmemcpy(&y, b, 8);
+			jmemcpy(a, &y, 8);
+			jmemcpy(b, &x, 8);
+		}
+		for (; size; size--, a++, b++) {
+			t = *a;
+			*a = *b;
+			*b = t;
+		}
+	}
+}
+
+ALWAYS_INLINE void sort2(char *a, char *b, size_t size, const struct order *o)
+{
+	if (less(o, b, a))
+		swap(a, b, size);
+}
+
+ALWAYS_INLINE void sort3(char *a, char *b, char *c, size_t size,
+			 const struct order *o)
+{
+	sort2(a, b, size, o);
+	sort2(b, c, size, o);
+	sort2(a, b, size, o);
+}
+
+ALWAYS_INLINE void insertion(char *begin, char *end, size_t size,
+			     const struct order *o)
+{
+	for (char *cur = begin + size; cur < end; cur += size)
+		for (char *p = cur; p > begin && less(o, p, p - size); p -= size)
+			swap(p, p - size, size);
+}
+
+/* insertion sort that gives up after PARTIAL_MOVES shifts, false if it did */
+ALWAYS_INLINE bool partial_insertion(char *begin, char *end, size_t size,
+				     const struct order *o)
+{
+	size_t moves = 0;
+
+	for (char *cur = begin + size; cur < end; cur += size) {
+		char *p = cur;
+
+		for (; p > begin && less(o, p, p - size); p -= size)
+			swap(p, p - size, size);
+		moves += (size_t)(cur - p) / size;
+		if (moves > PARTIAL_MOVES)
+			return false;
+	}
+	return true;
+}
+
+/* moves begin[j] down the heap of the n elements from begin */
+ALWAYS_INLINE void sift(char *begin, size_t j, size_t n, size_t size,
+			const struct order *o)
+{
+	for (size_t c; (c = 2 * j + 1) < n; j = c) {
+		if (c + 1 < n &&
+		    less(o, begin + c * size, begin + (c + 1) * size))
+			c++;
+		if (!less(o, begin + j * size, begin + c * size))
+			return;
+		swap(begin + j * size, begin + c * size, size);
+	}
+}
+
+ALWAYS_INLINE void heapsort(char *begin, size_t n, size_t size,
+			    const struct order *o)
+{
+	for (size_t i = n / 2; i-- > 0;)
+		sift(begin, i, n, size, o);
+	while (n-- > 1) {
+		swap(begin, begin + n * size, size);
+		sift(begin, 0, n, size, o);
+	}
+}
+
+/*
+ * Puts the pivot at begin between the elements less than it and the ones
+ * that aren't, and returns where it went. *sorted is set when nothing had
+ * to move. There is an element no less than the pivot at end - size, and
+ * unless begin is leftmost one no greater before begin, to stop the scans.
+ */
+ALWAYS_INLINE char *partition_right(char *begin, char *end, size_t size,
+				    const struct order *o, bool *sorted)
+{
+	unsigned char offsets_l[BLOCK];
+	unsigned char offsets_r[BLOCK];
+	char *first = begin;
+	char *last = end;
+
+	do
+		first += size;
+	while (less(o, first, begin));
+	if (first - size == begin) {
+		do
+			last -= size;
+		while (first < last && !less(o, last, begin));
+	} else {
+		do
+			last -= size;
+		while (!less(o, last, begin));
+	}
+
+	*sorted = first >= last;
+	if (!*sorted) {
+		char *base_l;
+		char *base_r;
+		size_t num_l = 0;
+		size_t num_r = 0;
+		size_t start_l = 0;
+		size_t start_r = 0;
+
+		swap(first, last, size);
+		first += size;
+		base_l = first;
+		base_r = last;
+		/*
+		 * Elements on the left that belong right and the other way
+		 * round are counted without a branch, a block a side at a
+		 * time, and swapped pairwise as long as both sides have some.
+		 */
+		while (first < last) {
+			size_t unknown = (size_t)(last - first) / size;
+			size_t split_l = num_l ? 0 : num_r ? unknown
+							  : unknown / 2;
+			size_t split_r = num_r ? 0 : unknown - split_l;
+			size_t num;
+
+			if (split_l > BLOCK)
+				split_l = BLOCK;
+			for (size_t i = 0; i < split_l; i++) {
+				offsets_l[num_l] = (unsigned char)i;
+				num_l += !less(o, first, begin);
+				first += size;
+			}
+			if (split_r > BLOCK)
+				split_r = BLOCK;
+			for (size_t i = 0; i < split_r; i++) {
+				last -= size;
+				offsets_r[num_r] = (unsigned char)i;
+				num_r += less(o, last, begin);
+			}
+
+			num = num_l < num_r ? num_l : num_r;
+			for (size_t i = 0; i < num; i++)
+				swap(base_l + offsets_l[start_l + i] * size,
+				     base_r - (offsets_r[start_r + i] + 1) * size,
+				     size);
+			num_l -= num;
+			num_r -= num;
+			start_l += num;
+			start_r += num;
+			if (num_l == 0) {
+				start_l = 0;
+				base_l = first;
+			}
+			if (num_r == 0) {
+				start_r = 0;
+				base_r = last;
+			}
+		}
+
+		/* one side has leftovers, they go next to the middle */
+		while (num_l) {
+			last -= size;
+			swap(base_l + offsets_l[start_l + --num_l] * size, last,
+			     size);
+			first = last;
+		}
+		while (num_r) {
+			swap(base_r - (offsets_r[start_r + --num_r] + 1) * size,
+			     first, size);
+			first += size;
+		}
+	}
+
+	swap(begin, first - size, size);
+	return first - size;
+}
+
+/*
+ * The other way round, for a pivot equal to the element before begin:
+ * everything equal to it goes left, the rest right.
+ */
+ALWAYS_INLINE char *partition_left(char *begin, char *end, size_t size,
+				   const struct order *o)
+{
+	char *first = begin;
+	char *last = end;
+
+	do
+		last -= size;
+	while (less(o, begin, last));
+	if (last + size == end) {
+		do
+			first += size;
+		while (first < last && !less(o, begin, first));
+	} else {
+		do
+			first += size;
+		while (!less(o, begin, first));
+	}
+
+	while (first < last) {
+		swap(first, last, size);
+		do
+			last -= size;
+		while (less(o, begin, last));
+		do
+			first += size;
+		while (!less(o, begin, first));
+	}
+
+	swap(begin, last, size);
+	return last;
+}
+
+/* breaks up a pattern by swapping the ends with elements a quarter in */
+ALWAYS_INLINE void shuffle(char *begin, char *end, size_t size)
+{
+	size_t n = (size_t)(end - begin) / size;
+	size_t q = n / 4 * size;
+
+	if (n < INSERTION)
+		return;
+	swap(begin, begin + q, size);
+	swap(end - size, end - q, size);
+	if (n > NINTHER) {
+		swap(begin + size, begin + q + size, size);
+		swap(begin + 2 * size, begin + q + 2 * size, size);
+		swap(end - 2 * size, end - q - size, size);
+		swap(end - 3 * size, end - q - 2 * size, size);
+	}
+}
+
+ALWAYS_INLINE void pdqsort(char *base, size_t n, size_t size,
+			   const struct order *o)
+{
+	struct part stack[STACK];
+	struct part *sp = stack;
+	char *begin = base;
+	char *end = base + n * size;
+	int bad = n > 1 ? 63 - __builtin_clzll(n) : 0;
+	bool leftmost = true;
+
+	for (;;) {
+		size_t len = (size_t)(end - begin) / size;
+		char *mid = begin + len / 2 * size;
+		char *pivot;
+		bool sorted;
+
+		if (len < INSERTION) {
+			insertion(begin, end, size, o);
+			goto pop;
+		}
+
+		/* the median goes to begin */
+		if (len > NINTHER) {
+			sort3(begin, mid, end - size, size, o);
+			sort3(begin + size, mid - size, end - 2 * size, size, o);
+			sort3(begin + 2 * size, mid + size, end - 3 * size, size,
+			      o);
+			sort3(mid - size, mid, mid + size, size, o);
+			swap(begin, mid, size);
+		} else {
+			sort3(mid, begin, end - size, size, o);
+		}
+
+		/* equal to what's left of it, so all of them are done */
+		if (!leftmost && !less(o, begin - size, begin)) {
+			begin = partition_left(begin, end, size, o) + size;
+			continue;
+		}
+
+		pivot = partition_right(begin, end, size, o, &sorted);
+		size_t l = (size_t)(pivot - begin) / size;
+		size_t r = (size_t)(end - pivot) / size - 1;
+
+		if (l < len / 8 || r < len / 8) {
+			if (--bad == 0) {
+				heapsort(begin, len, size, o);
+				goto pop;
+			}
+			shuffle(begin, pivot, size);
+			shuffle(pivot + size, end, size);
+		} else if (sorted &&
+			   partial_insertion(begin, pivot, size, o) &&
+			   partial_insertion(pivot + size, end, size, o)) {
+			goto pop;
+		}
+
+		/* the bigger half waits, so the stack stays logarithmic */
+		if (l < r) {
+			*sp++ = (struct part){ pivot + size, end, bad, false };
+			end = pivot;
+		} else {
+			*sp++ = (struct part){ begin, pivot, bad, leftmost };
+			begin = pivot + size;
+			leftmost = false;
+		}
+		continue;
+pop:
+		if (sp == stack)
+			return;
+		sp--;
+		begin = sp->begin;
+		end = sp->end;
+		bad = sp->bad;
+		leftmost = sp->leftmost;
+	}
+}
+
+void jqsort_r(void *base, size_t nmemb, size_t size,
+	      int (*compar)(const void *, const void *, void *), void *arg)
+{
+	struct order o = { NULL, compar, arg };
+
+	switch (size) {
+	case 4:
+		pdqsort(base, nmemb, 4, &o);
+		break;
+	case 8:
+		pdqsort(base, nmemb, 8, &o);
+		break;
+	case 16:
+		pdqsort(base, nmemb, 16, &o);
+		break;
+	default:
+		if (size)
+			pdqsort(base, nmemb, size, &o);
+		break;
+	}
+}
+
+void jqsort(void *base, size_t nmemb, size_t size,
+	    int (*compar)(const void *, const void *))
+{
+	struct order o = { compar, NULL, NULL };
+
+	switch (size) {
+	case 4:
+		pdqsort(base, nmemb, 4, &o);
+		break;
+	case 8:
+		pdqsort(base, nmemb, 8, &o);
+		break;
+	case 16:
+		pdqsort(base, nmemb, 16, &o);
+		break;
+	default:
+		if (size)
+			pdqsort(base, nmemb, size, &o);
+		break;
+	}
+}
@@ -0,0 +1,600 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstdlib.h"
+#include "jdigits.h"
+#include "jpow5.h"
+#include <errno.h>
+#include <float.h>
+
+/*
+ * A decimal number goes one of three ways, each slower and rarer than the
+ * one before:
+ *
+ * 1. Up to 2^53 times a power of ten up to 10^22 is the product of two exact
+ *    doubles, which one rounding of the FPU gets right (Clinger).
+ * 2. Otherwise the first 19 digits times a 128 bit approximation of the
+ *    power of ten, which gives the result unless the bits that decide the
+ *    rounding are too close to call (Eisel and Lemire).
+ * 3. When they are, the digits go into a big decimal that is shifted by
+ *    powers of two until the 53 bits of the result can be read off it
+ *    exactly, the way Go's strconv does it.
+ */
+#define MANT 52 /* mantissa bits, not counting the implicit one */
+#define BIAS 1023
+#define INF_EXP 0x7ff
+#define MAX_DIGITS 19 /* any 19 digits fit in 64 bits */
+#define DIGITS 800    /* kept by the big decimal, enough for any double */
+
+/* a double as it's put together, exp < 0 when it couldn't be worked out */
+struct fp {
+	uint64_t mant;
+	int exp;
+};
+
+static double make(bool neg, struct fp f)
+{
+	uint64_t bits = f.mant | (uint64_t)f.exp << MANT | (uint64_t)neg << 63;
+	double d;
+
+	jmemcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+/* the case-insensitive word w at p, the end of it if it's there */
+static const char *word(const char *p, const char *end, const char *w)
+{
+	for (; *w; p++, w++) {
+		if ((peek(p, end) | 0x20) != *w)
+			return NULL;
+	}
+	return p;
+}
+
+static inline unsigned hexdigit(unsigned char c)
+{
+	if ((unsigned)(c - '0') < 10)
+		return c - '0';
+	c |= 0x20;
+	return (unsigned)(c - 'a') < 6 ? c - 'a' + 10 : 16;
+}
+
+/*
+ * The exponent at p, which is at the 'e' or the 'p', added to *e. If there
+ * are no digits after it, it isn't an exponent and p is returned.
+ */
+static const char *exponent(const char *p, const char *end, int64_t *e)
+{
+	const char *q = p + 1;
+	bool neg = false;
+	int64_t x = 0;
+	unsigned d;
+
+	if (peek(q, end) == '-' || peek(q, end) == '+')
+		neg = *q++ == '-';
+	if ((unsigned)(peek(q, end) - '0') >= 10)
+		return p;
+	for (; (d = peek(q, end) - '0') < 10; q++) {
+		/* anything bigger is infinity or zero anyway */
+		if (x < 100000000)
+			x = x * 10 + d;
+	}
+	*e += neg ? -x : x;
+	return q;
+}
+
+/*
+ * m * 2^e, rounded to 53 bits. `sticky` says there were more bits after the
+ * last one of m, all of them below it.
+ */
+static double binary(bool neg, uint64_t m, int64_t e, bool sticky)
+{
+	struct fp f = { 0, 0 };
+	uint64_t keep;
+	uint64_t rem;
+	uint64_t half;
+	int64_t shift;
+	int lz;
+
+	if (m == 0)
+		return make(neg, f);
+	lz = __builtin_clzll(m);
+	m <<= lz;
+	e -= lz;
+	/* now m * 2^e is 1.something times 2^(e + 63) */
+	if (e + 63 > BIAS)
+		goto inf;
+	shift = 63 - MANT;
+	if (e + 63 < 1 - BIAS)
+		shift += 1 - BIAS - (e + 63); /* subnormal, fewer bits kept */
+	if (shift > 64) {
+		/* less than half the smallest subnormal */
+		errno = ERANGE;
+		return make(neg, f);
+	}
+	keep = shift == 64 ? 0 : m >> shift;
+	rem = shift == 64 ? m : m & (((uint64_t)1 << shift) - 1);
+	half = (uint64_t)1 << (shift - 1);
+	keep += rem > half || (rem == half && (sticky || (keep & 1)));
+	/* the implicit bit adds one to the exponent, so does a carry into it */
+	if (e + 63 >= 1 - BIAS)
+		keep += (uint64_t)(e + 63 + BIAS - 1) << MANT;
+	if (keep >= (uint64_t)INF_EXP << MANT)
+		goto inf;
+	if (keep == 0)
+		errno = ERANGE;
+	f.mant = keep;
+	return make(neg, f);
+inf:
+	errno = ERANGE;
+	f.exp = INF_EXP;
+	return make(neg, f);
+}
+
+/*
+ * The hex digits at p, after the "0x", and the binary exponent after them.
+ * Only the first 60 bits are kept, the rest is only looked at for whether
+ * it's zero.
+ */
+static const char *hexfloat(const char *p, const char *end, bool neg,
+			    double *v)
+{
+	uint64_t m = 0;
+	int64_t e = 0;
+	bool sticky = false;
+	bool dot = false;
+	unsigned d;
+
+	for (;; p++) {
+		if (peek(p, end) == '.' && !dot) {
+			dot = true;
+			continue;
+		}
+		if ((d = hexdigit(peek(p, end))) >= 16)
+			break;
+		if (m >> 56 == 0) {
+			m = m << 4 | d;
+			e -= dot ? 4 : 0;
+		} else {
+			sticky |= d != 0;
+			e += dot ? 0 : 4;
+		}
+	}
+	if ((peek(p, end) | 0x20) == 'p')
+		p = exponent(p, end, &e);
+	*v = binary(neg, m, e, sticky);
+	return p;
+}
+
+/* w * 10^q, or exp < 0 if the bits that decide the rounding are unsure */
+static struct fp eisel_lemire(int64_t q, uint64_t w)
+{
+	struct fp f = { 0, 0 };
+	const uint64_t *p5;
+	__uint128_t prod;
+	uint64_t hi;
+	uint64_t lo;
+	int lz;
+	int up;
+	int shift;
+
+	if (w == 0 || q < POW5_MIN)
+		return f;
+	if (q > POW5_MAX)
+		return (struct fp){ 0, INF_EXP };
+	/* 10^q is 5^q * 2^q, the 2^q only goes to the exponent */
+	lz = __builtin_clzll(w);
+	w <<= lz;
+	p5 = pow5[q - POW5_MIN];
+	prod = (__uint128_t)w * p5[0];
+	hi = (uint64_t)(prod >> 64);
+	lo = (uint64_t)prod;
+	/* below the 55 bits wanted it's all ones, a carry could still come */
+	if ((hi & (UINT64_MAX >> (MANT + 3))) == UINT64_MAX >> (MANT + 3)) {
+		uint64_t next = (uint64_t)(((__uint128_t)w * p5[1]) >> 64);
+
+		lo += next;
+		hi += next > lo;
+	}
+	/* 5^q isn't exact in 128 bits outside of that, so nothing is known */
+	if (lo == UINT64_MAX && (q < -27 || q > 55))
+		return (struct fp){ 0, -1 };
+	up = (int)(hi >> 63);
+	shift = up + 64 - MANT - 3;
+	f.mant = hi >> shift;
+	/* floor(q * log2(10)) + 63, by a multiply and shift */
+	f.exp = (int)((((152170 + 65536) * q) >> 16) + 63) + up - lz + BIAS;
+	if (f.exp <= 0) {
+		/* subnormal, and ties can't happen this far down */
+		if (-f.exp + 1 >= 64)
+			return (struct fp){ 0, 0 };
+		f.mant >>= -f.exp + 1;
+		f.mant += f.mant & 1;
+		f.mant >>= 1;
+		/* rounding up can make it the smallest normal one */
+		f.exp = f.mant < (uint64_t)1 << MANT ? 0 : 1;
+		return f;
+	}
+	/*
+	 * Exactly halfway between two doubles, which only happens for small q
+	 * and with nothing but zeros below: round to even, not up.
+	 */
+	if (lo <= 1 && q >= -4 && q <= 23 && (f.mant & 3) == 1 &&
+	    f.mant << shift == hi)
+		f.mant &= ~(uint64_t)1;
+	f.mant += f.mant & 1;
+	f.mant >>= 1;
+	if (f.mant >= (uint64_t)2 << MANT) {
+		f.mant = (uint64_t)1 << MANT;
+		f.exp++;
+	}
+	f.mant &= ~((uint64_t)1 << MANT);
+	if (f.exp >= INF_EXP)
+		return (struct fp){ 0, INF_EXP };
+	return f;
+}
+
+/*
+ * The slow path. Digits are kept as values, most significant first, with
+ * the decimal point dp digits in: 0.d[0]d[1]... * 10^dp.
+ */
+struct decimal {
+	int nd;
+	int dp;
+	bool trunc; /* nonzero digits were dropped after d[nd - 1] */
+	uint8_t d[DIGITS];
+};
+
+#define MAX_SHIFT 60 /* a digit shifted by this still fits in 64 bits */
+
+static void trim(struct decimal *a)
+{
+	while (a->nd > 0 && a->d[a->nd - 1] == 0)
+		a->nd--;
+	if (a->nd == 0)
+		a->dp = 0;
+}
+
+static void rshift(struct decimal *a, unsigned k)
+{
+	uint64_t mask = ((uint64_t)1 << k) - 1;
+	uint64_t n = 0;
+	int r = 0;
+	int w = 0;
+
+	/* enough leading digits for the first one out */
+	for (; n >> k == 0; r++) {
+		if (r >= a->nd) {
+			if (n == 0) {
+				a->nd = 0;
+				return;
+			}
+			while (n >> k == 0) {
+				n *= 10;
+				r++;
+			}
+			break;
+		}
+		n = n * 10 + a->d[r];
+	}
+	a->dp -= r - 1;
+	for (; r < a->nd; r++) {
+		a->d[w++] = (uint8_t)(n >> k);
+		n = (n & mask) * 10 + a->d[r];
+	}
+	for (; n > 0; n = (n & mask) * 10) {
+		if (w < DIGITS)
+			a->d[w++] = (uint8_t)(n >> k);
+		else if (n >> k)
+			a->trunc = true;
+	}
+	a->nd = w;
+	trim(a);
+}
+
+static void lshift(struct decimal *a, unsigned k)
+{
+	/* from the last digit up, a 60 bit shift adds at most 19 digits */
+	uint8_t t[DIGITS + 20];
+	int w = sizeof(t);
+	uint64_t n = 0;
+	int len;
+
+	for (int r = a->nd; r-- > 0;) {
+		n += (uint64_t)a->d[r] << k;
+		t[--w] = n % 10;
+		n /= 10;
+	}
+	for (; n; n /= 10)
+		t[--w] = n % 10;
+	len = sizeof(t) - w;
+	a->dp += len - a->nd;
+	for (int i = DIGITS; i < len; i++)
+		a->trunc |= t[w + i] != 0;
+	if (len > DIGITS)
+		len = DIGITS;
+	jmemcpy(a->d, t + w, len);
+	a->nd = len;
+	trim(a);
+}
+
+/* times 2^k, or divided for a negative k */
+static void shift(struct decimal *a, int k)
+{
+	if (a->nd == 0)
+		return;
+	for (; k > MAX_SHIFT; k -= MAX_SHIFT)
+		lshift(a, MAX_SHIFT);
+	for (; k < -MAX_SHIFT; k += MAX_SHIFT)
+		rshift(a, MAX_SHIFT);
+	if (k > 0)
+		lshift(a, k);
+	else if (k < 0)
+		rshift(a, -k);
+}
+
+/* the integer part, rounded to nearest, ties to even */
+static uint64_t rounded(const struct decimal *a)
+{
+	uint64_t n = 0;
+	bool up;
+	int i;
+
+	if (a->dp > 20)
+		return UINT64_MAX;
+	for (i = 0; i < a->dp && i < a->nd; i++)
+		n = n * 10 + a->d[i];
+	for (; i < a->dp; i++)
+		n *= 10;
+	if (a->dp < 0 || a->dp >= a->nd)
+		return n;
+	if (a->d[a->dp] == 5 && a->dp + 1 == a->nd)
+		up = a->trunc || (a->dp > 0 && (a->d[a->dp - 1] & 1));
+	else
+		up = a->d[a->dp] >= 5;
+	return n + up;
+}
+
+static struct fp big(struct decimal *a)
+{
+	/* how far a shift can go for dp digits without passing 1 */
+	static const int pow2[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+	const int npow2 = sizeof(pow2) / sizeof(*pow2);
+	struct fp f = { 0, 0 };
+	int exp = 0;
+	int n;
+
+	if (a->nd == 0 || a->dp < -330)
+		return f;
+	if (a->dp > 310)
+		return (struct fp){ 0, INF_EXP };
+	/* scale to [0.5, 1) */
+	while (a->dp > 0) {
+		n = a->dp >= npow2 ? 27 : pow2[a->dp];
+		shift(a, -n);
+		exp += n;
+	}
+	while (a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+		n = -a->dp >= npow2 ? 27 : pow2[-a->dp];
+		shift(a, n);
+		exp -= n;
+	}
+	/* [1, 2) like the double's mantissa */
+	exp--;
+	if (exp < 1 - BIAS) {
+		n = 1 - BIAS - exp;
+		shift(a, -n);
+		exp += n;
+	}
+	if (exp + BIAS >= INF_EXP)
+		return (struct fp){ 0, INF_EXP };
+	shift(a, 1 + MANT);
+	f.mant = rounded(a);
+	if (f.mant == (uint64_t)2 << MANT) {
+		f.mant >>= 1;
+		if (++exp + BIAS >= INF_EXP)
+			return (struct fp){ 0, INF_EXP };
+	}
+	/* no implicit one makes it subnormal */
+	f.exp = f.mant & ((uint64_t)1 << MANT) ? exp + BIAS : 0;
+	f.mant &= ((uint64_t)1 << MANT) - 1;
+	return f;
+}
+
+/* the digits, point and exponent from p to stop, which are known good */
+static struct fp slow(const char *p, const char *stop)
+{
+	struct decimal a = { .nd = 0, .dp = 0, .trunc = false };
+	bool dot = false;
+	int64_t dp = 0;
+
+	for (; p != stop; p++) {
+		if (*p == '.') {
+			dot = true;
+			continue;
+		}
+		if ((unsigned)(*p - '0') >= 10)
+			break;
+		if (*p == '0' && a.nd == 0) {
+			dp -= dot;
+			continue;
+		}
+		dp += !dot;
+		if (a.nd < DIGITS)
+			a.d[a.nd++] = *p - '0';
+		else if (*p != '0')
+			a.trunc = true;
+	}
+	if (p != stop)
+		exponent(p, stop, &dp);
+	a.dp = dp > 100000 ? 100000 : dp < -100000 ? -100000 : (int)dp;
+	trim(&a);
+	return big(&a);
+}
+
+static const double pow10[] = {
+	1e0,  1e1,  1e2,  1e3,	1e4,  1e5,  1e6,  1e7,	1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* the digits at p, up to 19 of them into *w */
+static const char *digits(const char *p, const char *end, uint64_t *w)
+{
+	unsigned d;
+
+	while (room(p, end) >= 8 && eight_digits(load8(p))) {
+		*w = *w * 100000000 + parse_eight(load8(p));
+		p += 8;
+	}
+	for (; (d = peek(p, end) - '0') < 10; p++)
+		*w = *w * 10 + d;
+	return p;
+}
+
+/* the first 19 significant digits again, the others go to the exponent */
+static uint64_t first19(const char *ip, const char *iend, const char *fp,
+			const char *fend, int64_t *q)
+{
+	const uint64_t min19 = 1000000000000000000ULL;
+	const char *p = ip;
+	uint64_t w = 0;
+
+	for (; w < min19 && p != iend; p++)
+		w = w * 10 + (*p - '0');
+	if (w >= min19) {
+		*q += iend - p;
+		return w;
+	}
+	for (p = fp; w < min19 && p != fend; p++)
+		w = w * 10 + (*p - '0');
+	*q += fp - p;
+	return w;
+}
+
+static const char *decimal(const char *p, const char *end, bool neg, double *v)
+{
+	const char *start = p;
+	const char *ip = p;
+	const char *iend;
+	const char *fp;
+	const char *fend;
+	uint64_t w = 0;
+	int64_t e10 = 0;
+	int64_t q = 0;
+	int64_t nd;
+	bool many = false;
+	struct fp f;
+
+	iend = p = digits(p, end, &w);
+	fp = fend = p;
+	if (peek(p, end) == '.') {
+		fp = p + 1;
+		fend = p = digits(fp, end, &w);
+		q = fp - fend;
+	}
+	nd = (iend - ip) + (fend - fp);
+	if (nd == 0)
+		return start;
+	if ((peek(p, end) | 0x20) == 'e')
+		p = exponent(p, end, &e10);
+	q += e10;
+	if (nd > MAX_DIGITS) {
+		/* leading zeros don't count, there usually aren't any */
+		for (const char *z = ip; z != fend && (*z == '0' || *z == '.');
+		     z++)
+			nd -= *z == '0';
+		if (nd > MAX_DIGITS) {
+			many = true;
+			q = e10;
+			w = first19(ip, iend, fp, fend, &q);
+		}
+	}
+#if FLT_EVAL_METHOD == 0
+	if (!many && q >= -22 && q <= 22 && w <= (uint64_t)1 << (MANT + 1)) {
+		*v = q < 0 ? (double)w / pow10[-q] : (double)w * pow10[q];
+		*v = neg ? -*v : *v;
+		return p;
+	}
+#endif
+	f = eisel_lemire(q, w);
+	/* with digits cut off, the value is between w and w + 1 */
+	if (many && f.exp >= 0) {
+		struct fp g = eisel_lemire(q, w + 1);
+
+		if (g.exp != f.exp || g.mant != f.mant)
+			f.exp = -1;
+	}
+	if (f.exp < 0)
+		f = slow(start, p);
+	if (f.exp == INF_EXP || (f.exp == 0 && f.mant == 0 && w != 0))
+		errno = ERANGE;
+	*v = make(neg, f);
+	return p;
+}
+
+static double to_double(const char *s, const char *end, char **endptr)
+{
+	const char *p = s;
+	const char *q;
+	bool neg = false;
+	double v = 0;
+
+	while (space(peek(p, end)))
+		p++;
+	if (peek(p, end) == '-' || peek(p, end) == '+')
+		neg = *p++ == '-';
+	if (peek(p, end) == '0' && (peek(p + 1, end) | 0x20) == 'x' &&
+	    (hexdigit(peek(p + 2, end)) < 16 ||
+	     (peek(p + 2, end) == '.' && hexdigit(peek(p + 3, end)) < 16))) {
+		p = hexfloat(p + 2, end, neg, &v);
+	} else if ((q = word(p, end, "inf")) != NULL) {
+		p = word(q, end, "inity");
+		p = p ? p : q;
+		v = make(neg, (struct fp){ 0, INF_EXP });
+	} else if ((q = word(p, end, "nan")) != NULL) {
+		p = q;
+		/* the "(...)" is only part of it if it's closed */
+		if (peek(q, end) == '(') {
+			unsigned char c;
+
+			for (q++; (c = peek(q, end)) == '_' ||
+				  (unsigned)(c - '0') < 10 ||
+				  (unsigned)((c | 0x20) - 'a') < 26;
+			     q++)
+				;
+			if (peek(q, end) == ')')
+				p = q + 1;
+		}
+		v = make(neg, (struct fp){ (uint64_t)1 << (MANT - 1), INF_EXP });
+	} else if ((q = decimal(p, end, neg, &v)) != p) {
+		p = q;
+	} else {
+		p = s;
+	}
+	if (endptr)
+		*endptr = (char *)p;
+	return v;
+}
+
+double jstrtod(const char *restrict nptr, char **restrict endptr)
+{
+	return to_double(nptr, NULL, endptr);
+}
+
+double jstrntod(const char *s, size_t n, char **endptr)
+{
+	return to_double(s, s + n, endptr);
+}
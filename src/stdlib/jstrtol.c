@@ -0,0 +1,134 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstdlib.h"
+#include "jdigits.h"
+#include <errno.h>
+#include <limits.h>
+
+/* past this, another eight digits could overflow 64 bits */
+#define EIGHT_MAX ((UINT64_MAX - 99999999) / 100000000)
+
+/* the value of c as a digit, 36 or more if it isn't one */
+static inline unsigned digit(unsigned char c)
+{
+	if ((unsigned)(c - '0') < 10)
+		return c - '0';
+	c |= 0x20; /* lower case, doesn't make anything else a letter */
+	return (unsigned)(c - 'a') < 26 ? c - 'a' + 10 : 36;
+}
+
+/*
+ * Reads a sign and the magnitude after it into *v. Returns where the number
+ * ends, `s` when there's none. *over is set when the magnitude doesn't fit.
+ */
+static const char *parse(const char *s, const char *end, int base, uint64_t *v,
+			 bool *neg, bool *over)
+{
+	const char *p = s;
+	const char *digits;
+
+	*v = 0;
+	*neg = false;
+	*over = false;
+	if (base < 0 || base == 1 || base > 36) {
+		errno = EINVAL;
+		return s;
+	}
+	while (space(peek(p, end)))
+		p++;
+	if (peek(p, end) == '-' || peek(p, end) == '+')
+		*neg = *p++ == '-';
+	/* "0x" with no hex digit after it is only the 0 */
+	if ((base == 0 || base == 16) && peek(p, end) == '0' &&
+	    (peek(p + 1, end) | 0x20) == 'x' && digit(peek(p + 2, end)) < 16) {
+		p += 2;
+		base = 16;
+	} else if (base == 0) {
+		base = peek(p, end) == '0' ? 8 : 10;
+	}
+	digits = p;
+	if (base == 10) {
+		while (*v <= EIGHT_MAX && room(p, end) >= 8 &&
+		       eight_digits(load8(p))) {
+			*v = *v * 100000000 + parse_eight(load8(p));
+			p += 8;
+		}
+	}
+	for (unsigned d; (d = digit(peek(p, end))) < (unsigned)base; p++) {
+		/* the rest of the digits are still part of the number */
+		if (__builtin_mul_overflow(*v, (unsigned)base, v) ||
+		    __builtin_add_overflow(*v, d, v))
+			*over = true;
+	}
+	return p == digits ? s : p;
+}
+
+static long to_long(const char *s, const char *end, char **endptr, int base)
+{
+	uint64_t v;
+	bool neg;
+	bool over;
+	const char *p = parse(s, end, base, &v, &neg, &over);
+
+	if (endptr)
+		*endptr = (char *)p;
+	if (over || v > (uint64_t)LONG_MAX + neg) {
+		errno = ERANGE;
+		return neg ? LONG_MIN : LONG_MAX;
+	}
+	if (neg)
+		return v > LONG_MAX ? LONG_MIN : -(long)v;
+	return (long)v;
+}
+
+static unsigned long long to_ullong(const char *s, const char *end,
+				    char **endptr, int base)
+{
+	uint64_t v;
+	bool neg;
+	bool over;
+	const char *p = parse(s, end, base, &v, &neg, &over);
+
+	if (endptr)
+		*endptr = (char *)p;
+	if (over) {
+		errno = ERANGE;
+		return ULLONG_MAX;
+	}
+	return neg ? -v : v;
+}
+
+long jstrtol(const char *restrict nptr, char **restrict endptr, int base)
+{
+	return to_long(nptr, NULL, endptr, base);
+}
+
+long jstrntol(const char *s, size_t n, char **endptr, int base)
+{
+	return to_long(s, s + n, endptr, base);
+}
+
+unsigned long long jstrtoull(const char *restrict nptr, char **restrict endptr,
+			     int base)
+{
+	return to_ullong(nptr, NULL, endptr, base);
+}
+
+unsigned long long jstrntoull(const char *s, size_t n, char **endptr, int base)
+{
+	return to_ullong(s, s + n, endptr, base);
+}
@@ -0,0 +1,386 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * A Swiss table. The slots come in groups of 16, and each slot has a control
+ * byte: EMPTY, or the top 7 bits of the hash of the string in it. A probe
+ * compares all 16 control bytes of a group against those 7 bits at once, and
+ * only the slots that match get their strings compared. Strings are never
+ * removed, so there are no tombstones.
+ */
+#define GROUP 16
+#define EMPTY 0x80
+#define MIN_GROUPS 4
+#define CHUNK 65536 /* arena chunk, bigger strings get a block of their own */
+
+/* what a canonical copy is stored behind */
+struct istr {
+	uint64_t hash;
+	size_t len;
+	char s[];
+};
+
+#define ISTR(p) ((struct istr *)((char *)(p) - offsetof(struct istr, s)))
+
+struct jintern {
+	jheap_t *heap; /* everything the table has lives here */
+	pthread_rwlock_t lock;
+	bool shared;
+	uint8_t *ctrl;
+	const char **slots;
+	size_t groups; /* a power of two */
+	size_t count;
+	char *bump; /* free part of the current arena chunk */
+	size_t room;
+};
+
+typedef uint64_t __attribute__((may_alias, aligned(1))) u64u;
+typedef uint32_t __attribute__((may_alias, aligned(1))) u32u;
+
+/* 64x64 to 128 bit multiply, folded */
+static uint64_t mum(uint64_t a, uint64_t b)
+{
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+#define K0 0xa0761d6478bd642fULL
+#define K1 0xe7037ed1a0b428dbULL
+#define K2 0x8ebc6af09c88c6e3ULL
+
+/*
+ * wyhash style, 8 bytes a load. Long strings go through two independent
+ * lanes of 16 bytes, so the multiplies of one overlap with the other's.
+ * Short ones, which labels mostly are, take two overlapping loads and no
+ * loop at all.
+ */
+static uint64_t hash(const char *s, size_t n)
+{
+	const unsigned char *p = (const unsigned char *)s;
+	uint64_t seed = K0 ^ mum(n ^ K0, K1);
+	uint64_t a;
+	uint64_t b;
+	size_t i = n;
+
+	if (n <= 16) {
+		if (n >= 8) {
+			a = *(const u64u *)p;
+			b = *(const u64u *)(p + n - 8);
+		} else if (n >= 4) {
+			a = *(const u32u *)p;
+			b = *(const u32u *)(p + n - 4);
+		} else if (n > 0) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[n >> 1] << 8) |
+			    p[n - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		if (i > 32) {
+			uint64_t lane = seed;
+
+			do {
+				seed = mum(*(const u64u *)p ^ K1,
+					   *(const u64u *)(p + 8) ^ seed);
+				lane = mum(*(const u64u *)(p + 16) ^ K2,
+					   *(const u64u *)(p + 24) ^ lane);
+				p += 32;
+				i -= 32;
+			} while (i > 32);
+			seed ^= lane;
+		}
+		if (i > 16) {
+			seed = mum(*(const u64u *)p ^ K1,
+				   *(const u64u *)(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = *(const u64u *)(p + i - 16);
+		b = *(const u64u *)(p + i - 8);
+	}
+	return mum(K1 ^ n, mum(a ^ K1, b ^ seed));
+}
+
+/* bit i is set if control byte i of the group is `tag` */
+static uint32_t match(const uint8_t *g, uint8_t tag)
+{
+#if defined(__SSE2__)
+	__m128i v = _mm_load_si128((const __m128i *)g);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)tag)));
+#else
+	uint32_t m = 0;
+
+	for (int i = 0; i < GROUP; i++)
+		m |= (uint32_t)(g[i] == tag) << i;
+	return m;
+#endif
+}
+
+/* EMPTY is the only control byte with its top bit set */
+static uint32_t empties(const uint8_t *g)
+{
+#if defined(__SSE2__)
+	return _mm_movemask_epi8(_mm_load_si128((const __m128i *)g));
+#else
+	return match(g, EMPTY);
+#endif
+}
+
+#define TAG(h) ((uint8_t)((h) >> 57))
+
+/*
+ * Finds `s`, or the slot it would go in through `at`. Groups are visited in
+ * triangular order, which covers all of them when their number is a power
+ * of two.
+ */
+static const char *probe(const jintern_t *t, const char *s, size_t n,
+			 uint64_t h, size_t *__jnullable at)
+{
+	size_t mask = t->groups - 1;
+	size_t g = h & mask;
+
+	for (size_t step = 1;; g = (g + step++) & mask) {
+		const uint8_t *c = t->ctrl + g * GROUP;
+		uint32_t m = match(c, TAG(h));
+		uint32_t e;
+
+		for (; m; m &= m - 1) {
+			const char *p = t->slots[g * GROUP + __builtin_ctz(m)];
+			const struct istr *is = ISTR(p);
+
+			if (is->hash == h && is->len == n &&
+			    jmemcmp(p, s, n) == 0)
+				return p;
+		}
+		if ((e = empties(c)) != 0) {
+			if (at)
+				*at = g * GROUP + __builtin_ctz(e);
+			return NULL;
+		}
+	}
+}
+
+/* the first free slot on the probe path of `h` */
+static size_t slot_for(const jintern_t *t, uint64_t h)
+{
+	size_t mask = t->groups - 1;
+	size_t g = h & mask;
+	uint32_t e;
+
+	for (size_t step = 1;; g = (g + step++) & mask) {
+		if ((e = empties(t->ctrl + g * GROUP)) != 0)
+			return g * GROUP + __builtin_ctz(e);
+	}
+}
+
+static bool table(jintern_t *t, size_t groups)
+{
+	size_t n = groups * GROUP;
+
+	t->ctrl = jheap_malloc(t->heap, n);
+	t->slots = jheap_malloc(t->heap, n * sizeof(*t->slots));
+	if (!t->ctrl || !t->slots) {
+		jheap_free(t->heap, t->ctrl);
+		jheap_free(t->heap, t->slots);
+		return false;
+	}
+	jmemset(t->ctrl, EMPTY, n);
+	t->groups = groups;
+	return true;
+}
+
+/* doubles the table, the strings keep their hashes so nothing is rehashed */
+static bool grow(jintern_t *t)
+{
+	uint8_t *ctrl = t->ctrl;
+	const char **slots = t->slots;
+	size_t n = t->groups * GROUP;
+
+	if (!table(t, t->groups * 2))
+		return false;
+	for (size_t i = 0; i < n; i++) {
+		size_t at;
+
+		if (ctrl[i] == EMPTY)
+			continue;
+		at = slot_for(t, ISTR(slots[i])->hash);
+		t->ctrl[at] = ctrl[i];
+		t->slots[at] = slots[i];
+	}
+	jheap_free(t->heap, ctrl);
+	jheap_free(t->heap, slots);
+	return true;
+}
+
+/* copies the string into the arena */
+static const char *store(jintern_t *t, const char *s, size_t n, uint64_t h)
+{
+	size_t need = (sizeof(struct istr) + n + 1 + 7) & ~(size_t)7;
+	struct istr *is;
+	char *chunk;
+
+	if (need < n)
+		return NULL;
+	if (need > CHUNK / 4) {
+		if ((is = jheap_malloc(t->heap, need)) == NULL)
+			return NULL;
+	} else {
+		if (need > t->room) {
+			if ((chunk = jheap_malloc(t->heap, CHUNK)) == NULL)
+				return NULL;
+			/* the rest of the old chunk is lost, at most a quarter */
+			t->bump = chunk;
+			t->room = CHUNK;
+		}
+		is = (struct istr *)t->bump;
+		t->bump += need;
+		t->room -= need;
+	}
+	is->hash = h;
+	is->len = n;
+	jmemcpy(is->s, s, n);
+	is->s[n] = '\0';
+	return is->s;
+}
+
+static const char *insert(jintern_t *t, const char *s, size_t n, uint64_t h)
+{
+	const char *p;
+	size_t at;
+
+	if ((p = probe(t, s, n, h, &at)) != NULL)
+		return p;
+	/* keep at least 1/8 of the slots empty so probes end quickly */
+	if (t->count + 1 > t->groups * GROUP / 8 * 7) {
+		if (!grow(t))
+			return NULL;
+		at = slot_for(t, h);
+	}
+	if ((p = store(t, s, n, h)) == NULL)
+		return NULL;
+	t->ctrl[at] = TAG(h);
+	t->slots[at] = p;
+	t->count++;
+	return p;
+}
+
+jintern_t *jintern_create(int flags)
+{
+	jheap_t *heap;
+	jintern_t *t;
+
+	if (flags & ~JINTERN_SHARED) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if ((heap = jheap_create()) == NULL)
+		return NULL;
+	if ((t = jheap_malloc(heap, sizeof(*t))) == NULL) {
+		jheap_destroy(heap);
+		errno = ENOMEM;
+		return NULL;
+	}
+	jmemset(t, 0, sizeof(*t));
+	t->heap = heap;
+	t->shared = flags & JINTERN_SHARED;
+	if (!table(t, MIN_GROUPS) ||
+	    (t->shared && pthread_rwlock_init(&t->lock, NULL) != 0)) {
+		jheap_destroy(heap);
+		errno = ENOMEM;
+		return NULL;
+	}
+	return t;
+}
+
+const char *jintern(jintern_t *t, const char *s, size_t n)
+{
+	uint64_t h = hash(s, n);
+	const char *p;
+
+	if (!t->shared) {
+		if ((p = insert(t, s, n, h)) == NULL)
+			errno = ENOMEM;
+		return p;
+	}
+	/* most strings are there already, so look with the read lock first */
+	pthread_rwlock_rdlock(&t->lock);
+	p = probe(t, s, n, h, NULL);
+	pthread_rwlock_unlock(&t->lock);
+	if (p)
+		return p;
+	pthread_rwlock_wrlock(&t->lock);
+	p = insert(t, s, n, h);
+	pthread_rwlock_unlock(&t->lock);
+	if (!p)
+		errno = ENOMEM;
+	return p;
+}
+
+const char *jintern_cstr(jintern_t *t, const char *s)
+{
+	return jintern(t, s, jstrlen(s));
+}
+
+const char *jintern_lookup(jintern_t *t, const char *s, size_t n)
+{
+	uint64_t h = hash(s, n);
+	const char *p;
+
+	if (t->shared)
+		pthread_rwlock_rdlock(&t->lock);
+	p = probe(t, s, n, h, NULL);
+	if (t->shared)
+		pthread_rwlock_unlock(&t->lock);
+	return p;
+}
+
+size_t jintern_len(const char *s)
+{
+	return ISTR(s)->len;
+}
+
+size_t jintern_count(jintern_t *t)
+{
+	size_t n;
+
+	if (t->shared)
+		pthread_rwlock_rdlock(&t->lock);
+	n = t->count;
+	if (t->shared)
+		pthread_rwlock_unlock(&t->lock);
+	return n;
+}
+
+void jintern_destroy(jintern_t *t)
+{
+	if (!t)
+		return;
+	if (t->shared)
+		pthread_rwlock_destroy(&t->lock);
+	/* the table itself is in the heap too */
+	jheap_destroy(t->heap);
+}
@@ -16,7 +16,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
 #include "jstring.h"
 
-void *jmemcpy(void *restrict dest, const void *restrict src, size_t n)
+void *(jmemcpy)(void *restrict dest, const void *restrict src, size_t n)
 {
 	unsigned char *d = (unsigned char *)dest;
 	unsigned char *s = (unsigned char *)src;
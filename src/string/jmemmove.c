@@ -16,7 +16,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
 #include "jstring.h"
 
-void *jmemmove(void *dest, const void *src, size_t n)
+void *(jmemmove)(void *dest, const void *src, size_t n)
 {
         unsigned char *d;
         unsigned char *s;
@@ -16,7 +16,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
 #include "jstring.h"
 
-void *jmemset(void *s, int c, size_t n)
+void *(jmemset)(void *s, int c, size_t n)
 {
 	unsigned char *src = (unsigned char *)s;
 
@@ -0,0 +1,216 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/uio.h>
+
+/* bytes that live elsewhere, they go right before buf[at] */
+struct jsb_ref {
+	const void *p;
+	size_t n;
+	size_t at;
+};
+
+int jsb_reserve(jsb *sb, size_t n)
+{
+	char *p;
+
+	if (n <= sb->cap - sb->len)
+		return 0;
+	if (n > SIZE_MAX - sb->len) {
+		errno = ENOMEM;
+		return -1;
+	}
+	if ((p = jgrow(sb->buf, &sb->cap, sb->len + n, 1)) == NULL)
+		return -1;
+	sb->buf = p;
+	return 0;
+}
+
+int jsb_append(jsb *sb, const void *p, size_t n)
+{
+	if (jsb_reserve(sb, n) < 0)
+		return -1;
+	jmemcpy(sb->buf + sb->len, p, n);
+	sb->len += n;
+	return 0;
+}
+
+int jsb_puts(jsb *sb, const char *s)
+{
+	return jsb_append(sb, s, jstrlen(s));
+}
+
+int jsb_putc(jsb *sb, int c)
+{
+	if (jsb_reserve(sb, 1) < 0)
+		return -1;
+	sb->buf[sb->len++] = (char)c;
+	return 0;
+}
+
+int jsb_uint(jsb *sb, unsigned long long v)
+{
+	char tmp[20]; /* 2^64 - 1 has 20 digits */
+	char *d = tmp + sizeof(tmp);
+
+	do {
+		*--d = (char)('0' + v % 10);
+		v /= 10;
+	} while (v);
+	return jsb_append(sb, d, tmp + sizeof(tmp) - d);
+}
+
+int jsb_int(jsb *sb, long long v)
+{
+	if (v >= 0)
+		return jsb_uint(sb, v);
+	if (jsb_reserve(sb, 21) < 0)
+		return -1;
+	sb->buf[sb->len++] = '-';
+	/* negated as unsigned, so LLONG_MIN comes out right */
+	return jsb_uint(sb, -(unsigned long long)v);
+}
+
+/* where the next byte goes, NULL while there's no buffer yet */
+static char *cursor(jsb *sb)
+{
+	return sb->buf ? sb->buf + sb->len : NULL;
+}
+
+int jsb_printf(jsb *sb, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	/* try the room there is, most of the time it's enough */
+	va_start(ap, fmt);
+	n = vsnprintf(cursor(sb), sb->cap - sb->len, fmt, ap);
+	va_end(ap);
+	if (n < 0)
+		return -1;
+	if ((size_t)n >= sb->cap - sb->len) {
+		/* vsnprintf() wants a byte for the '\0' */
+		if (jsb_reserve(sb, (size_t)n + 1) < 0)
+			return -1;
+		va_start(ap, fmt);
+		n = vsnprintf(cursor(sb), sb->cap - sb->len, fmt, ap);
+		va_end(ap);
+		if (n < 0)
+			return -1;
+	}
+	sb->len += n;
+	return 0;
+}
+
+int jsb_ref(jsb *sb, const void *p, size_t n)
+{
+	struct jsb_ref *r;
+
+	if (n == 0)
+		return 0;
+	if (n > SIZE_MAX - sb->len - sb->reflen) {
+		errno = ENOMEM;
+		return -1;
+	}
+	r = jgrow(sb->refs, &sb->refcap, sb->nrefs + 1, sizeof(*r));
+	if (r == NULL)
+		return -1;
+	sb->refs = r;
+	r[sb->nrefs++] = (struct jsb_ref){ .p = p, .n = n, .at = sb->len };
+	sb->reflen += n;
+	return 0;
+}
+
+size_t jsb_len(const jsb *sb)
+{
+	return sb->len + sb->reflen;
+}
+
+/* adds a piece if there's room, counts it either way */
+static void piece(struct iovec *iov, int max, int *cnt, const void *p,
+		  size_t n)
+{
+	if (*cnt < max)
+		iov[*cnt] = (struct iovec){ .iov_base = (void *)p, .iov_len = n };
+	(*cnt)++;
+}
+
+int jsb_iov(const jsb *sb, struct iovec *iov, int max)
+{
+	size_t from = 0;
+	int cnt = 0;
+
+	for (size_t i = 0; i < sb->nrefs; i++) {
+		if (sb->refs[i].at > from)
+			piece(iov, max, &cnt, sb->buf + from,
+			      sb->refs[i].at - from);
+		piece(iov, max, &cnt, sb->refs[i].p, sb->refs[i].n);
+		from = sb->refs[i].at;
+	}
+	if (sb->len > from)
+		piece(iov, max, &cnt, sb->buf + from, sb->len - from);
+	return cnt;
+}
+
+char *jsb_take(jsb *sb, size_t *len)
+{
+	size_t total = jsb_len(sb);
+	size_t end = total;
+	size_t src = sb->len;
+	char *p;
+
+	/* room for the references and the '\0' */
+	if (jsb_reserve(sb, sb->reflen + 1) < 0)
+		return NULL;
+	/* from the back, so every byte moves once */
+	for (size_t i = sb->nrefs; i-- > 0;) {
+		const struct jsb_ref *r = &sb->refs[i];
+		size_t seg = src - r->at;
+
+		jmemmove(sb->buf + end - seg, sb->buf + r->at, seg);
+		end -= seg;
+		jmemcpy(sb->buf + end - r->n, r->p, r->n);
+		end -= r->n;
+		src = r->at;
+	}
+	sb->buf[total] = '\0';
+	p = sb->buf;
+	if (len)
+		*len = total;
+	jfree(sb->refs);
+	jmemset(sb, 0, sizeof(*sb));
+	return p;
+}
+
+void jsb_clear(jsb *sb)
+{
+	sb->len = 0;
+	sb->nrefs = 0;
+	sb->reflen = 0;
+}
+
+void jsb_free(jsb *sb)
+{
+	jfree(sb->buf);
+	jfree(sb->refs);
+	jmemset(sb, 0, sizeof(*sb));
+}
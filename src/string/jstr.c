@@ -0,0 +1,180 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jmm.h"
+#include "jstring.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+_Static_assert(sizeof(jstr) == 3 * sizeof(size_t), "jstr has grown");
+/* GCC packs cap's bit-field from the low end, clear of the tag byte */
+_Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+	       "jstr's tag shares its byte with cap on big-endian");
+
+#define IS_LONG(s) (JSTR_TAG(s) == JSTR_LONG)
+/* the cap field loses a byte to the tag */
+#define CAP_MAX (SIZE_MAX >> 8)
+
+static char *data(jstr *s)
+{
+	return IS_LONG(s) ? s->big.ptr : (char *)s->small;
+}
+
+/* sets the length and puts the '\0' after it */
+static void setlen(jstr *s, size_t len)
+{
+	if (IS_LONG(s)) {
+		s->big.len = len;
+		s->big.ptr[len] = '\0';
+	} else {
+		JSTR_TAG(s) = (unsigned char)len;
+		s->small[len] = '\0';
+	}
+}
+
+size_t jstr_cap(const jstr *s)
+{
+	return IS_LONG(s) ? s->big.cap : JSTR_SSO;
+}
+
+int jstr_reserve(jstr *s, size_t cap)
+{
+	size_t have = IS_LONG(s) ? s->big.cap + 1 : 0;
+	size_t len = jstr_len(s);
+	char *p;
+
+	if (cap <= jstr_cap(s))
+		return 0;
+	if (cap >= CAP_MAX) {
+		errno = ENOMEM;
+		return -1;
+	}
+	/* the '\0' needs a byte of its own */
+	p = jgrow(IS_LONG(s) ? s->big.ptr : NULL, &have, cap + 1, 1);
+	if (p == NULL)
+		return -1;
+	if (!IS_LONG(s))
+		jmemcpy(p, s->small, len + 1);
+	s->big.ptr = p;
+	s->big.len = len;
+	s->big.cap = have - 1 < CAP_MAX ? have - 1 : CAP_MAX;
+	JSTR_TAG(s) = JSTR_LONG;
+	return 0;
+}
+
+int jstr_set(jstr *s, const char *p, size_t n)
+{
+	if (jstr_reserve(s, n) < 0)
+		return -1;
+	/* `p` may be inside `s` already */
+	jmemmove(data(s), p, n);
+	setlen(s, n);
+	return 0;
+}
+
+int jstr_append(jstr *s, const char *p, size_t n)
+{
+	return jstr_insert(s, jstr_len(s), p, n);
+}
+
+int jstr_insert(jstr *s, size_t pos, const char *p, size_t n)
+{
+	size_t len = jstr_len(s);
+	uintptr_t from = (uintptr_t)data(s);
+	uintptr_t off = (uintptr_t)p - from;
+	bool inside = (uintptr_t)p >= from && off <= len;
+	char *d;
+
+	if (pos > len) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (n > CAP_MAX - len) {
+		errno = ENOMEM;
+		return -1;
+	}
+	if (jstr_reserve(s, len + n) < 0)
+		return -1;
+	d = data(s);
+	/* the bytes may have moved with the buffer, and the gap shifts them */
+	if (inside) {
+		p = d + off;
+		if (off >= pos)
+			p += n;
+	}
+	jmemmove(d + pos + n, d + pos, len - pos);
+	if (inside && off < pos && off + n > pos) {
+		/* the source straddles the gap */
+		jmemmove(d + pos, p, pos - off);
+		jmemmove(d + 2 * pos - off, d + pos + n, n - (pos - off));
+	} else {
+		jmemmove(d + pos, p, n);
+	}
+	setlen(s, len + n);
+	return 0;
+}
+
+int jstr_slice(jstr *s, size_t pos, size_t n)
+{
+	size_t len = jstr_len(s);
+	char *d = data(s);
+
+	if (pos > len) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (n > len - pos)
+		n = len - pos;
+	jmemmove(d, d + pos, n);
+	setlen(s, n);
+	return 0;
+}
+
+int jstr_cmp(const jstr *a, const jstr *b)
+{
+	size_t la = jstr_len(a);
+	size_t lb = jstr_len(b);
+	int r = jmemcmp(jstr_cstr(a), jstr_cstr(b), la < lb ? la : lb);
+
+	if (r != 0)
+		return r;
+	return (la > lb) - (la < lb);
+}
+
+size_t jstr_find(const jstr *s, const char *p, size_t n, size_t from)
+{
+	const char *d = jstr_cstr(s);
+	size_t len = jstr_len(s);
+
+	if (from > len || n > len - from)
+		return JSTR_NPOS;
+	if (n == 0)
+		return from;
+	/* look for the first byte, let jmemcmp() check the rest */
+	for (size_t i = from; i <= len - n; i++) {
+		if (d[i] == p[0] && jmemcmp(d + i + 1, p + 1, n - 1) == 0)
+			return i;
+	}
+	return JSTR_NPOS;
+}
+
+void jstr_free(jstr *s)
+{
+	if (IS_LONG(s))
+		jfree(s->big.ptr);
+	jmemset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,241 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstring.h"
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * The string functions read 16 bytes at a time, also past the '\0' when it's
+ * somewhere in the middle. That is only safe while the 16 bytes are on the
+ * same page as the first one, which nothing smaller than a page can change.
+ * Aligned loads always are. For unaligned ones the distance to the next page
+ * end is worked out first, vectors go up to it and the last few bytes before
+ * it are taken one at a time.
+ */
+#define PAGE 4096 /* the smallest page size there is */
+
+/* flips the case of c if it's one of the 26 letters from `lo` on */
+static inline unsigned char flip(unsigned char c, unsigned char lo)
+{
+	return (unsigned char)(c - lo) < 26 ? c ^ 0x20 : c;
+}
+
+static inline unsigned char lower(unsigned char c)
+{
+	return flip(c, 'A');
+}
+
+#if defined(__SSE2__)
+/*
+ * The same on 16 bytes. Adding 0x80 - lo moves the 26 letters to the bottom
+ * of the signed range, where one compare picks them out.
+ */
+static inline __m128i vflip(__m128i v, unsigned char lo)
+{
+	__m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+	__m128i in = _mm_cmplt_epi8(t, _mm_set1_epi8((char)(0x80 + 26)));
+
+	return _mm_xor_si128(v, _mm_and_si128(in, _mm_set1_epi8(0x20)));
+}
+
+/* bit i is set where the folded bytes differ */
+static inline uint32_t differ(__m128i a, __m128i b)
+{
+	__m128i eq = _mm_cmpeq_epi8(vflip(a, 'A'), vflip(b, 'A'));
+
+	return (uint32_t)_mm_movemask_epi8(eq) ^ 0xffff;
+}
+
+static inline uint32_t zeros(__m128i v)
+{
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+}
+#endif
+
+#if defined(__SSE2__)
+/*
+ * Compares up to `n` bytes of the strings, stopping early at a difference or
+ * the '\0' of `a`. Returns the offset where it stopped, `n` if it didn't,
+ * `n` being a multiple of 16.
+ */
+static inline size_t vcmp(const unsigned char *a, const unsigned char *b,
+			  size_t n)
+{
+	size_t i = 0;
+	uint32_t m;
+
+	for (; i + 32 <= n; i += 32) {
+		__m128i a0 = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i b0 = _mm_loadu_si128((const __m128i *)(b + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(a + i + 16));
+		__m128i b1 = _mm_loadu_si128((const __m128i *)(b + i + 16));
+
+		m = differ(a0, b0) | zeros(a0) |
+		    (differ(a1, b1) | zeros(a1)) << 16;
+		if (m)
+			return i + __builtin_ctz(m);
+	}
+	if (i + 16 <= n) {
+		__m128i a0 = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i b0 = _mm_loadu_si128((const __m128i *)(b + i));
+
+		if ((m = differ(a0, b0) | zeros(a0)) != 0)
+			return i + __builtin_ctz(m);
+		i += 16;
+	}
+	return i;
+}
+#endif
+
+/* bytes from p to the end of its page */
+static inline size_t page_left(const void *p)
+{
+	return PAGE - ((uintptr_t)p & (PAGE - 1));
+}
+
+int jstrncasecmp(const char *s1, const char *s2, size_t n)
+{
+	const unsigned char *a = (const unsigned char *)s1;
+	const unsigned char *b = (const unsigned char *)s2;
+	size_t run;
+
+	while (n) {
+		/* as far as both can be read in whole vectors */
+		run = page_left(a) < page_left(b) ? page_left(a) : page_left(b);
+		if (run > n)
+			run = n;
+#if defined(__SSE2__)
+		size_t i = vcmp(a, b, run & ~(size_t)15);
+
+		if (i < (run & ~(size_t)15))
+			return lower(a[i]) - lower(b[i]);
+		a += i;
+		b += i;
+		n -= i;
+		run -= i;
+#endif
+		/* what is left before a page ends, or of `n` */
+		for (; run; run--, n--, a++, b++) {
+			if (lower(*a) != lower(*b) || !*a)
+				return lower(*a) - lower(*b);
+		}
+	}
+	return 0;
+}
+
+int jstrcasecmp(const char *s1, const char *s2)
+{
+	return jstrncasecmp(s1, s2, SIZE_MAX);
+}
+
+int jmemcasecmp(const void *s1, const void *s2, size_t n)
+{
+	const unsigned char *a = (const unsigned char *)s1;
+	const unsigned char *b = (const unsigned char *)s2;
+
+#if defined(__SSE2__)
+	/* all n bytes are there to read, no need to mind the pages */
+	for (; n >= 16; a += 16, b += 16, n -= 16) {
+		uint32_t m = differ(_mm_loadu_si128((const __m128i *)a),
+				    _mm_loadu_si128((const __m128i *)b));
+
+		if (m)
+			return lower(a[__builtin_ctz(m)]) -
+			       lower(b[__builtin_ctz(m)]);
+	}
+#endif
+	for (; n; a++, b++, n--) {
+		if (lower(*a) != lower(*b))
+			return lower(*a) - lower(*b);
+	}
+	return 0;
+}
+
+static char *strflip(char *s, unsigned char lo)
+{
+	unsigned char *p = (unsigned char *)s;
+
+#if defined(__SSE2__)
+	/* up to a 16 byte boundary, from there on the loads are aligned */
+	for (; (uintptr_t)p & 15; p++) {
+		if (!*p)
+			return s;
+		*p = flip(*p, lo);
+	}
+	for (;; p += 16) {
+		__m128i v = _mm_load_si128((const __m128i *)p);
+
+		/* the bytes after the '\0' aren't ours to write */
+		if (zeros(v))
+			break;
+		_mm_store_si128((__m128i *)p, vflip(v, lo));
+	}
+#endif
+	for (; *p; p++)
+		*p = flip(*p, lo);
+	return s;
+}
+
+char *jstrtolower(char *s)
+{
+	return strflip(s, 'A');
+}
+
+char *jstrtoupper(char *s)
+{
+	return strflip(s, 'a');
+}
+
+static void *memflip(void *dest, const void *src, size_t n, unsigned char lo)
+{
+	unsigned char *d = (unsigned char *)dest;
+	const unsigned char *s = (const unsigned char *)src;
+
+#if defined(__SSE2__)
+	/* two vectors a round, the loads of one overlap the other's work */
+	for (; n >= 32; d += 32, s += 32, n -= 32) {
+		__m128i a = _mm_loadu_si128((const __m128i *)s);
+		__m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+
+		_mm_storeu_si128((__m128i *)d, vflip(a, lo));
+		_mm_storeu_si128((__m128i *)(d + 16), vflip(b, lo));
+	}
+	if (n >= 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)s);
+
+		_mm_storeu_si128((__m128i *)d, vflip(a, lo));
+		d += 16;
+		s += 16;
+		n -= 16;
+	}
+#endif
+	for (; n; d++, s++, n--)
+		*d = flip(*s, lo);
+	return dest;
+}
+
+void *jmemtolower(void *dest, const void *src, size_t n)
+{
+	return memflip(dest, src, n, 'A');
+}
+
+void *jmemtoupper(void *dest, const void *src, size_t n)
+{
+	return memflip(dest, src, n, 'a');
+}
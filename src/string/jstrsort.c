@@ -0,0 +1,194 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+/*
+ * Multikey quicksort (Bentley and Sedgewick) on eight characters at a time,
+ * with the eight cached next to each pointer (Rantala's "cache8"). Sorting
+ * strings one comparison at a time goes back to their common prefixes over
+ * and over, following every pointer to do it; here each string is read once
+ * per eight characters of depth, and partitioning runs over an array of
+ * 16-byte entries that the prefetcher can keep up with.
+ *
+ * The three-way partition splits a group by its current key into smaller,
+ * equal and greater. The equal ones share eight more characters, so they
+ * reload their keys eight deeper and go on, unless the key held their end.
+ */
+
+#include "jmm.h"
+#include "jstdlib.h"
+#include "jstring.h"
+#include <stdint.h>
+
+#define INSERTION 32 /* groups below this are insertion sorted */
+#define PAGE 4096
+
+struct ent {
+	uint64_t key; /* 8 characters from the current depth on, first on top */
+	char *s;
+};
+
+/*
+ * The eight characters at s, zero from the terminator on. The first goes
+ * in the top byte, so keys compare like the strings do.
+ */
+static inline uint64_t load_key(const char *s)
+{
+	uint64_t k = 0;
+	uint64_t z;
+
+	if (((uintptr_t)s & (PAGE - 1)) > PAGE - 8) {
+		/* the rest of the page might be all there is */
+		for (int i = 0; i < 8 && s[i]; i++)
+			k |= (uint64_t)(unsigned char)s[i] << (56 - 8 * i);
+		return k;
+	}
+	jmemcpy(&k, s, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	k = __builtin_bswap64(k);
+#endif
+	/* the top bit of every zero byte, nothing else */
+	z = ~(((k & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | k |
+	      0x7f7f7f7f7f7f7f7fULL);
+	if (z) {
+		int keep = __builtin_clzll(z) & ~7;
+
+		k = keep ? k & ~0ULL << (64 - keep) : 0;
+	}
+	return k;
+}
+
+/* a key whose last character isn't zero continues past it */
+static inline bool ended(uint64_t key)
+{
+	return (key & 0xff) == 0;
+}
+
+static inline int compare(const struct ent *a, const struct ent *b,
+			  size_t depth)
+{
+	if (a->key != b->key)
+		return a->key < b->key ? -1 : 1;
+	if (ended(a->key))
+		return 0;
+	return jstrcmp(a->s + depth + 8, b->s + depth + 8);
+}
+
+static void insertion(struct ent *e, size_t n, size_t depth)
+{
+	for (size_t i = 1; i < n; i++) {
+		struct ent t = e[i];
+		size_t j = i;
+
+		for (; j > 0 && compare(&t, &e[j - 1], depth) < 0; j--)
+			e[j] = e[j - 1];
+		e[j] = t;
+	}
+}
+
+static inline uint64_t median3(uint64_t a, uint64_t b, uint64_t c)
+{
+	if (a > b) {
+		uint64_t t = a;
+
+		a = b;
+		b = t;
+	}
+	return c <= a ? a : c >= b ? b : c;
+}
+
+static inline void swap(struct ent *a, struct ent *b)
+{
+	struct ent t = *a;
+
+	*a = *b;
+	*b = t;
+}
+
+/*
+ * Sorts the n entries at e, which agree on their first `depth` characters
+ * and have their keys loaded from there. The two smaller of the three parts
+ * are recursed into and the biggest is looped on, so the stack only grows
+ * with the log of n.
+ */
+static void sort(struct ent *e, size_t n, size_t depth)
+{
+	while (n >= INSERTION) {
+		uint64_t pivot = median3(e[0].key, e[n / 2].key, e[n - 1].key);
+		size_t lt = 0;
+		size_t gt = n;
+
+		for (size_t i = 0; i < gt;) {
+			if (e[i].key < pivot)
+				swap(&e[lt++], &e[i++]);
+			else if (e[i].key > pivot)
+				swap(&e[i], &e[--gt]);
+			else
+				i++;
+		}
+
+		size_t eq = gt - lt;
+		size_t hi = n - gt;
+		bool deeper = !ended(pivot);
+
+		/* a group that ended here is sorted already */
+		if (deeper)
+			for (size_t i = lt; i < gt; i++)
+				e[i].key = load_key(e[i].s + depth + 8);
+		else
+			eq = 0;
+
+		if (eq >= lt && eq >= hi) {
+			sort(e, lt, depth);
+			sort(e + gt, hi, depth);
+			e += lt;
+			n = eq;
+			depth += 8;
+		} else if (lt >= hi) {
+			sort(e + lt, eq, depth + 8);
+			sort(e + gt, hi, depth);
+			n = lt;
+		} else {
+			sort(e, lt, depth);
+			sort(e + lt, eq, depth + 8);
+			e += gt;
+			n = hi;
+		}
+	}
+	insertion(e, n, depth);
+}
+
+static int by_strcmp(const void *a, const void *b)
+{
+	return jstrcmp(*(char *const *)a, *(char *const *)b);
+}
+
+void jstrsort(char **v, size_t n)
+{
+	struct ent small[INSERTION];
+	struct ent *e = small;
+
+	if (n > INSERTION && !(e = jmalloc(n * sizeof(*e)))) {
+		jqsort(v, n, sizeof(*v), by_strcmp);
+		return;
+	}
+	for (size_t i = 0; i < n; i++)
+		e[i] = (struct ent){ load_key(v[i]), v[i] };
+	sort(e, n, 0);
+	for (size_t i = 0; i < n; i++)
+		v[i] = e[i].s;
+	if (e != small)
+		jfree(e);
+}
@@ -0,0 +1,322 @@
+/* nstdlib - C standard library implementation done as a study exercise.
+Copyright (C) 2026  Emir Baha Yıldırım
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "jstring.h"
+#include <stdbool.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define HAVE_SSSE3 1
+#endif
+
+#define BLOCK 64
+
+typedef uint64_t __attribute__((may_alias, aligned(1))) u64u;
+
+/*
+ * The length of a valid sequence, and the smallest and biggest its second
+ * byte can be, by lead byte. 0 for bytes that can't lead one. The limits
+ * on the second byte rule out overlongs (E0, F0), surrogates (ED) and code
+ * points past U+10FFFF (F4).
+ */
+static const struct {
+	uint8_t len, lo, hi;
+} lead[64] = {
+	/* C0 and C1 could only be overlongs */
+	[0x02 ... 0x1f] = { 2, 0x80, 0xbf },
+	[0x20] = { 3, 0xa0, 0xbf },
+	[0x21 ... 0x2c] = { 3, 0x80, 0xbf },
+	[0x2d] = { 3, 0x80, 0x9f },
+	[0x2e ... 0x2f] = { 3, 0x80, 0xbf },
+	[0x30] = { 4, 0x90, 0xbf },
+	[0x31 ... 0x33] = { 4, 0x80, 0xbf },
+	[0x34] = { 4, 0x80, 0x8f },
+};
+
+static bool ascii8(const unsigned char *p)
+{
+	return (*(const u64u *)p & 0x8080808080808080ULL) == 0;
+}
+
+/*
+ * One byte (or eight ASCII ones) at a time, the way every other function
+ * here started out. It finds the exact place of an error the vector code
+ * only narrows down to a block.
+ */
+static size_t scalar(const unsigned char *s, size_t n)
+{
+	size_t i = 0;
+
+	while (i < n) {
+		unsigned char c = s[i];
+
+		if (c < 0x80) {
+			if (i + 8 <= n && ascii8(s + i))
+				i += 8;
+			else
+				i++;
+			continue;
+		}
+		if (c < 0xc0 || c > 0xf4)
+			return i;
+		size_t len = lead[c - 0xc0].len;
+
+		if (!len || n - i < len || s[i + 1] < lead[c - 0xc0].lo ||
+		    s[i + 1] > lead[c - 0xc0].hi)
+			return i;
+		for (size_t k = 2; k < len; k++) {
+			if ((s[i + k] & 0xc0) != 0x80)
+				return i;
+		}
+		i += len;
+	}
+	return JSTR_NPOS;
+}
+
+#if defined(HAVE_SSSE3)
+/*
+ * The lookup table algorithm of Keiser and Lemire. Almost every way a byte
+ * can be wrong shows in the pair it makes with the byte before it: the high
+ * nibble of the first, its low nibble and the high nibble of the second each
+ * look up a set of errors the pair might have, and the pair has one when a
+ * bit is set in all three. What the pairs can't show, a third or fourth byte
+ * with no lead two or three bytes back or the other way round, is checked on
+ * its own.
+ */
+#define TOO_SHORT (1 << 0)  /* a lead or ASCII where a continuation goes */
+#define TOO_LONG (1 << 1)   /* a continuation after ASCII */
+#define OVERLONG_3 (1 << 2) /* E0 80..9F */
+#define TOO_LARGE (1 << 3)  /* F4 90..BF, F5..FF */
+#define SURROGATE (1 << 4)  /* ED A0..BF */
+#define OVERLONG_2 (1 << 5) /* C0..C1 */
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4 (1 << 6) /* F0 80..8F */
+#define TWO_CONTS (1 << 7)  /* two continuations, fine if a lead was before */
+#define CARRY (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+#define V(...) _mm_setr_epi8(__VA_ARGS__)
+
+struct state {
+	__m128i prev;       /* the last vector of the previous block */
+	__m128i incomplete; /* its last bytes still wanted continuations */
+	__m128i err;
+};
+
+__attribute__((target("ssse3"))) static inline __m128i
+hi_nibble(__m128i v)
+{
+	return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f));
+}
+
+__attribute__((target("ssse3"))) static inline __m128i check(__m128i in,
+							   __m128i prev)
+{
+	const __m128i hi1 = V(TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+			      TOO_LONG, TOO_LONG, TOO_LONG, TWO_CONTS,
+			      TWO_CONTS, TWO_CONTS, TWO_CONTS,
+			      TOO_SHORT | OVERLONG_2, TOO_SHORT,
+			      TOO_SHORT | OVERLONG_3 | SURROGATE,
+			      TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 |
+				      OVERLONG_4);
+	const __m128i lo1 = V(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+			      CARRY | OVERLONG_2, CARRY, CARRY,
+			      CARRY | TOO_LARGE,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000,
+			      CARRY | TOO_LARGE | TOO_LARGE_1000);
+	const __m128i hi2 =
+		V(TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+		  TOO_SHORT, TOO_SHORT, TOO_SHORT,
+		  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 |
+			  TOO_LARGE_1000 | OVERLONG_4,
+		  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+		  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+		  TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+		  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+	__m128i p1 = _mm_alignr_epi8(in, prev, 15);
+	__m128i p2 = _mm_alignr_epi8(in, prev, 14);
+	__m128i p3 = _mm_alignr_epi8(in, prev, 13);
+	__m128i sc = _mm_and_si128(
+		_mm_and_si128(_mm_shuffle_epi8(hi1, hi_nibble(p1)),
+			      _mm_shuffle_epi8(lo1, _mm_and_si128(
+						     p1, _mm_set1_epi8(0x0f)))),
+		_mm_shuffle_epi8(hi2, hi_nibble(in)));
+	/* top bit set where a lead of 3 or 4 is 2 or 3 bytes back */
+	__m128i must23 = _mm_or_si128(
+		_mm_subs_epu8(p2, _mm_set1_epi8((char)(0xe0 - 0x80))),
+		_mm_subs_epu8(p3, _mm_set1_epi8((char)(0xf0 - 0x80))));
+
+	/* there TWO_CONTS is expected, anywhere else it's an error */
+	return _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8((char)0x80)),
+			     sc);
+}
+
+__attribute__((target("ssse3"))) static void block(struct state *st,
+						   const unsigned char *p)
+{
+	__m128i v0 = _mm_loadu_si128((const __m128i *)p);
+	__m128i v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+	__m128i v2 = _mm_loadu_si128((const __m128i *)(p + 32));
+	__m128i v3 = _mm_loadu_si128((const __m128i *)(p + 48));
+	__m128i any = _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3));
+
+	if (!_mm_movemask_epi8(any)) {
+		/* all ASCII, fine unless the last block left a sequence open */
+		st->err = _mm_or_si128(st->err, st->incomplete);
+		st->prev = st->incomplete = _mm_setzero_si128();
+		return;
+	}
+	st->err = _mm_or_si128(st->err, check(v0, st->prev));
+	st->err = _mm_or_si128(st->err, check(v1, v0));
+	st->err = _mm_or_si128(st->err, check(v2, v1));
+	st->err = _mm_or_si128(st->err, check(v3, v2));
+	/* a lead in the last three bytes wants more than there is left */
+	st->incomplete = _mm_subs_epu8(
+		v3, V(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		      (char)(0xf0 - 1), (char)(0xe0 - 1), (char)(0xc0 - 1)));
+	st->prev = v3;
+}
+
+__attribute__((target("ssse3"))) static inline bool failed(__m128i err)
+{
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) !=
+	       0xffff;
+}
+
+/*
+ * The offset of the first error, JSTR_NPOS if there's none. Once a block has
+ * one the scalar code takes over, from the start of the sequence that was
+ * open when the block began, everything before it being valid.
+ */
+__attribute__((target("ssse3"))) static size_t vfind(const unsigned char *s,
+						     size_t n)
+{
+	struct state st = { _mm_setzero_si128(), _mm_setzero_si128(),
+			    _mm_setzero_si128() };
+	unsigned char tail[BLOCK];
+	size_t i = 0;
+	size_t from;
+
+	for (; i + BLOCK <= n; i += BLOCK) {
+		block(&st, s + i);
+		if (failed(st.err))
+			goto found;
+	}
+	/* the rest padded with ASCII, which also ends any open sequence */
+	jmemset(tail, 0, BLOCK);
+	jmemcpy(tail, s + i, n - i);
+	block(&st, tail);
+	if (!failed(_mm_or_si128(st.err, st.incomplete)))
+		return JSTR_NPOS;
+found:
+	from = i;
+	for (int k = 0; k < 3 && from > 0 && (s[from - 1] & 0xc0) == 0x80; k++)
+		from--;
+	if (from > 0 && s[from - 1] >= 0xc0)
+		from--;
+	i = scalar(s + from, n - from);
+	return i == JSTR_NPOS ? JSTR_NPOS : from + i;
+}
+#endif
+
+/* the vector code wants SSSE3, which not every x86-64 machine has */
+static bool vector_ok(void)
+{
+#if defined(HAVE_SSSE3)
+	return __builtin_cpu_supports("ssse3");
+#else
+	return false;
+#endif
+}
+
+size_t jutf8_find_invalid(const void *s, size_t n)
+{
+#if defined(HAVE_SSSE3)
+	if (vector_ok())
+		return vfind(s, n);
+#endif
+	return scalar(s, n);
+}
+
+bool jutf8_validate(const void *s, size_t n)
+{
+	return jutf8_find_invalid(s, n) == JSTR_NPOS;
+}
+
+#if defined(__SSE2__)
+static inline size_t hsum(__m128i v)
+{
+	v = _mm_sad_epu8(v, _mm_setzero_si128());
+	return (size_t)_mm_cvtsi128_si32(v) + (size_t)_mm_extract_epi16(v, 4);
+}
+#endif
+
+size_t jutf8_count(const void *s, size_t n)
+{
+	const unsigned char *p = (const unsigned char *)s;
+	size_t cnt = 0;
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	/*
+	 * Every byte but a continuation (0x80 to 0xbf, -128 to -65 signed)
+	 * starts a code point. The compares give -1 for each, and the byte
+	 * lanes add up to 4 a round for 63 rounds before they're summed.
+	 */
+	__m128i c = _mm_set1_epi8(-65);
+	__m128i sum = _mm_setzero_si128();
+	int rounds = 0;
+
+	for (; i + BLOCK <= n; i += BLOCK) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(p + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(p + i + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(p + i + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(p + i + 48));
+		__m128i any = _mm_or_si128(_mm_or_si128(v0, v1),
+					   _mm_or_si128(v2, v3));
+		__m128i k;
+
+		if (!_mm_movemask_epi8(any)) {
+			cnt += BLOCK;
+			continue;
+		}
+		k = _mm_add_epi8(_mm_cmpgt_epi8(v0, c), _mm_cmpgt_epi8(v1, c));
+		k = _mm_add_epi8(k, _mm_cmpgt_epi8(v2, c));
+		k = _mm_add_epi8(k, _mm_cmpgt_epi8(v3, c));
+		sum = _mm_sub_epi8(sum, k);
+		if (++rounds == 63) {
+			cnt += hsum(sum);
+			sum = _mm_setzero_si128();
+			rounds = 0;
+		}
+	}
+	cnt += hsum(sum);
+#endif
+	for (; i < n; i++)
+		cnt += (p[i] & 0xc0) != 0x80;
+	return cnt;
+}
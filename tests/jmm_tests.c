@@ -4,10 +4,16 @@ Copyright (C) 2026  Emir Baha Yıldırım */
 
 #include "jmm.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
 
 extern bool g_test_failed;
 
@@ -19,6 +25,26 @@ extern bool g_test_failed;
 		g_test_failed = true;       \
 	} while (0)
 
+#if ((defined(__TEST_JFREE) || defined(__TEST_JHEAP)) && \
+     defined(JMM_HARDENED)) ||                              \
+    defined(__TEST_JGUARD)
+/* runs `fn` in a child, true if it was killed by `sig` */
+static bool dies_of(void (*fn)(void), int sig)
+{
+	int status;
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		/* keep the expected report out of the test output */
+		freopen("/dev/null", "w", stderr);
+		fn();
+		_exit(0);
+	}
+	return pid > 0 && waitpid(pid, &status, 0) == pid &&
+	       WIFSIGNALED(status) && WTERMSIG(status) == sig;
+}
+#endif
+
 /* --- jmalloc Tests --- */
 #if defined(__TEST_JMALLOC)
 static void jmalloc_basic_allocation()
@@ -105,12 +131,125 @@ static void jmalloc_multiple_allocations()
 	jfree(p3);
 }
 
+static void jmalloc_growth_policy()
+{
+	TEST_PRINT("jmalloc: jmallopt() and geometric chunk growth");
+	if (jmallopt(JM_GROWTH, 2) == 1 && jmallopt(JM_PREFAULT, 0) == 1) {
+		TEST_PASS("jmallopt accepted valid parameters.");
+	} else {
+		TEST_FAIL("jmallopt rejected valid parameters.");
+	}
+	if (jmallopt(-1, 0) == 0 && jmallopt(JM_GROWTH, -1) == 0) {
+		TEST_PASS("jmallopt rejected invalid parameters.");
+	} else {
+		TEST_FAIL("jmallopt accepted invalid parameters.");
+	}
+
+	/* a stream of 5 KB blocks must not cost one chunk per allocation */
+	void *ptrs[64];
+	void *before = sbrk(0);
+	for (int i = 0; i < 64; i++)
+		ptrs[i] = jmalloc(5 * 1024);
+	if ((size_t)(sbrk(0) - before) < 8 * BLOCK_MID) {
+		TEST_PASS("jmalloc carved 5 KB blocks out of shared chunks.");
+	} else {
+		TEST_FAIL("jmalloc grew the heap once per 5 KB block.");
+	}
+	for (int i = 0; i < 64; i++)
+		jfree(ptrs[i]);
+}
+
+static void jmalloc_best_fit()
+{
+	TEST_PRINT("jmalloc: Best fit among free blocks");
+	void *big = jmalloc(2048);
+	void *sep1 = jmalloc(64);
+	void *small = jmalloc(256);
+	void *sep2 = jmalloc(64);
+	if (!big || !sep1 || !small || !sep2) {
+		TEST_FAIL("jmalloc: Best fit test setup failed.");
+		return;
+	}
+
+	jfree(big);
+	jfree(small);
+	void *p = jmalloc(200); // both fit, the 256 byte hole is the best one
+	if (p == small) {
+		TEST_PASS("jmalloc: Picked the smallest hole that fits.");
+	} else {
+		TEST_FAIL("jmalloc: Split a bigger hole than necessary.");
+	}
+	jfree(p);
+	jfree(sep1);
+	jfree(sep2);
+}
+
+static void jmalloc_calloc()
+{
+	TEST_PRINT("jcalloc: Zeroed memory and overflow");
+	uint8_t *p = jmalloc(512);
+	memset(p, 0xFF, 512);
+	jfree(p);
+	uint8_t *q = jcalloc(64, 8); // likely reuses the dirty block
+	bool zero = q != NULL;
+	for (size_t i = 0; zero && i < 512; i++)
+		zero = q[i] == 0;
+	if (zero) {
+		TEST_PASS("jcalloc returned zeroed memory.");
+	} else {
+		TEST_FAIL("jcalloc returned dirty memory.");
+	}
+	jfree(q);
+
+	if (jcalloc(SIZE_MAX / 2, 4) == NULL) {
+		TEST_PASS("jcalloc caught nmemb * size overflowing.");
+	} else {
+		TEST_FAIL("jcalloc didn't catch nmemb * size overflowing.");
+	}
+}
+
+static void jmalloc_aligned()
+{
+	TEST_PRINT("jaligned_alloc: Alignment and usable size");
+	size_t aligns[] = { 16, 64, 256, 4096, 65536 };
+	size_t sizes[] = { 1, 100, 5000, 2 * MMAP_THRESHOLD };
+	bool ok = true;
+	for (size_t a = 0; a < sizeof(aligns) / sizeof(aligns[0]); a++) {
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			uint8_t *p = jaligned_alloc(aligns[a], sizes[s]);
+			if (!p || (uintptr_t)p % aligns[a] ||
+			    jmalloc_usable_size(p) < sizes[s]) {
+				ok = false;
+				jfree(p);
+				continue;
+			}
+			memset(p, 0x5A, sizes[s]);
+			jfree(p);
+		}
+	}
+	if (ok) {
+		TEST_PASS("jaligned_alloc honoured every alignment.");
+	} else {
+		TEST_FAIL("jaligned_alloc returned a misaligned or short block.");
+	}
+
+	if (jaligned_alloc(48, 100) == NULL) {
+		TEST_PASS("jaligned_alloc rejected a non power of two.");
+	} else {
+		TEST_FAIL("jaligned_alloc accepted a non power of two.");
+	}
+}
+
 void test_jmalloc()
 {
 	jmalloc_basic_allocation();
 	jmalloc_zero_allocation();
 	jmalloc_huge_allocation();
 	jmalloc_multiple_allocations();
+	jmalloc_best_fit();
+	jmalloc_calloc();
+	jmalloc_aligned();
+	jmalloc_growth_policy();
 }
 #endif
 
@@ -196,11 +335,87 @@ static void jfree_stress()
 	TEST_PASS("jfree: Stress test cleanup successful.");
 }
 
+static void jfree_remote()
+{
+	TEST_PRINT("jfree: Deferred free while the heap is busy");
+	jmallopt(JM_REMOTE_FREE, 1);
+	void *p1 = jmalloc(160);
+	void *sep = jmalloc(64);
+
+	/* stand in for another thread holding the heap */
+	jmm_lock();
+	jfree(p1);
+	bool pending = !((header *)p1 - 1)->is_free;
+	jmm_unlock();
+	if (pending) {
+		TEST_PASS("jfree queued the block instead of waiting.");
+	} else {
+		TEST_FAIL("jfree touched the heap without the lock.");
+	}
+
+	void *p2 = jmalloc(160);
+	if (p2 == p1) {
+		TEST_PASS("jmalloc drained the queue and reused the block.");
+	} else {
+		TEST_FAIL("jmalloc didn't reuse the queued block.");
+	}
+	jfree(p2);
+	jfree(sep);
+}
+
+#if defined(JMM_HARDENED)
+static void jfree_twice()
+{
+	void *p = jmalloc(200);
+	void *sep = jmalloc(200);
+	jfree(p);
+	jfree(p);
+	jfree(sep);
+}
+
+static void jfree_overflow()
+{
+	char *p = jmalloc(100);
+	memset(p, 'x', jmalloc_usable_size(p) + 1);
+	jfree(p);
+}
+
+static void jfree_wild()
+{
+	char *p = jmalloc(100);
+	jfree(p + 32);
+}
+
+static void jfree_hardened()
+{
+	TEST_PRINT("jfree: Hardened mode catches misuse");
+	if (dies_of(jfree_twice, SIGABRT)) {
+		TEST_PASS("Double free aborted.");
+	} else {
+		TEST_FAIL("Double free went unnoticed.");
+	}
+	if (dies_of(jfree_overflow, SIGABRT)) {
+		TEST_PASS("Write past the end aborted.");
+	} else {
+		TEST_FAIL("Write past the end went unnoticed.");
+	}
+	if (dies_of(jfree_wild, SIGABRT)) {
+		TEST_PASS("Wild pointer aborted.");
+	} else {
+		TEST_FAIL("Wild pointer went unnoticed.");
+	}
+}
+#endif
+
 void test_jfree()
 {
 	jfree_null();
 	jfree_coalescing();
 	jfree_stress();
+	jfree_remote();
+#if defined(JMM_HARDENED)
+	jfree_hardened();
+#endif
 }
 #endif
 
@@ -297,6 +512,681 @@ void test_jrealloc_relocate()
 	jfree(p3);
 	jfree(p2);
 }
+
+void test_jreallocarray()
+{
+	TEST_PRINT("jreallocarray rejects overflowing sizes");
+	void *p = jmalloc(64);
+	errno = 0;
+	void *q = jreallocarray(p, SIZE_MAX / 2, 3);
+	if (q == NULL && errno == ENOMEM) {
+		TEST_PASS("jreallocarray failed with ENOMEM.");
+	} else {
+		TEST_FAIL("jreallocarray let nmemb * size wrap around.");
+	}
+	q = jreallocarray(p, 100, sizeof(int));
+	if (q && jmalloc_usable_size(q) >= 100 * sizeof(int)) {
+		TEST_PASS("jreallocarray resized the array.");
+	} else {
+		TEST_FAIL("jreallocarray didn't resize the array.");
+	}
+	jfree(q);
+}
+
+void test_jgrow()
+{
+	TEST_PRINT("jgrow push_back loop");
+	int *v = NULL;
+	size_t cap = 0, moves = 0;
+	bool ok = true;
+	for (int i = 0; i < 100000; i++) {
+		if ((size_t)i == cap) {
+			int *n = jgrow(v, &cap, (size_t)i + 1, sizeof(int));
+			if (!n) {
+				ok = false;
+				break;
+			}
+			moves += n != v;
+			v = n;
+		}
+		v[i] = i;
+	}
+	for (int i = 0; ok && i < 100000; i++)
+		ok = v[i] == i;
+	if (ok && cap * sizeof(int) <= jmalloc_usable_size(v) &&
+	    (cap + 1) * sizeof(int) > jmalloc_usable_size(v)) {
+		TEST_PASS("jgrow kept the data and the capacity matches the block.");
+	} else {
+		TEST_FAIL("jgrow lost data or misreported the capacity.");
+	}
+	printf("  100000 pushes, %zu relocations.\n", moves);
+	if (moves < 40) {
+		TEST_PASS("jgrow grew geometrically.");
+	} else {
+		TEST_FAIL("jgrow relocated too often.");
+	}
+
+	size_t big = SIZE_MAX / 8;
+	errno = 0;
+	if (jgrow(v, &cap, big, 16) == NULL && errno == ENOMEM) {
+		TEST_PASS("jgrow refused an overflowing size.");
+	} else {
+		TEST_FAIL("jgrow let min * size wrap around.");
+	}
+	jfree(v);
+}
+
+/* the last block of the default heap, from any block in it */
+static header *heap_tail(header *h)
+{
+	while (h->next)
+		h = h->next;
+	return h;
+}
+
+void test_jrealloc_topgrow()
+{
+	TEST_PRINT("jrealloc grow at the heap top (Path 3)");
+	/*
+	 * Earlier tests leave free space at the top, more than fits under
+	 * MMAP_THRESHOLD. Fill it, then start a small chunk for the block.
+	 */
+	void *fill[64];
+	int nfill = 0;
+	void *probe = jmalloc(64);
+	header *t = heap_tail((header *)probe - 1);
+	while (nfill < 64 && t->is_free && (void *)t + t->size == sbrk(0)) {
+		size_t n = t->size - 2 * sizeof(header);
+		if (n > MMAP_THRESHOLD - 2 * sizeof(header))
+			n = MMAP_THRESHOLD - 2 * sizeof(header);
+		fill[nfill++] = jmalloc(n);
+		t = heap_tail((header *)probe - 1);
+	}
+	jmallopt(JM_GROWTH, 1);
+	size_t first = BLOCK_MID - 2 * sizeof(header);
+	void *p1 = jmalloc(first);
+	jmallopt(JM_GROWTH, 2);
+	header *h = (header *)p1 - 1;
+	t = h && h->next && h->next->is_free ? h->next : h;
+	size_t room = (void *)t + t->size - p1;
+	if (!p1 || t->next || (void *)t + t->size != sbrk(0) ||
+	    room + BLOCK_LIT + sizeof(header) > MMAP_THRESHOLD) {
+		printf("  block isn't at the program break, skipping.\n");
+		jfree(p1);
+		for (int i = 0; i < nfill; i++)
+			jfree(fill[i]);
+		jfree(probe);
+		return;
+	}
+	memset(p1, 0xBB, first);
+
+	/* bigger than the block and the free space behind it */
+	void *p2 = jrealloc(p1, room + BLOCK_LIT);
+	if (p2 == p1) {
+		TEST_PASS("jrealloc grew the top block in place.");
+	} else {
+		TEST_FAIL("jrealloc relocated the top block.");
+	}
+	bool match = true;
+	for (size_t i = 0; i < first; i++) {
+		if (((uint8_t *)p2)[i] != 0xBB) {
+			match = false;
+			break;
+		}
+	}
+	if (match) {
+		TEST_PASS("Data preserved after growing at the top.");
+	} else {
+		TEST_FAIL("Data corruption after growing at the top.");
+	}
+
+	/* growing a little at a time must not move the break every time */
+	size_t size = jmalloc_usable_size(p2);
+	size_t moves = 0;
+	size_t grows = 0;
+	bool stayed = true;
+	while (p2 && size + 16 + 2 * sizeof(header) <= MMAP_THRESHOLD) {
+		void *before = sbrk(0);
+		size += 16;
+		p1 = jrealloc(p2, size);
+		stayed &= p1 == p2;
+		p2 = p1;
+		moves += sbrk(0) != before;
+		grows++;
+	}
+	printf("  %zu grows by 16 bytes, %zu break moves.\n", grows, moves);
+	if (p2 && stayed && moves < 20) {
+		TEST_PASS("jrealloc grew the top block a chunk at a time.");
+	} else {
+		TEST_FAIL("jrealloc moved the break for every small growth.");
+	}
+
+	/* past the threshold it belongs in a mapping of its own */
+	p1 = jrealloc(p2, MMAP_THRESHOLD);
+	if (p1 && ((header *)p1 - 1)->is_mmap) {
+		TEST_PASS("jrealloc moved a block past MMAP_THRESHOLD to a mapping.");
+	} else {
+		TEST_FAIL("jrealloc kept growing a huge block in the heap.");
+	}
+	jfree(p1 ? p1 : p2);
+	for (int i = 0; i < nfill; i++)
+		jfree(fill[i]);
+	jfree(probe);
+}
+
+void test_jrealloc_remap()
+{
+	TEST_PRINT("jrealloc mmap-backed block (Path 0)");
+	size_t small = 2 * MMAP_THRESHOLD;
+	size_t big = 8 * MMAP_THRESHOLD;
+	uint8_t *p1 = jmalloc(small);
+	if (!p1 || !((header *)p1 - 1)->is_mmap) {
+		TEST_FAIL("jmalloc didn't map a block above MMAP_THRESHOLD.");
+		jfree(p1);
+		return;
+	}
+	memset(p1, 0xAA, small);
+	p1[small - 1] = 0x55;
+
+	uint8_t *p2 = jrealloc(p1, big);
+	if (p2 == NULL) {
+		TEST_FAIL("jrealloc returned NULL while remapping.");
+		jfree(p1);
+		return;
+	}
+	bool match = p2[small - 1] == 0x55;
+	for (size_t i = 0; match && i < small - 1; i++) {
+		if (p2[i] != 0xAA)
+			match = false;
+	}
+	if (match) {
+		TEST_PASS("Data preserved after growing a mapping.");
+	} else {
+		TEST_FAIL("Data corruption after growing a mapping.");
+	}
+	memset(p2, 0x11, big);
+
+	uint8_t *p3 = jrealloc(p2, small);
+	if (p3 && p3[0] == 0x11 && p3[small - 1] == 0x11) {
+		TEST_PASS("Data preserved after shrinking a mapping.");
+	} else {
+		TEST_FAIL("Data corruption after shrinking a mapping.");
+	}
+	jfree(p3);
+}
+#endif
+
+#if defined(__TEST_JTRACE)
+void test_jtrace()
+{
+	TEST_PRINT("jtrace: Recording jmalloc/jrealloc/jfree");
+	char path[] = "/tmp/jtrace_test_XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0 || jtrace_start(path) != 0) {
+		TEST_FAIL("jtrace_start failed.");
+		return;
+	}
+	close(fd);
+
+	void *p1 = jmalloc(100);
+	void *p2 = jrealloc(p1, 5000);
+	jfree(p2);
+	jtrace_stop();
+
+	struct jtrace_rec r[4];
+	FILE *f = fopen(path, "rb");
+	size_t n = f ? fread(r, sizeof(r[0]), 4, f) : 0;
+	if (f)
+		fclose(f);
+	unlink(path);
+
+	if (n != 3) {
+		TEST_FAIL("jtrace didn't write exactly one record per call.");
+		return;
+	}
+	if (r[0].op == JT_MALLOC && r[0].size == 100 &&
+	    r[0].ptr == (uintptr_t)p1 && r[1].op == JT_REALLOC &&
+	    r[1].size == 5000 && r[1].old == (uintptr_t)p1 &&
+	    r[1].ptr == (uintptr_t)p2 && r[2].op == JT_FREE &&
+	    r[2].old == (uintptr_t)p2) {
+		TEST_PASS("jtrace records match the calls.");
+	} else {
+		TEST_FAIL("jtrace records don't match the calls.");
+	}
+	if (r[0].ts <= r[1].ts && r[1].ts <= r[2].ts && r[0].tid &&
+	    r[0].tid == r[2].tid) {
+		TEST_PASS("jtrace timestamps and thread ids are consistent.");
+	} else {
+		TEST_FAIL("jtrace timestamps or thread ids are inconsistent.");
+	}
+}
+#endif
+
+#if defined(__TEST_JPROF)
+static size_t jprof_count(const char *path, size_t *bytes)
+{
+	char line[1024];
+	size_t objs = 0;
+	FILE *f = fopen(path, "r");
+	*bytes = 0;
+	if (!f || !fgets(line, sizeof(line), f) ||
+	    sscanf(line, "heap profile: %zu: %zu", &objs, bytes) != 2)
+		objs = (size_t)-1;
+	if (f)
+		fclose(f);
+	return objs;
+}
+
+void test_jprof()
+{
+	TEST_PRINT("jprof: Sampling and dumping a heap profile");
+	char path[] = "/tmp/jprof_test_XXXXXX";
+	int fd = mkstemp(path);
+	size_t bytes;
+	if (fd < 0 || jprof_start(1) != 0) {
+		TEST_FAIL("jprof_start failed.");
+		return;
+	}
+	close(fd);
+
+	/* a rate of 1 byte samples every allocation */
+	void *p1 = jmalloc(1000);
+	void *p2 = jmalloc(3000);
+	jprof_dump(path);
+	if (jprof_count(path, &bytes) == 2 && bytes == 4000) {
+		TEST_PASS("jprof tracked both live blocks.");
+	} else {
+		TEST_FAIL("jprof didn't track the live blocks.");
+	}
+
+	jfree(p1);
+	p2 = jrealloc(p2, 5000);
+	jprof_dump(path);
+	if (jprof_count(path, &bytes) == 1 && bytes == 5000) {
+		TEST_PASS("jprof followed jfree and jrealloc.");
+	} else {
+		TEST_FAIL("jprof didn't follow jfree and jrealloc.");
+	}
+
+	/* a failed jrealloc leaves the block, and its sample, where they were */
+	bool ok = jrealloc(p2, SIZE_MAX / 2) == NULL;
+	jprof_dump(path);
+	ok &= jprof_count(path, &bytes) == 1 && bytes == 5000;
+	/* a guarded block can only move, and its old mapping goes first */
+	jmallopt(JM_GUARD, 4096);
+	void *p4 = jmalloc(6000);
+	p4 = jrealloc(p4, 7000);
+	jmallopt(JM_GUARD, 0);
+	jprof_dump(path);
+	ok &= p4 && jprof_count(path, &bytes) == 2 && bytes == 12000;
+	if (ok) {
+		TEST_PASS("jprof kept a block a jrealloc failed on, followed a move.");
+	} else {
+		TEST_FAIL("jprof lost a block a jrealloc failed on or moved.");
+	}
+	jfree(p4);
+	jfree(p2);
+
+	jprof_start(0);
+	void *p3 = jmalloc(100);
+	jprof_dump(path);
+	if (jprof_count(path, &bytes) == 0) {
+		TEST_PASS("jprof stopped sampling.");
+	} else {
+		TEST_FAIL("jprof kept sampling after being stopped.");
+	}
+	jfree(p3);
+	unlink(path);
+}
+#endif
+
+#if defined(__TEST_JCACHE)
+static void *jcache_worker(void *arg)
+{
+	uintptr_t seed = (uintptr_t)arg;
+	uint8_t *ptrs[64] = { 0 };
+	bool ok = true;
+
+	for (int i = 0; i < 20000; i++) {
+		int k = (int)((seed = seed * 6364136223846793005ULL + 1) >> 58);
+		if (ptrs[k]) {
+			for (size_t j = 0; j < 16; j++)
+				ok &= ptrs[k][j] == (uint8_t)k;
+			jfree(ptrs[k]);
+			ptrs[k] = NULL;
+		} else if ((ptrs[k] = jmalloc(16 + (size_t)k * 7))) {
+			memset(ptrs[k], k, 16);
+		}
+	}
+	for (int k = 0; k < 64; k++)
+		jfree(ptrs[k]);
+	return ok ? arg : NULL;
+}
+
+static void jcache_mode(int mode, const char *name)
+{
+	char msg[128];
+	pthread_t t[4];
+	bool ok = true;
+
+	jmallopt(JM_CACHE, mode);
+	void *p1 = jmalloc(100);
+	jfree(p1);
+	void *p2 = jmalloc(100);
+	snprintf(msg, sizeof(msg), "%s cache handed the freed block back.",
+		 name);
+	if (p2 == p1 && !((header *)p2 - 1)->is_free) {
+		TEST_PASS(msg);
+	} else {
+		TEST_FAIL(msg);
+	}
+	jfree(p2);
+
+	for (uintptr_t i = 0; i < 4; i++)
+		pthread_create(&t[i], NULL, jcache_worker, (void *)(i + 1));
+	for (int i = 0; i < 4; i++) {
+		void *r;
+		pthread_join(t[i], &r);
+		ok &= r != NULL;
+	}
+	snprintf(msg, sizeof(msg), "%s cache kept blocks intact across threads.",
+		 name);
+	if (ok) {
+		TEST_PASS(msg);
+	} else {
+		TEST_FAIL(msg);
+	}
+}
+
+/* a block freed into the cache goes back to the heap when it's turned off */
+static void jcache_leave(int from, int to, const char *name)
+{
+	char msg[128];
+
+	jmallopt(JM_CACHE, from);
+	void *p = jmalloc(100);
+	jfree(p);
+	bool cached = !((header *)p - 1)->is_free;
+	jmallopt(JM_CACHE, to);
+	snprintf(msg, sizeof(msg), "%s cache gave its blocks back on leaving.",
+		 name);
+	if (cached && ((header *)p - 1)->is_free) {
+		TEST_PASS(msg);
+	} else {
+		TEST_FAIL(msg);
+	}
+}
+
+void test_jcache()
+{
+	TEST_PRINT("jcache: Small block cache in front of the heap");
+	jcache_mode(1, "Per-CPU");
+	jcache_mode(2, "Per-thread");
+	jmallopt(JM_CACHE, 0);
+	jcache_leave(1, 2, "Per-CPU");
+	jcache_leave(2, 0, "Per-thread");
+	jcache_leave(1, 0, "Per-CPU");
+
+	void *big = jmalloc(JCACHE_MAX);
+	jmallopt(JM_CACHE, 1);
+	jfree(big);
+	if (((header *)big - 1)->is_free) {
+		TEST_PASS("jcache passed an oversized block to the heap.");
+	} else {
+		TEST_FAIL("jcache kept an oversized block.");
+	}
+	jmallopt(JM_CACHE, 0);
+}
+#endif
+
+#if defined(__TEST_JGUARD)
+/* hardened builds keep a canary between the payload and the guard page */
+#if defined(JMM_HARDENED)
+#define JGUARD_TAIL sizeof(uint64_t)
+#else
+#define JGUARD_TAIL 0
+#endif
+
+static void jguard_overrun()
+{
+	char *p = jmalloc(5000);
+	p[jmalloc_usable_size(p) + JGUARD_TAIL] = 'x';
+}
+
+static void jguard_stale_map()
+{
+	char *p = jmalloc(5000);
+	jfree(p);
+	p[0] = 'x';
+}
+
+static void jguard_stale_heap()
+{
+	char *p = jmalloc(100);
+	jfree(p);
+	p[10] = 'x';
+	/* push it out of the quarantine */
+	jmallopt(JM_QUARANTINE, 0);
+	jfree(jmalloc(100));
+}
+
+/*
+ * test_jguard() runs the binary again with JMM_GUARD set, and this answers
+ * before main(): the very first block must be guarded already.
+ */
+__attribute__((constructor)) static void jguard_first()
+{
+	if (!getenv("JGUARD_FIRST"))
+		return;
+	char *p = jmalloc(100);
+	_exit(p && ((header *)p - 1)->is_guarded ? 0 : 1);
+}
+
+static bool jguard_env()
+{
+	char *env[] = { "JMM_GUARD=16", "JGUARD_FIRST=1", NULL };
+	int status;
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		execle("/proc/self/exe", "test", (char *)NULL, env);
+		_exit(2);
+	}
+	return pid > 0 && waitpid(pid, &status, 0) == pid &&
+	       WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void test_jguard()
+{
+	TEST_PRINT("jguard: Guard pages and quarantine");
+	if (jguard_env()) {
+		TEST_PASS("JMM_GUARD guarded the very first block.");
+	} else {
+		TEST_FAIL("JMM_GUARD was read too late for the first block.");
+	}
+	jmallopt(JM_GUARD, 4096);
+	jmallopt(JM_QUARANTINE, 1 << 20);
+
+	char *p = jmalloc(5000);
+	uintptr_t end = (uintptr_t)p + jmalloc_usable_size(p) + JGUARD_TAIL;
+	if (((header *)p - 1)->is_guarded && end % sysconf(_SC_PAGESIZE) == 0) {
+		TEST_PASS("Large block ends right at a page boundary.");
+	} else {
+		TEST_FAIL("Large block isn't pushed up against its guard page.");
+	}
+	p = jrealloc(p, 9000);
+	if (p && ((header *)p - 1)->is_guarded &&
+	    jmalloc_usable_size(p) >= 9000) {
+		TEST_PASS("jrealloc moved the block to a bigger guarded one.");
+	} else {
+		TEST_FAIL("jrealloc lost the guard.");
+	}
+	jfree(p);
+
+	/* blocks resized into guard mode, grown and shrunk, get a guard too */
+	p = jmalloc(1000);
+	memset(p, 'g', 1000);
+	p = jrealloc(p, 6000);
+	bool ok = p && ((header *)p - 1)->is_guarded && p[999] == 'g';
+	jfree(p);
+	jmallopt(JM_GUARD, 0);
+	p = jmalloc(20000);
+	jmallopt(JM_GUARD, 4096);
+	memset(p, 's', 20000);
+	p = jrealloc(p, 8000);
+	ok &= p && ((header *)p - 1)->is_guarded && p[7999] == 's';
+	jfree(p);
+	if (ok) {
+		TEST_PASS("jrealloc moved blocks crossing the limit to guarded ones.");
+	} else {
+		TEST_FAIL("jrealloc resized a block past the limit in place.");
+	}
+
+	/* aligned, just short of the limit until the slack is counted in */
+	p = jaligned_alloc(64, 4001);
+	char *s = jmalloc(3000);
+	if (p && s && (uintptr_t)p % 64 == 0 &&
+	    ((header *)p - 1)->is_guarded) {
+		memset(p, 'a', 4001);
+		memset(s, 'b', 3000);
+		TEST_PASS("jaligned_alloc near the limit got a guarded block.");
+	} else {
+		TEST_FAIL("jaligned_alloc near the limit wasn't guarded.");
+	}
+	jfree(s);
+	jfree(p);
+	if (dies_of(jguard_overrun, SIGSEGV)) {
+		TEST_PASS("Running off the end faulted.");
+	} else {
+		TEST_FAIL("Running off the end went unnoticed.");
+	}
+	if (dies_of(jguard_stale_map, SIGSEGV)) {
+		TEST_PASS("Touching a freed mapped block faulted.");
+	} else {
+		TEST_FAIL("Touching a freed mapped block went unnoticed.");
+	}
+
+	uint8_t *q = jmalloc(100);
+	jfree(q);
+	uint8_t *r = jmalloc(100);
+	if (r != q && q[0] == 0xdf && q[99] == 0xdf) {
+		TEST_PASS("Freed block was poisoned and held back.");
+	} else {
+		TEST_FAIL("Freed block was reused right away.");
+	}
+	jfree(r);
+	if (dies_of(jguard_stale_heap, SIGABRT)) {
+		TEST_PASS("Write after free was caught on eviction.");
+	} else {
+		TEST_FAIL("Write after free went unnoticed.");
+	}
+
+	jmallopt(JM_GUARD, 0);
+	jmallopt(JM_QUARANTINE, 0);
+	jfree(jmalloc(16));
+}
+#endif
+
+#if defined(__TEST_JHEAP)
+#if defined(JMM_HARDENED)
+static jheap_t *other_heap;
+
+static void jheap_realloc_wrong()
+{
+	jheap_t *h = jheap_create();
+	void *p = jheap_malloc(h, 100);
+	jheap_realloc(other_heap, p, 200);
+}
+#endif
+
+void test_jheap()
+{
+	TEST_PRINT("jheap: Independent heaps");
+	jheap_t *a = jheap_create();
+	jheap_t *b = jheap_create();
+	if (!a || !b || a == b) {
+		TEST_FAIL("jheap_create failed.");
+		return;
+	}
+
+	char *pa = jheap_malloc(a, 100);
+	char *pb = jheap_malloc(b, 100);
+	char *pm = jmalloc(100);
+	uint16_t id = pa ? ((header *)pa - 1)->heap : 0;
+	if (pa && pb && pm && id && id != ((header *)pb - 1)->heap &&
+	    ((header *)pm - 1)->heap == 0) {
+		TEST_PASS("Each heap hands out its own blocks.");
+	} else {
+		TEST_FAIL("Heaps share blocks.");
+	}
+	memset(pa, 'a', 100);
+	memset(pb, 'b', 100);
+
+	pa = jheap_realloc(a, pa, 5000);
+	if (pa && pa[0] == 'a' && pa[99] == 'a' && pb[0] == 'b' &&
+	    ((header *)pa - 1)->heap == id) {
+		TEST_PASS("jheap_realloc kept the data in the same heap.");
+	} else {
+		TEST_FAIL("jheap_realloc lost the data or the heap.");
+	}
+	pa = jrealloc(pa, 2 * MMAP_THRESHOLD);
+	if (pa && pa[99] == 'a' && ((header *)pa - 1)->is_mmap) {
+		TEST_PASS("jrealloc moved a heap block to its own mapping.");
+	} else {
+		TEST_FAIL("jrealloc of a heap block failed.");
+	}
+	pa = jrealloc(pa, 4 * MMAP_THRESHOLD);
+#if defined(JMM_HARDENED)
+	other_heap = a;
+	if (dies_of(jheap_realloc_wrong, SIGABRT)) {
+		TEST_PASS("jheap_realloc on the wrong heap aborted.");
+	} else {
+		TEST_FAIL("jheap_realloc on the wrong heap went unnoticed.");
+	}
+#else
+	/* a neighbour so that pb has to move */
+	void *nb = jheap_malloc(b, 100);
+	pb = jheap_realloc(a, pb, 300);
+	if (pb && pb[0] == 'b' && pb[99] == 'b' &&
+	    ((header *)pb - 1)->heap != id) {
+		TEST_PASS("jheap_realloc on the wrong heap kept the block's.");
+	} else {
+		TEST_FAIL("jheap_realloc moved the block to the wrong heap.");
+	}
+	jheap_free(b, nb);
+#endif
+	jfree(pa);
+	jheap_free(b, pb);
+	if (((header *)pb - 1)->is_free) {
+		TEST_PASS("jheap_free gave the block back.");
+	} else {
+		TEST_FAIL("jheap_free kept the block.");
+	}
+	jfree(pm);
+
+	/* leave everything allocated and let destroy take it */
+	void *big = jheap_malloc(a, 3 * MMAP_THRESHOLD);
+	for (int i = 0; i < 1000; i++)
+		memset(jheap_malloc(a, 64 + i), 0, 64 + i);
+	jheap_destroy(a);
+	jheap_destroy(b);
+	jheap_t *c = jheap_create();
+	char *pc = jheap_malloc(c, 100);
+	if (big && c && pc && ((header *)pc - 1)->heap) {
+		TEST_PASS("Heaps were destroyed and their slots reused.");
+	} else {
+		TEST_FAIL("Couldn't use a heap after destroying others.");
+	}
+	jheap_destroy(c);
+
+	void *p = jheap_malloc(NULL, 100);
+	if (p && ((header *)p - 1)->heap == 0) {
+		TEST_PASS("A NULL heap is the default one.");
+	} else {
+		TEST_FAIL("A NULL heap didn't allocate from the default one.");
+	}
+	jheap_free(NULL, p);
+}
 #endif
 
 void run_jmm_tests()
@@ -313,6 +1203,25 @@ void run_jmm_tests()
 	test_jrealloc_shrink();
 	test_jrealloc_expand_inplace();
 	test_jrealloc_relocate();
+	test_jreallocarray();
+	test_jgrow();
+	test_jrealloc_topgrow();
+	test_jrealloc_remap();
+#endif
+#if defined(__TEST_JTRACE)
+	test_jtrace();
+#endif
+#if defined(__TEST_JPROF)
+	test_jprof();
+#endif
+#if defined(__TEST_JCACHE)
+	test_jcache();
+#endif
+#if defined(__TEST_JGUARD)
+	test_jguard();
+#endif
+#if defined(__TEST_JHEAP)
+	test_jheap();
 #endif
 	printf("\n=== All Malloc Tests Finished ===\n");
 }
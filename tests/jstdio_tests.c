@@ -0,0 +1,591 @@
+#if defined(__JSTDIO_DEBUG)
+/* tests/jstdio_tests.c - JStdio Implementation Tests
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+#include "jstdio.h"
+#include "jmm.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+extern bool g_test_failed;
+
+#define TEST_PRINT(msg) printf("[TEST] %s\n", msg)
+#define TEST_PASS(msg) printf("[PASS] %s\n", msg)
+#define TEST_FAIL(msg)                      \
+	do {                                \
+		printf("[FAIL] %s\n", msg); \
+		g_test_failed = true;       \
+	} while (0)
+
+/* a fresh empty file's name, in buf */
+static char *temp_path(char *buf)
+{
+	strcpy(buf, "/tmp/jstdio_XXXXXX");
+	close(mkstemp(buf));
+	return buf;
+}
+
+#if defined(__TEST_FWRITE) || defined(__TEST_FFLUSH)
+static off_t file_size(const char *path)
+{
+	struct stat st;
+	return stat(path, &st) == 0 ? st.st_size : -1;
+}
+#endif
+
+#if defined(__TEST_FOPEN) || defined(__TEST_FWRITE) || defined(__TEST_FFLUSH)
+/* the whole file, read with the C library, NUL terminated */
+static char *slurp(const char *path, size_t *len)
+{
+	FILE *f = fopen(path, "rb");
+	fseek(f, 0, SEEK_END);
+	*len = ftell(f);
+	rewind(f);
+	char *buf = malloc(*len + 1);
+	*len = fread(buf, 1, *len, f);
+	buf[*len] = '\0';
+	fclose(f);
+	return buf;
+}
+#endif
+
+#if defined(__TEST_FREAD) || defined(__TEST_FGETS) || \
+	defined(__TEST_GETLINE) || defined(__TEST_MAPFILE)
+/* writes n bytes of lines with lengths all over the place to path */
+static char *write_lines(const char *path, size_t n)
+{
+	char *text = malloc(n + 1);
+	size_t len = 0;
+	srand(49);
+	while (len < n) {
+		size_t line = rand() % 8 == 0 ? rand() % (3 * JBUFSIZ) : rand() % 100;
+		for (size_t i = 0; i < line && len < n; i++)
+			text[len++] = 'a' + rand() % 26;
+		if (len < n)
+			text[len++] = '\n';
+	}
+	text[n] = '\0';
+	FILE *f = fopen(path, "wb");
+	fwrite(text, 1, n, f);
+	fclose(f);
+	return text;
+}
+#endif
+
+#if defined(__TEST_FOPEN)
+void test_jfopen()
+{
+	TEST_PRINT("jfopen / jfdopen / jfclose");
+	char path[32];
+	temp_path(path);
+	/* 1. The modes */
+	bool ok = jfopen("/nonexistent/file", "r") == NULL && errno == ENOENT;
+	ok &= jfopen(path, "q") == NULL && errno == EINVAL;
+	ok &= jfopen(path, "wx") == NULL && errno == EEXIST;
+	jFILE *f = jfopen(path, "wbe");
+	ok &= f != NULL && (fcntl(jfileno(f), F_GETFD) & FD_CLOEXEC);
+	ok &= jfputs("first\n", f) >= 0 && jfclose(f) == 0;
+	f = jfopen(path, "a");
+	ok &= f && jfputs("second\n", f) >= 0 && jfclose(f) == 0;
+	size_t len;
+	char *text = slurp(path, &len);
+	ok &= strcmp(text, "first\nsecond\n") == 0;
+	free(text);
+	if (ok) {
+		TEST_PASS("jfopen opened, created and appended by mode.");
+	} else {
+		TEST_FAIL("jfopen got a mode wrong.");
+	}
+
+	/* 2. The wrong direction is an error, not a crash */
+	char buf[8];
+	f = jfopen(path, "r");
+	ok &= jfputs("x", f) == JEOF && jferror(f);
+	jclearerr(f);
+	ok &= !jferror(f) && jfread(buf, 1, 5, f) == 5 &&
+	      memcmp(buf, "first", 5) == 0;
+	jfclose(f);
+	f = jfopen(path, "w");
+	ok &= jfread(buf, 1, 1, f) == 0 && jferror(f);
+	jfclose(f);
+	if (ok) {
+		TEST_PASS("jfopen streams refused the other direction.");
+	} else {
+		TEST_FAIL("jfopen streams allowed the wrong direction.");
+	}
+
+	/* 3. A stream over a pipe */
+	int fds[2];
+	pipe(fds);
+	jFILE *w = jfdopen(fds[1], "w");
+	jFILE *r = jfdopen(fds[0], "r");
+	ok &= w && r && jfdopen(-1, "r") == NULL;
+	ok &= jfdopen(fds[0], "w") == NULL && errno == EINVAL;
+	ok &= jfdopen(fds[1], "r+") == NULL && errno == EINVAL;
+	ok &= jfputs("through the pipe", w) >= 0 && jfclose(w) == 0;
+	ok &= jfgets(buf, sizeof(buf), r) && strcmp(buf, "through") == 0;
+	jfclose(r);
+	if (ok) {
+		TEST_PASS("jfdopen worked over a pipe.");
+	} else {
+		TEST_FAIL("jfdopen mishandled a pipe.");
+	}
+
+	/* 4. A closed standard stream stays closed, whoever gets its fd */
+	fflush(stdout);
+	int out = dup(1);
+	ok &= jfclose(jstdout) == 0;
+	int fd = open(path, O_RDWR | O_TRUNC);
+	ok &= fd == 1 && jfileno(jstdout) == -1;
+	ok &= jfputs("leak", jstdout) == JEOF && errno == EBADF;
+	ok &= jfflush(jstdout) == JEOF && errno == EBADF;
+	ok &= jfflush(NULL) == 0;
+	struct stat st;
+	ok &= fstat(fd, &st) == 0 && st.st_size == 0;
+	dup2(out, 1);
+	close(out);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jfclose on jstdout left it closed.");
+	} else {
+		TEST_FAIL("jfclose on jstdout left it usable.");
+	}
+}
+#endif
+
+#if defined(__TEST_FWRITE)
+struct writer {
+	jFILE *f;
+	int id;
+};
+
+static void *write_lines_from(void *arg)
+{
+	struct writer *w = arg;
+	char line[64];
+	for (int i = 0; i < 2000; i++) {
+		snprintf(line, sizeof(line), "thread %d line %d\n", w->id, i);
+		jfputs(line, w->f);
+	}
+	return NULL;
+}
+
+void test_jfwrite()
+{
+	TEST_PRINT("jfwrite / jfputs / jfputc");
+	char path[32];
+	temp_path(path);
+	jFILE *f = jfopen(path, "w");
+	/* 1. Small writes queue up until every buffer is full */
+	char *expect = malloc(6 * JBUFSIZ);
+	size_t n = 0;
+	while (n < 4 * JBUFSIZ - 1) {
+		char c = 'a' + n % 26;
+		jfputc(c, f);
+		expect[n++] = c;
+	}
+	bool ok = file_size(path) == 0;
+	jfputc('!', f);
+	expect[n++] = '!';
+	ok &= file_size(path) == 4 * JBUFSIZ;
+	if (ok) {
+		TEST_PASS("jfwrite held four buffers back, then wrote them at once.");
+	} else {
+		TEST_FAIL("jfwrite wrote before its buffers were full.");
+	}
+
+	/* 2. A big write goes out right away, after what was queued */
+	ok &= jfwrite("queued", 1, 6, f) == 6;
+	memcpy(expect + n, "queued", 6);
+	n += 6;
+	char *big = malloc(JBUFSIZ + 10);
+	memset(big, 'B', JBUFSIZ + 10);
+	ok &= jfwrite(big, JBUFSIZ + 10, 1, f) == 1;
+	memcpy(expect + n, big, JBUFSIZ + 10);
+	n += JBUFSIZ + 10;
+	ok &= file_size(path) == (off_t)n;
+	ok &= jfwrite("tail", 2, 2, f) == 2 && jfwrite("", 0, 5, f) == 0;
+	memcpy(expect + n, "tail", 4);
+	n += 4;
+	ok &= jfclose(f) == 0;
+	size_t len;
+	char *text = slurp(path, &len);
+	ok &= len == n && memcmp(text, expect, n) == 0;
+	free(text);
+	free(big);
+	free(expect);
+	if (ok) {
+		TEST_PASS("jfwrite sent a big write out in order, uncopied.");
+	} else {
+		TEST_FAIL("jfwrite lost or reordered data around a big write.");
+	}
+
+	/* 3. Threads sharing a stream don't tear each other's lines */
+	f = jfopen(path, "w");
+	pthread_t t[4];
+	struct writer w[4];
+	for (int i = 0; i < 4; i++) {
+		w[i] = (struct writer){ f, i };
+		pthread_create(&t[i], NULL, write_lines_from, &w[i]);
+	}
+	for (int i = 0; i < 4; i++)
+		pthread_join(t[i], NULL);
+	jfclose(f);
+	text = slurp(path, &len);
+	int next[4] = { 0 };
+	for (char *p = text, *e; *p; p = e + 1) {
+		int id, i;
+		e = strchr(p, '\n');
+		if (!e || sscanf(p, "thread %d line %d", &id, &i) != 2 ||
+		    id < 0 || id > 3 || i != next[id]++) {
+			ok = false;
+			break;
+		}
+	}
+	for (int i = 0; i < 4; i++)
+		ok &= next[i] == 2000;
+	free(text);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jfputs kept lines whole across threads.");
+	} else {
+		TEST_FAIL("jfputs tore lines written from threads.");
+	}
+
+	/* 4. Data a full queue couldn't write shows in the count */
+	f = jfopen("/dev/full", "w");
+	big = calloc(1, 60000);
+	bool failed = false;
+	for (int i = 0; f && i < 6; i++) {
+		size_t r = jfwrite(big, 1, 60000, f);
+		/* the call that ran into the error can't claim everything */
+		if (jferror(f) && !failed)
+			ok &= r < 60000;
+		failed |= jferror(f) != 0;
+	}
+	ok &= f && failed && jfclose(f) == JEOF;
+	free(big);
+	if (ok) {
+		TEST_PASS("jfwrite came up short when a flush failed.");
+	} else {
+		TEST_FAIL("jfwrite counted bytes it dropped as written.");
+	}
+}
+#endif
+
+#if defined(__TEST_FREAD)
+void test_jfread()
+{
+	TEST_PRINT("jfread / jfgetc");
+	char path[32];
+	temp_path(path);
+	size_t n = 5 * JBUFSIZ + 123;
+	char *text = write_lines(path, n);
+	char *buf = malloc(n + 1);
+	/* 1. Reads of every size, small ones buffered and big ones direct */
+	jFILE *f = jfopen(path, "r");
+	size_t done = 0;
+	bool ok = true;
+	srand(49);
+	while (done < n) {
+		size_t want = rand() % 3 ? rand() % 300 : rand() % (2 * JBUFSIZ);
+		if (rand() % 5 == 0) {
+			int c = jfgetc(f);
+			ok &= c == (unsigned char)text[done];
+			buf[done++] = (char)c;
+			continue;
+		}
+		size_t got = jfread(buf + done, 1, want, f);
+		ok &= got == (want < n - done ? want : n - done);
+		done += got;
+	}
+	ok &= memcmp(buf, text, n) == 0;
+	ok &= jfgetc(f) == JEOF && jfeof(f) && !jferror(f);
+	ok &= jfread(buf, 1, 10, f) == 0;
+	jfclose(f);
+	if (ok) {
+		TEST_PASS("jfread read everything back at every size.");
+	} else {
+		TEST_FAIL("jfread got the data or the end of file wrong.");
+	}
+
+	/* 2. Whole items only */
+	f = jfopen(path, "r");
+	ok &= jfread(buf, 1000, n / 1000 + 1, f) == n / 1000;
+	jfclose(f);
+	if (ok) {
+		TEST_PASS("jfread counted whole items.");
+	} else {
+		TEST_FAIL("jfread counted a partial item.");
+	}
+	free(buf);
+	free(text);
+	unlink(path);
+}
+#endif
+
+#if defined(__TEST_FGETS)
+void test_jfgets()
+{
+	TEST_PRINT("jfgets");
+	char path[32];
+	temp_path(path);
+	size_t n = 4 * JBUFSIZ;
+	char *text = write_lines(path, n);
+	/* Lines come back whole or in pieces of the buffer's size */
+	int sizes[] = { 1, 2, 10, 4096, 3 * JBUFSIZ };
+	char *buf = malloc(3 * JBUFSIZ);
+	bool ok = true;
+	for (int s = 0; s < 5; s++) {
+		jFILE *f = jfopen(path, "r");
+		size_t done = 0;
+		char *line;
+		while ((line = jfgets(buf, sizes[s], f))) {
+			size_t len = strlen(line);
+			if (sizes[s] == 1) {
+				ok &= len == 0;
+				break;
+			}
+			ok &= len > 0 && (int)len < sizes[s];
+			ok &= memcmp(line, text + done, len) == 0;
+			ok &= line[len - 1] == '\n' || (int)len == sizes[s] - 1 ||
+			      done + len == n;
+			done += len;
+		}
+		ok &= sizes[s] == 1 || (done == n && jfeof(f));
+		jfclose(f);
+	}
+	free(buf);
+	free(text);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jfgets split lines at newlines and at its size.");
+	} else {
+		TEST_FAIL("jfgets split a line wrong.");
+	}
+}
+#endif
+
+#if defined(__TEST_GETLINE)
+void test_jgetline()
+{
+	TEST_PRINT("jgetline");
+	char path[32];
+	temp_path(path);
+	size_t n = 4 * JBUFSIZ;
+	char *text = write_lines(path, n);
+	jFILE *f = jfopen(path, "r");
+	char *line = NULL;
+	size_t cap = 0;
+	size_t done = 0;
+	ssize_t len;
+	bool ok = true;
+	while ((len = jgetline(&line, &cap, f)) >= 0) {
+		const char *nl = memchr(text + done, '\n', n - done);
+		size_t want = nl ? (size_t)(nl - (text + done)) + 1 : n - done;
+		ok &= (size_t)len == want && cap > (size_t)len &&
+		      memcmp(line, text + done, want) == 0 && line[len] == '\0';
+		done += want;
+	}
+	ok &= done == n && jfeof(f) && !jferror(f);
+	jfree(line);
+	jfclose(f);
+	free(text);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jgetline read lines of any length whole.");
+	} else {
+		TEST_FAIL("jgetline got a line wrong.");
+	}
+}
+#endif
+
+#if defined(__TEST_FFLUSH)
+void test_jfflush()
+{
+	TEST_PRINT("jfflush");
+	char path[32];
+	temp_path(path);
+	/* 1. Flushing sends it all, jfflush(NULL) does every stream */
+	jFILE *f = jfopen(path, "w");
+	jfputs("hello", f);
+	bool ok = file_size(path) == 0 && jfflush(f) == 0 &&
+		  file_size(path) == 5;
+	jfputs(", world", f);
+	ok &= jfflush(NULL) == 0 && file_size(path) == 12;
+	jfclose(f);
+	if (ok) {
+		TEST_PASS("jfflush wrote buffered data out.");
+	} else {
+		TEST_FAIL("jfflush left data in the buffer.");
+	}
+
+	/* 2. Turning from reading to writing and back */
+	char buf[16] = { 0 };
+	f = jfopen(path, "r+");
+	ok &= jfread(buf, 1, 5, f) == 5 && memcmp(buf, "hello", 5) == 0;
+	ok &= jfputs(";", f) >= 0;
+	ok &= jfread(buf, 1, 6, f) == 6 && memcmp(buf, " world", 6) == 0;
+	ok &= jfclose(f) == 0;
+	size_t len;
+	char *text = slurp(path, &len);
+	ok &= strcmp(text, "hello; world") == 0;
+	free(text);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jfflush kept the position between reads and writes.");
+	} else {
+		TEST_FAIL("jfflush lost the position switching directions.");
+	}
+}
+#endif
+
+#if defined(__TEST_MAPFILE)
+static void write_bytes(const char *path, const char *p, size_t n)
+{
+	FILE *f = fopen(path, "wb");
+	fwrite(p, 1, n, f);
+	fclose(f);
+}
+
+/* the records of path split at delim by jmapfile, checked against text */
+static bool records_match(const char *path, const char *text, size_t n,
+			  char delim)
+{
+	jmapfile m;
+	const char *p;
+	size_t len;
+	size_t at = 0;
+	bool ok = jmapfile_open(&m, path) == 0 && m.size == n;
+	while (ok && jmapfile_next(&m, delim, &p, &len)) {
+		const char *q = memchr(text + at, delim, n - at);
+		size_t want = q ? (size_t)(q - (text + at)) : n - at;
+		/* a slice of the mapping, not a copy */
+		ok &= p == m.data + at && len == want &&
+		      memcmp(p, text + at, len) == 0;
+		at += want + (q != NULL);
+	}
+	ok &= at == n && jmapfile_close(&m) == 0 && m.data == NULL;
+	return ok;
+}
+
+void test_jmapfile()
+{
+	TEST_PRINT("jmapfile");
+	char path[32];
+	temp_path(path);
+	jmapfile m;
+	const char *p;
+	size_t len;
+	/* 1. What can't be mapped, and the empty file */
+	bool ok = jmapfile_open(&m, "/nonexistent/file") == -1 &&
+		  errno == ENOENT;
+	ok &= jmapfile_open(&m, "/tmp") == -1 && errno == EISDIR;
+	ok &= jmapfile_open(&m, path) == 0 && m.data == NULL && m.size == 0 &&
+	      !jmapfile_line(&m, &p, &len) && jmapfile_close(&m) == 0;
+	if (ok) {
+		TEST_PASS("jmapfile refused what isn't a file, mapped an empty one.");
+	} else {
+		TEST_FAIL("jmapfile got a special case wrong.");
+	}
+
+	/* 2. Empty lines, and the last line with and without its newline */
+	static const char *cases[] = { "a\n\nbc\n", "a\n\nbc", "\n", "x" };
+	static const size_t counts[] = { 3, 3, 1, 1 };
+	for (int i = 0; i < 4; i++) {
+		size_t k = 0;
+		write_bytes(path, cases[i], strlen(cases[i]));
+		ok &= jmapfile_open(&m, path) == 0;
+		while (jmapfile_line(&m, &p, &len))
+			k++;
+		ok &= k == counts[i] && jmapfile_close(&m) == 0;
+		ok &= records_match(path, cases[i], strlen(cases[i]), '\n');
+	}
+	/* going over it again */
+	ok &= jmapfile_open(&m, path) == 0 && jmapfile_line(&m, &p, &len) &&
+	      !jmapfile_line(&m, &p, &len);
+	m.pos = 0;
+	ok &= jmapfile_line(&m, &p, &len) && len == 1 && *p == 'x';
+	jmapfile_close(&m);
+	if (ok) {
+		TEST_PASS("jmapfile split lines at every newline and the end.");
+	} else {
+		TEST_FAIL("jmapfile split a line wrong.");
+	}
+
+	/* 3. Lines of every length around the vector blocks, other delimiters */
+	char *text = write_lines(path, 4 * JBUFSIZ);
+	ok &= records_match(path, text, 4 * JBUFSIZ, '\n');
+	free(text);
+	text = malloc(1 << 16);
+	size_t n = 0;
+	for (size_t line = 0; n + line + 1 <= (1 << 16); line = (line + 1) % 200) {
+		memset(text + n, 'a' + line % 26, line);
+		n += line;
+		text[n++] = line % 3 ? ',' : '\0';
+	}
+	write_bytes(path, text, n);
+	ok &= records_match(path, text, n, '\n') &&
+	      records_match(path, text, n, ',') &&
+	      records_match(path, text, n, '\0');
+	free(text);
+	if (ok) {
+		TEST_PASS("jmapfile found every delimiter wherever it was.");
+	} else {
+		TEST_FAIL("jmapfile missed or misplaced a delimiter.");
+	}
+
+	/* 4. A last line that ends right where the mapping does */
+	text = malloc(2 * 4096);
+	memset(text, 'z', 2 * 4096);
+	text[100] = '\n';
+	write_bytes(path, text, 2 * 4096);
+	ok &= records_match(path, text, 2 * 4096, '\n');
+	text[2 * 4096 - 1] = '\n';
+	write_bytes(path, text, 2 * 4096);
+	ok &= records_match(path, text, 2 * 4096, '\n');
+	free(text);
+	unlink(path);
+	if (ok) {
+		TEST_PASS("jmapfile read nothing past the end of the file.");
+	} else {
+		TEST_FAIL("jmapfile got the line at the end of the mapping wrong.");
+	}
+}
+#endif
+
+void run_jstdio_tests()
+{
+	printf("=== JStdio Implementation Test Suite ===\n\n");
+#if defined(__TEST_FOPEN)
+	test_jfopen();
+#endif
+#if defined(__TEST_FWRITE)
+	test_jfwrite();
+#endif
+#if defined(__TEST_FREAD)
+	test_jfread();
+#endif
+#if defined(__TEST_FGETS)
+	test_jfgets();
+#endif
+#if defined(__TEST_GETLINE)
+	test_jgetline();
+#endif
+#if defined(__TEST_FFLUSH)
+	test_jfflush();
+#endif
+#if defined(__TEST_MAPFILE)
+	test_jmapfile();
+#endif
+	printf("\n=== All Stdio Tests Finished ===\n");
+}
+#endif /* __JSTDIO_DEBUG */
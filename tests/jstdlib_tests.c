@@ -0,0 +1,735 @@
+#if defined(__JSTD_DEBUG)
+/* tests/jstdlib_tests.c - JStdlib Implementation Tests
+Copyright (C) 2026  Emir Baha Yıldırım */
+
+#include "jstdlib.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+extern bool g_test_failed;
+
+#define TEST_PRINT(msg) printf("[TEST] %s\n", msg)
+#define TEST_PASS(msg) printf("[PASS] %s\n", msg)
+#define TEST_FAIL(msg)                      \
+	do {                                \
+		printf("[FAIL] %s\n", msg); \
+		g_test_failed = true;       \
+	} while (0)
+
+#if defined(__TEST_STRTOL) || defined(__TEST_STRTOD)
+/* a page with an inaccessible one after it */
+static char *guarded_page(void)
+{
+	long pg = sysconf(_SC_PAGESIZE);
+	char *p = mmap(NULL, 2 * pg, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	mprotect(p + pg, pg, PROT_NONE);
+	return p;
+}
+#endif
+
+#if defined(__TEST_STRTOL) || defined(__TEST_STRTOULL)
+/* a random number in some base, with a sign, blanks and junk around it */
+static void random_number(char *buf, int base)
+{
+	static const char digs[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+	int n = 0;
+	if (rand() % 4 == 0)
+		buf[n++] = " \t\n"[rand() % 3];
+	if (rand() % 3 == 0)
+		buf[n++] = "+-"[rand() % 2];
+	if ((base == 16 || base == 0) && rand() % 3 == 0) {
+		buf[n++] = '0';
+		buf[n++] = "xX"[rand() % 2];
+	}
+	int len = rand() % 4 == 0 ? rand() % 30 : rand() % 21;
+	int b = base ? base : 10;
+	for (int i = 0; i < len; i++)
+		buf[n++] = digs[rand() % b];
+	if (rand() % 2)
+		buf[n++] = "xz.9 "[rand() % 5];
+	buf[n] = '\0';
+}
+#endif
+
+#if defined(__TEST_STRTOL)
+void test_jstrtol()
+{
+	TEST_PRINT("jstrtol / jstrntol");
+	char *end;
+	/* 1. Plain numbers, bases and prefixes */
+	bool ok = jstrtol("42", &end, 10) == 42 && *end == '\0';
+	ok &= jstrtol("  -17xyz", &end, 10) == -17 && strcmp(end, "xyz") == 0;
+	ok &= jstrtol("0x1F", NULL, 0) == 31 && jstrtol("0X1f", NULL, 16) == 31;
+	ok &= jstrtol("0755", NULL, 0) == 493 && jstrtol("z", NULL, 36) == 35;
+	ok &= jstrtol("1010", NULL, 2) == 10 && jstrtol("+0", NULL, 10) == 0;
+	ok &= jstrtol("0xg", &end, 16) == 0 && strcmp(end, "xg") == 0;
+	ok &= jstrtol("12345678901234567", NULL, 10) == 12345678901234567L;
+	if (ok) {
+		TEST_PASS("jstrtol parsed numbers in every base.");
+	} else {
+		TEST_FAIL("jstrtol got a number or its end wrong.");
+	}
+
+	/* 2. Overflow clamps and sets ERANGE, the digits are all used up */
+	errno = 0;
+	ok = jstrtol("9223372036854775807", NULL, 10) == LONG_MAX && errno == 0;
+	ok &= jstrtol("-9223372036854775808", NULL, 10) == LONG_MIN &&
+	      errno == 0;
+	ok &= jstrtol("9223372036854775808", &end, 10) == LONG_MAX &&
+	      errno == ERANGE && *end == '\0';
+	errno = 0;
+	ok &= jstrtol("-123456789012345678901234567890!", &end, 10) ==
+		      LONG_MIN &&
+	      errno == ERANGE && *end == '!';
+	if (ok) {
+		TEST_PASS("jstrtol clamped overflows and set ERANGE.");
+	} else {
+		TEST_FAIL("jstrtol mishandled an overflow.");
+	}
+
+	/* 3. No digits, or a bad base */
+	const char *none[] = { "", "   ", "+", "-x", " .5" };
+	errno = 0;
+	for (size_t i = 0; i < sizeof(none) / sizeof(*none); i++)
+		ok &= jstrtol(none[i], &end, 10) == 0 && end == none[i];
+	ok &= errno == 0;
+	ok &= jstrtol("10", &end, 1) == 0 && errno == EINVAL;
+	errno = 0;
+	ok &= jstrtol("10", &end, 37) == 0 && errno == EINVAL;
+	if (ok) {
+		TEST_PASS("jstrtol left endptr at the start without digits.");
+	} else {
+		TEST_FAIL("jstrtol mishandled input with no number.");
+	}
+
+	/* 4. Random input agrees with the C library */
+	static const int bases[] = { 0, 2, 8, 10, 16, 36 };
+	char buf[64];
+	srand(45);
+	for (int round = 0; round < 20000; round++) {
+		int base = bases[rand() % 6];
+		char *e1, *e2;
+		random_number(buf, base);
+		errno = 0;
+		long a = jstrtol(buf, &e1, base);
+		int err1 = errno;
+		errno = 0;
+		long b = strtol(buf, &e2, base);
+		ok &= a == b && e1 == e2 && err1 == errno;
+	}
+	if (ok) {
+		TEST_PASS("jstrtol agreed with strtol on random input.");
+	} else {
+		TEST_FAIL("jstrtol disagreed with strtol.");
+	}
+
+	/* 5. The bounded one stops at n, even without a '\0' */
+	ok = jstrntol("12345", 3, &end, 10) == 123;
+	ok &= jstrntol("0x1f", 2, &end, 0) == 0 && end[0] == 'x';
+	ok &= jstrntol("-", 1, &end, 10) == 0;
+	char *pg = guarded_page();
+	long sz = sysconf(_SC_PAGESIZE);
+	const char *sevens = "77777777777777777777";
+	for (int n = 1; n <= 20; n++) {
+		char *s = pg + sz - n;
+		memset(s, '7', n);
+		ok &= jstrntol(s, n, &end, 10) == strtol(sevens + 20 - n, NULL, 10) &&
+		      end == s + n;
+		/* a '\0' as the last byte of the page */
+		s[n - 1] = '\0';
+		ok &= jstrtol(s, &end, 10) == strtol(sevens + 21 - n, NULL, 10);
+	}
+	munmap(pg, 2 * sz);
+	if (ok) {
+		TEST_PASS("jstrntol stayed within its n bytes.");
+	} else {
+		TEST_FAIL("jstrntol read or parsed past its n bytes.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRTOULL)
+void test_jstrtoull()
+{
+	TEST_PRINT("jstrtoull / jstrntoull");
+	char *end;
+	/* 1. The edges of the range, and a minus sign */
+	errno = 0;
+	bool ok = jstrtoull("18446744073709551615", NULL, 10) == ULLONG_MAX &&
+		  errno == 0;
+	ok &= jstrtoull("-1", NULL, 10) == ULLONG_MAX && errno == 0;
+	ok &= jstrtoull("-18446744073709551615", NULL, 10) == 1;
+	ok &= jstrtoull("18446744073709551616", &end, 10) == ULLONG_MAX &&
+	      errno == ERANGE && *end == '\0';
+	errno = 0;
+	ok &= jstrtoull("0xffffffffffffffff", NULL, 0) == ULLONG_MAX &&
+	      errno == 0;
+	ok &= jstrtoull("0x10000000000000000", NULL, 0) == ULLONG_MAX &&
+	      errno == ERANGE;
+	if (ok) {
+		TEST_PASS("jstrtoull handled the edges of its range.");
+	} else {
+		TEST_FAIL("jstrtoull got the edge of its range wrong.");
+	}
+
+	/* 2. Random input agrees with the C library */
+	static const int bases[] = { 0, 2, 8, 10, 16, 36 };
+	char buf[64];
+	srand(46);
+	for (int round = 0; round < 20000; round++) {
+		int base = bases[rand() % 6];
+		char *e1, *e2;
+		random_number(buf, base);
+		errno = 0;
+		unsigned long long a = jstrtoull(buf, &e1, base);
+		int err1 = errno;
+		errno = 0;
+		unsigned long long b = strtoull(buf, &e2, base);
+		ok &= a == b && e1 == e2 && err1 == errno;
+	}
+	ok &= jstrntoull("99999999999", 9, &end, 10) == 999999999;
+	if (ok) {
+		TEST_PASS("jstrtoull agreed with strtoull on random input.");
+	} else {
+		TEST_FAIL("jstrtoull disagreed with strtoull.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRTOD)
+static bool same(double a, double b)
+{
+	return memcmp(&a, &b, sizeof(a)) == 0 || (isnan(a) && isnan(b));
+}
+
+/* parses s both ways, ERANGE is only compared for zero and infinity */
+static bool agrees(const char *s)
+{
+	char *e1, *e2;
+	errno = 0;
+	double a = jstrtod(s, &e1);
+	int err1 = errno;
+	errno = 0;
+	double b = strtod(s, &e2);
+	if (!same(a, b) || e1 != e2) {
+		printf("       %s: %a %a\n", s, a, b);
+		return false;
+	}
+	return (b != 0 && !isinf(b)) || err1 == errno;
+}
+
+static double random_double(void)
+{
+	uint64_t bits = 0;
+	double d;
+	for (int i = 0; i < 4; i++)
+		bits = bits << 16 | (rand() & 0xffff);
+	memcpy(&d, &bits, sizeof(d));
+	return isnan(d) || isinf(d) ? 1.0 : d;
+}
+
+/* the next double up, d being positive and finite */
+static double next_up(double d)
+{
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(d));
+	bits++;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+void test_jstrtod()
+{
+	TEST_PRINT("jstrtod / jstrntod");
+	/* 1. The forms a number can take */
+	const char *forms[] = {
+		"3.14",	 "1e10",     "-0",	  ".5",	     "5.",
+		"1e",	 "1e+",	     "1.5E-3x",	  "  +2.5e-3xyz",
+		"inf",	 "-Infinity", "infinit",  "nan",     "NaN(123)",
+		"nan(",	 "0x1.8p1",  "0x",	  "0x.8",    "0X1P-2",
+		"0x1p",	 ".",	     "-.e1",	  "",	     "00012.500",
+		"1e400", "-1e-400",  "0e999999",  "0x1p1024", "0x1p-1075",
+		"0x1.0000000000001p-1074", "0x3.ffffffffffffffffffp-1076",
+		"2.4703282292062328e-324", "2.4703282292062327e-324",
+		"1.7976931348623157e308", "1.7976931348623159e308",
+		"2.2250738585072011e-308", "2.2250738585072012e-308",
+		"9007199254740993", "123456789012345678901234567890e-10",
+	};
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(forms) / sizeof(*forms); i++)
+		ok &= agrees(forms[i]);
+	if (ok) {
+		TEST_PASS("jstrtod parsed every form like strtod.");
+	} else {
+		TEST_FAIL("jstrtod parsed a form differently from strtod.");
+	}
+
+	/* 2. Random doubles printed every which way come back the same */
+	char buf[1200];
+	srand(47);
+	for (int round = 0; round < 20000; round++) {
+		double d = random_double();
+		switch (round % 5) {
+		case 0:
+			snprintf(buf, sizeof(buf), "%.17g", d);
+			break;
+		case 1:
+			snprintf(buf, sizeof(buf), "%.*e", rand() % 25, d);
+			break;
+		case 2:
+			snprintf(buf, sizeof(buf), "%a", d);
+			break;
+		case 3:
+			/* small numbers the short way, the fast path's */
+			snprintf(buf, sizeof(buf), "%.*f", rand() % 8,
+				 (double)(rand() % 100000000) / 1000);
+			break;
+		default:
+			snprintf(buf, sizeof(buf), "%d.%de%d", rand() % 1000,
+				 rand(), rand() % 700 - 350);
+			break;
+		}
+		ok &= agrees(buf);
+	}
+	if (ok) {
+		TEST_PASS("jstrtod agreed with strtod on random doubles.");
+	} else {
+		TEST_FAIL("jstrtod disagreed with strtod on random doubles.");
+	}
+
+	/* 3. Halfway between two doubles, and a hair either side of it */
+	for (int round = 0; round < 3000; round++) {
+		double d = fabs(random_double());
+		long double mid = ((long double)d + next_up(d)) / 2;
+		int n = snprintf(buf, sizeof(buf) - 40, "%.800Le", mid);
+		/* cut the zeros off the exact expansion */
+		char *e = strchr(buf, 'e');
+		char exp[16];
+		strcpy(exp, e);
+		char *z = e;
+		while (z[-1] == '0')
+			z--;
+		strcpy(z, exp);
+		ok &= agrees(buf);
+		n = z - buf;
+		memmove(buf + n + 10, buf + n, strlen(buf + n) + 1);
+		memcpy(buf + n, "0000000001", 10);
+		ok &= agrees(buf);
+		if (buf[n - 1] > '0' && buf[n - 1] <= '9') {
+			memmove(buf + n, buf + n + 10, strlen(buf + n + 10) + 1);
+			buf[n - 1]--;
+			ok &= agrees(buf);
+		}
+	}
+	if (ok) {
+		TEST_PASS("jstrtod rounded ties to even and near ties right.");
+	} else {
+		TEST_FAIL("jstrtod rounded a tie or near tie wrong.");
+	}
+
+	/* 4. The bounded one stops at n, even without a '\0' */
+	char *end;
+	ok = jstrntod("1.5e3", 3, &end) == 1.5 && *end == 'e';
+	ok &= jstrntod("1.5e3", 4, &end) == 1.5 && *end == 'e';
+	ok &= jstrntod("infinity", 5, &end) == INFINITY && *end == 'i';
+	ok &= jstrntod("0x1p4", 2, &end) == 0 && *end == 'x';
+	char *pg = guarded_page();
+	long sz = sysconf(_SC_PAGESIZE);
+	for (int n = 1; n <= 24; n++) {
+		char *s = pg + sz - n;
+		memset(s, '3', n);
+		if (n > 2)
+			s[1] = '.';
+		snprintf(buf, sizeof(buf), "%.*s", n, s);
+		ok &= same(jstrntod(s, n, &end), strtod(buf, NULL)) &&
+		      end == s + n;
+	}
+	munmap(pg, 2 * sz);
+	if (ok) {
+		TEST_PASS("jstrntod stayed within its n bytes.");
+	} else {
+		TEST_FAIL("jstrntod read or parsed past its n bytes.");
+	}
+}
+#endif
+
+#if defined(__TEST_UTOA)
+void test_jutoa()
+{
+	TEST_PRINT("jutoa");
+	/* 1. Every length, and the ends of each */
+	char buf[JITOA_MAX];
+	char ref[JITOA_MAX];
+	bool ok = true;
+	unsigned long long v = 1;
+	for (int len = 1; len <= 20; len++, v *= 10) {
+		unsigned long long edges[] = { v - 1, v, v + 1, v * 9 + v - 1 };
+		for (int i = 0; i < 4; i++) {
+			if (len == 20 && i == 3)
+				edges[i] = ULLONG_MAX;
+			char *end = jutoa(buf, edges[i]);
+			int n = snprintf(ref, sizeof(ref), "%llu", edges[i]);
+			ok &= strcmp(buf, ref) == 0 && end == buf + n;
+		}
+	}
+	if (ok) {
+		TEST_PASS("jutoa wrote every length like snprintf.");
+	} else {
+		TEST_FAIL("jutoa got a number or its end wrong.");
+	}
+
+	/* 2. Random magnitudes */
+	srand(46);
+	for (int round = 0; round < 100000; round++) {
+		unsigned long long r = 0;
+		for (int i = 0; i < 4; i++)
+			r = r << 16 | (rand() & 0xffff);
+		r >>= rand() % 64;
+		char *end = jutoa(buf, r);
+		int n = snprintf(ref, sizeof(ref), "%llu", r);
+		ok &= strcmp(buf, ref) == 0 && end == buf + n;
+	}
+	if (ok) {
+		TEST_PASS("jutoa agreed with snprintf on random numbers.");
+	} else {
+		TEST_FAIL("jutoa disagreed with snprintf.");
+	}
+}
+#endif
+
+#if defined(__TEST_ITOA)
+void test_jitoa()
+{
+	TEST_PRINT("jitoa");
+	long long edges[] = { 0,	 -1,	    9,	      -9,	10,
+			      -10,	 99,	    -100,     INT_MAX,	INT_MIN,
+			      LLONG_MAX, LLONG_MIN, LLONG_MIN + 1 };
+	char buf[JITOA_MAX];
+	char ref[JITOA_MAX];
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(edges) / sizeof(*edges); i++) {
+		char *end = jitoa(buf, edges[i]);
+		int n = snprintf(ref, sizeof(ref), "%lld", edges[i]);
+		ok &= strcmp(buf, ref) == 0 && end == buf + n;
+	}
+	srand(46);
+	for (int round = 0; round < 100000; round++) {
+		unsigned long long r = 0;
+		for (int i = 0; i < 4; i++)
+			r = r << 16 | (rand() & 0xffff);
+		long long v = (long long)r >> rand() % 64;
+		char *end = jitoa(buf, v);
+		int n = snprintf(ref, sizeof(ref), "%lld", v);
+		ok &= strcmp(buf, ref) == 0 && end == buf + n;
+	}
+	if (ok) {
+		TEST_PASS("jitoa agreed with snprintf, signs and edges included.");
+	} else {
+		TEST_FAIL("jitoa disagreed with snprintf.");
+	}
+}
+#endif
+
+#if defined(__TEST_DTOA)
+/* d's shortest round trip the slow way, the digits of "%.*e" */
+static int shortest_digits(double d)
+{
+	char buf[40];
+	int p = 1;
+	while (p < 17) {
+		snprintf(buf, sizeof(buf), "%.*e", p - 1, d);
+		if (strtod(buf, NULL) == d)
+			break;
+		p++;
+	}
+	return p;
+}
+
+/* significant digits in s, trailing zeros of the integer part not counted */
+static int digits_in(const char *s)
+{
+	int n = 0;
+	int zeros = 0;
+	for (; *s && *s != 'e'; s++) {
+		if (*s == '0' && n == 0)
+			continue;
+		if (*s == '0')
+			zeros++;
+		else if (*s >= '1' && *s <= '9') {
+			n += zeros + 1;
+			zeros = 0;
+		}
+	}
+	return n;
+}
+
+void test_jdtoa()
+{
+	TEST_PRINT("jdtoa");
+	/* 1. The layout */
+	struct {
+		double d;
+		const char *s;
+	} forms[] = {
+		{ 0.0, "0" },
+		{ -0.0, "-0" },
+		{ 1.0, "1" },
+		{ 0.1, "0.1" },
+		{ -123.456, "-123.456" },
+		{ 100.0, "100" },
+		{ 1e20, "100000000000000000000" },
+		{ 1e21, "1e+21" },
+		{ 1e-6, "0.000001" },
+		{ 2.5e-7, "2.5e-7" },
+		{ 1.0 / 3, "0.3333333333333333" },
+		{ 5e-324, "5e-324" },
+		{ 1.7976931348623157e308, "1.7976931348623157e+308" },
+		{ 2.2250738585072014e-308, "2.2250738585072014e-308" },
+		{ 9007199254740993.0, "9007199254740992" },
+		{ -1.234567890123456e-6, "-0.000001234567890123456" },
+		{ INFINITY, "inf" },
+		{ -INFINITY, "-inf" },
+	};
+	char buf[JDTOA_MAX];
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(forms) / sizeof(*forms); i++) {
+		char *end = jdtoa(buf, forms[i].d);
+		if (strcmp(buf, forms[i].s) != 0 ||
+		    end != buf + strlen(forms[i].s)) {
+			printf("       %s: %s\n", forms[i].s, buf);
+			ok = false;
+		}
+	}
+	jdtoa(buf, NAN);
+	ok &= strcmp(buf, "nan") == 0;
+	if (ok) {
+		TEST_PASS("jdtoa laid out every form as expected.");
+	} else {
+		TEST_FAIL("jdtoa laid a form out wrong.");
+	}
+
+	/* 2. Random bit patterns, powers of two and subnormals come back */
+	srand(46);
+	for (int round = 0; round < 100000; round++) {
+		uint64_t bits = 0;
+		for (int i = 0; i < 4; i++)
+			bits = bits << 16 | (rand() & 0xffff);
+		if (round % 4 == 1)
+			bits &= ~0xfffffffffffffULL;
+		else if (round % 4 == 2)
+			bits &= 0x800fffffffffffffULL;
+		double d;
+		memcpy(&d, &bits, sizeof(d));
+		if (isnan(d) || isinf(d))
+			continue;
+		char *end = jdtoa(buf, d);
+		double back = strtod(buf, NULL);
+		if (memcmp(&back, &d, sizeof(d)) != 0 ||
+		    end != buf + strlen(buf) ||
+		    digits_in(buf) > shortest_digits(d)) {
+			printf("       %a: %s\n", d, buf);
+			ok = false;
+			break;
+		}
+	}
+	if (ok) {
+		TEST_PASS("jdtoa round tripped with the fewest digits.");
+	} else {
+		TEST_FAIL("jdtoa didn't round trip or wasn't the shortest.");
+	}
+}
+#endif
+
+#if defined(__TEST_QSORT)
+static size_t g_compares;
+
+static int cmp_int(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+	g_compares++;
+	return (x > y) - (x < y);
+}
+
+/* any size, every byte of it, so there's only one right order */
+static size_t g_size;
+static int cmp_bytes(const void *a, const void *b)
+{
+	return memcmp(a, b, g_size);
+}
+
+static int cmp_int_r(const void *a, const void *b, void *arg)
+{
+	return *(int *)arg * cmp_int(a, b);
+}
+
+/* the patterns quicksorts get wrong, n of them, values below `range` */
+static void pattern(int *a, size_t n, int kind, int range)
+{
+	for (size_t i = 0; i < n; i++) {
+		switch (kind) {
+		case 0: a[i] = rand() % range; break;
+		case 1: a[i] = (int)i; break;
+		case 2: a[i] = (int)(n - i); break;
+		case 3: a[i] = 7; break;
+		case 4: a[i] = (int)(i < n / 2 ? i : n - i); break;
+		case 5: a[i] = (int)(i % 16); break;
+		default: a[i] = i + 1 < n ? (int)i : 0; break;
+		}
+	}
+}
+
+void test_jqsort()
+{
+	TEST_PRINT("jqsort / jqsort_r");
+	/* 1. Every pattern at many lengths, against qsort */
+	size_t lengths[] = { 0, 1, 2, 3, 23, 24, 25, 100, 128, 129, 1000, 50000 };
+	int *a = malloc(50000 * sizeof(int));
+	int *b = malloc(50000 * sizeof(int));
+	bool ok = true;
+	srand(47);
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(*lengths); l++) {
+		size_t n = lengths[l];
+		for (int kind = 0; kind < 7; kind++) {
+			pattern(a, n, kind, kind ? INT_MAX : 10);
+			memcpy(b, a, n * sizeof(int));
+			jqsort(a, n, sizeof(int), cmp_int);
+			qsort(b, n, sizeof(int), cmp_int);
+			ok &= memcmp(a, b, n * sizeof(int)) == 0;
+		}
+	}
+	if (ok) {
+		TEST_PASS("jqsort sorted every pattern like qsort.");
+	} else {
+		TEST_FAIL("jqsort got a pattern wrong.");
+	}
+
+	/* 2. Sorted, reversed and equal input is linear */
+	size_t n = 50000;
+	for (int kind = 1; kind <= 3; kind++) {
+		pattern(a, n, kind, INT_MAX);
+		g_compares = 0;
+		jqsort(a, n, sizeof(int), cmp_int);
+		ok &= g_compares < 4 * n;
+	}
+	if (ok) {
+		TEST_PASS("jqsort went through presorted input in linear time.");
+	} else {
+		TEST_FAIL("jqsort took too many compares on presorted input.");
+	}
+
+	/* 3. The swaps of every size, the specialized ones and not */
+	size_t sizes[] = { 1, 3, 4, 8, 12, 16, 24, 33 };
+	unsigned char *x = malloc(5000 * 33);
+	unsigned char *y = malloc(5000 * 33);
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+		g_size = sizes[s];
+		n = 5000;
+		for (size_t i = 0; i < n * g_size; i++)
+			x[i] = rand() % 4;
+		memcpy(y, x, n * g_size);
+		jqsort(x, n, g_size, cmp_bytes);
+		qsort(y, n, g_size, cmp_bytes);
+		ok &= memcmp(x, y, n * g_size) == 0;
+	}
+	if (ok) {
+		TEST_PASS("jqsort sorted elements of every size.");
+	} else {
+		TEST_FAIL("jqsort mixed up elements of some size.");
+	}
+
+	/* 4. The argument gets through */
+	int down = -1;
+	n = 1000;
+	pattern(a, n, 0, INT_MAX);
+	jqsort_r(a, n, sizeof(int), cmp_int_r, &down);
+	for (size_t i = 1; i < n; i++)
+		ok &= a[i - 1] >= a[i];
+	if (ok) {
+		TEST_PASS("jqsort_r sorted by a comparator with an argument.");
+	} else {
+		TEST_FAIL("jqsort_r ignored its argument.");
+	}
+	free(x);
+	free(y);
+	free(a);
+	free(b);
+}
+#endif
+
+#if defined(__TEST_BSEARCH)
+static int cmp_long(const void *a, const void *b)
+{
+	long x = *(const long *)a;
+	long y = *(const long *)b;
+	return (x > y) - (x < y);
+}
+
+void test_jbsearch()
+{
+	TEST_PRINT("jbsearch / jlower_bound");
+	/* Every key in and around an array with runs, at every length */
+	long a[300];
+	bool ok = true;
+	srand(47);
+	for (size_t n = 0; n <= 300; n++) {
+		for (size_t i = 0; i < n; i++)
+			a[i] = 2 * (long)(i / 3);
+		for (long key = -1; key <= (long)n; key++) {
+			size_t first = 0;
+			while (first < n && a[first] < key)
+				first++;
+			long *lb = jlower_bound(&key, a, n, sizeof(*a), cmp_long);
+			long *hit = jbsearch(&key, a, n, sizeof(*a), cmp_long);
+			ok &= lb == a + first;
+			ok &= hit == (first < n && a[first] == key ? a + first
+								   : NULL);
+		}
+	}
+	if (ok) {
+		TEST_PASS("jbsearch found the first match, and only matches.");
+	} else {
+		TEST_FAIL("jbsearch or jlower_bound landed in the wrong place.");
+	}
+}
+#endif
+
+void run_jstdlib_tests()
+{
+	printf("=== JStdlib Implementation Test Suite ===\n\n");
+#if defined(__TEST_STRTOL)
+	test_jstrtol();
+#endif
+#if defined(__TEST_STRTOULL)
+	test_jstrtoull();
+#endif
+#if defined(__TEST_STRTOD)
+	test_jstrtod();
+#endif
+#if defined(__TEST_UTOA)
+	test_jutoa();
+#endif
+#if defined(__TEST_ITOA)
+	test_jitoa();
+#endif
+#if defined(__TEST_DTOA)
+	test_jdtoa();
+#endif
+#if defined(__TEST_QSORT)
+	test_jqsort();
+#endif
+#if defined(__TEST_BSEARCH)
+	test_jbsearch();
+#endif
+	printf("\n=== All Stdlib Tests Finished ===\n");
+}
+#endif /* __JSTD_DEBUG */
@@ -8,6 +8,13 @@ Copyright (C) 2026  Emir Baha Yıldırım */
 #include <assert.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 extern bool g_test_failed;
 
@@ -42,6 +49,40 @@ void test_jmemcpy()
 	} else {
 		TEST_FAIL("jmemcpy with n=0 modified dest.");
 	}
+
+	/* 3. Constant sizes expanded inline, at odd offsets */
+	unsigned char a[80], b[80];
+	for (int i = 0; i < 80; i++)
+		a[i] = (unsigned char)(i * 7 + 1);
+	bool ok = true;
+#define JMEMCPY_CONST(n)                                        \
+	do {                                                    \
+		memset(b, 0, sizeof(b));                        \
+		ok &= jmemcpy(b + 3, a + 5, n) == b + 3;        \
+		ok &= memcmp(b + 3, a + 5, n) == 0 && !b[2] &&  \
+		      !b[3 + n];                                \
+	} while (0)
+	JMEMCPY_CONST(1);
+	JMEMCPY_CONST(2);
+	JMEMCPY_CONST(3);
+	JMEMCPY_CONST(4);
+	JMEMCPY_CONST(7);
+	JMEMCPY_CONST(8);
+	JMEMCPY_CONST(9);
+	JMEMCPY_CONST(16);
+	JMEMCPY_CONST(17);
+	JMEMCPY_CONST(31);
+	JMEMCPY_CONST(32);
+	JMEMCPY_CONST(33);
+	JMEMCPY_CONST(63);
+	JMEMCPY_CONST(64);
+	JMEMCPY_CONST(65);
+#undef JMEMCPY_CONST
+	if (ok) {
+		TEST_PASS("jmemcpy with constant sizes copied exactly n bytes.");
+	} else {
+		TEST_FAIL("jmemcpy with a constant size copied the wrong bytes.");
+	}
 }
 #endif
 
@@ -77,6 +118,22 @@ void test_jmemmove()
 	} else {
 		TEST_FAIL("jmemmove with n=0 modified dest.");
 	}
+
+	/* 4. Constant sizes expanded inline, overlapping both ways */
+	unsigned char m[64], want[64];
+	for (int i = 0; i < 64; i++)
+		m[i] = want[i] = (unsigned char)i;
+	memmove(want + 3, want, 40);
+	jmemmove(m + 3, m, 40);
+	bool ok = memcmp(m, want, 64) == 0;
+	memmove(want, want + 17, 33);
+	jmemmove(m, m + 17, 33);
+	ok &= memcmp(m, want, 64) == 0;
+	if (ok) {
+		TEST_PASS("jmemmove with constant sizes handled overlaps.");
+	} else {
+		TEST_FAIL("jmemmove with a constant size broke an overlap.");
+	}
 }
 #endif
 
@@ -108,6 +165,32 @@ void test_jmemset()
 	} else {
 		TEST_FAIL("jmemset with n=0 modified buffer.");
 	}
+
+	/* 3. Constant sizes expanded inline */
+	unsigned char b[80];
+	ok = true;
+#define JMEMSET_CONST(n)                                                 \
+	do {                                                             \
+		memset(b, 0, sizeof(b));                                 \
+		ok &= jmemset(b + 1, 0x1a5, n) == b + 1 && !b[0] &&      \
+		      !b[1 + n];                                         \
+		for (int i = 0; i < n; i++)                              \
+			ok &= b[1 + i] == 0xa5;                          \
+	} while (0)
+	JMEMSET_CONST(1);
+	JMEMSET_CONST(3);
+	JMEMSET_CONST(5);
+	JMEMSET_CONST(8);
+	JMEMSET_CONST(13);
+	JMEMSET_CONST(24);
+	JMEMSET_CONST(40);
+	JMEMSET_CONST(64);
+#undef JMEMSET_CONST
+	if (ok) {
+		TEST_PASS("jmemset with constant sizes set exactly n bytes.");
+	} else {
+		TEST_FAIL("jmemset with a constant size set the wrong bytes.");
+	}
 }
 #endif
 
@@ -597,6 +680,684 @@ void test_jstrndup()
 }
 #endif
 
+#if defined(__TEST_STR)
+void test_jstr()
+{
+	TEST_PRINT("jstr");
+	/* 1. A zeroed jstr is empty, short strings stay inline */
+	jstr s = { 0 };
+	if (jstr_len(&s) == 0 && strcmp(jstr_cstr(&s), "") == 0) {
+		TEST_PASS("Zeroed jstr is an empty string.");
+	} else {
+		TEST_FAIL("Zeroed jstr isn't empty.");
+	}
+	jstr_set(&s, "0123456789012345678901", JSTR_SSO);
+	if (jstr_len(&s) == JSTR_SSO && jstr_cstr(&s) == (char *)&s &&
+	    strcmp(jstr_cstr(&s), "0123456789012345678901") == 0) {
+		TEST_PASS("jstr kept JSTR_SSO bytes inside the struct.");
+	} else {
+		TEST_FAIL("jstr didn't keep a short string inline.");
+	}
+
+	/* 2. Growing past the inline room moves it to the heap */
+	jstr_append(&s, "abc", 3);
+	if (jstr_len(&s) == JSTR_SSO + 3 && jstr_cstr(&s) != (char *)&s &&
+	    strcmp(jstr_cstr(&s), "0123456789012345678901abc") == 0 &&
+	    jstr_cap(&s) >= jstr_len(&s)) {
+		TEST_PASS("jstr_append spilled to the heap.");
+	} else {
+		TEST_FAIL("jstr_append lost data on spilling.");
+	}
+
+	/* 3. Appending to itself, inserting and slicing */
+	jstr_set(&s, "hello", 5);
+	jstr_append(&s, jstr_cstr(&s), jstr_len(&s));
+	jstr_insert(&s, 5, ", ", 2);
+	jstr_insert(&s, 0, ">", 1);
+	if (strcmp(jstr_cstr(&s), ">hello, hello") == 0) {
+		TEST_PASS("jstr_append and jstr_insert work, also on itself.");
+	} else {
+		TEST_FAIL("jstr_append or jstr_insert failed.");
+	}
+	jstr_set(&s, "abcdef", 6);
+	jstr_insert(&s, 3, jstr_cstr(&s) + 1, 4);
+	if (strcmp(jstr_cstr(&s), "abcbcdedef") == 0) {
+		TEST_PASS("jstr_insert of a range straddling the gap works.");
+	} else {
+		TEST_FAIL("jstr_insert of a straddling range failed.");
+	}
+	jstr_slice(&s, 2, 4);
+	if (jstr_len(&s) == 4 && strcmp(jstr_cstr(&s), "cbcd") == 0 &&
+	    jstr_slice(&s, 5, 1) == -1 && jstr_insert(&s, 5, "x", 1) == -1) {
+		TEST_PASS("jstr_slice kept the range, bad offsets fail.");
+	} else {
+		TEST_FAIL("jstr_slice failed.");
+	}
+
+	/* 4. Embedded null bytes, comparison and search */
+	jstr a = { 0 }, b = { 0 };
+	jstr_set(&a, "ab\0cd", 5);
+	jstr_set(&b, "ab\0ce", 5);
+	if (jstr_len(&a) == 5 && jstr_cmp(&a, &b) < 0 && jstr_cmp(&b, &a) > 0 &&
+	    jstr_cmp(&a, &a) == 0) {
+		TEST_PASS("jstr_cmp looks past null bytes.");
+	} else {
+		TEST_FAIL("jstr_cmp stopped at a null byte.");
+	}
+	jstr_slice(&b, 0, 2);
+	if (jstr_cmp(&b, &a) < 0 && jstr_find(&a, "\0c", 2, 0) == 2 &&
+	    jstr_find(&a, "cd", 2, 4) == JSTR_NPOS &&
+	    jstr_find(&a, "", 0, 5) == 5) {
+		TEST_PASS("jstr_cmp orders prefixes first, jstr_find works.");
+	} else {
+		TEST_FAIL("jstr_cmp or jstr_find failed.");
+	}
+
+	/* 5. A long string */
+	jstr_free(&s);
+	for (int i = 0; i < 1000; i++)
+		jstr_append(&s, "0123456789", 10);
+	if (jstr_len(&s) == 10000 && jstr_find(&s, "90", 2, 0) == 9 &&
+	    jstr_find(&s, "0123456789", 10, 9991) == JSTR_NPOS &&
+	    jstr_cstr(&s)[10000] == '\0') {
+		TEST_PASS("jstr handled a 10000 byte string.");
+	} else {
+		TEST_FAIL("jstr failed on a long string.");
+	}
+	jstr_free(&s);
+	jstr_free(&a);
+	jstr_free(&b);
+	if (jstr_len(&s) == 0 && jstr_cap(&s) == JSTR_SSO) {
+		TEST_PASS("jstr_free left an empty string.");
+	} else {
+		TEST_FAIL("jstr_free didn't reset the string.");
+	}
+}
+#endif
+
+#if defined(__TEST_SB)
+void test_jsb()
+{
+	TEST_PRINT("jsb");
+	/* 1. Mixed appends */
+	jsb sb = { 0 };
+	jsb_puts(&sb, "GET ");
+	jsb_append(&sb, "/index.html?x", 11);
+	jsb_putc(&sb, ' ');
+	jsb_int(&sb, -42);
+	jsb_putc(&sb, ' ');
+	jsb_uint(&sb, 18446744073709551615ULL);
+	jsb_printf(&sb, " %s=%05d", "id", 7);
+	size_t len;
+	char *s = jsb_take(&sb, &len);
+	const char *want = "GET /index.html -42 18446744073709551615 id=00007";
+	if (s && len == strlen(want) && strcmp(s, want) == 0 && sb.buf == NULL) {
+		TEST_PASS("jsb built a string out of mixed pieces.");
+	} else {
+		TEST_FAIL("jsb got the pieces wrong.");
+	}
+	jfree(s);
+
+	jsb_int(&sb, -9223372036854775807LL - 1);
+	s = jsb_take(&sb, NULL);
+	if (s && strcmp(s, "-9223372036854775808") == 0) {
+		TEST_PASS("jsb_int handled LLONG_MIN.");
+	} else {
+		TEST_FAIL("jsb_int failed on LLONG_MIN.");
+	}
+	jfree(s);
+
+	/* 2. Many appends and a long formatted one */
+	for (int i = 0; i < 10000; i++)
+		jsb_putc(&sb, 'a' + i % 26);
+	jsb_printf(&sb, "%0300d", 1);
+	if (jsb_len(&sb) == 10300 && sb.buf[9999] == 'a' + 9999 % 26 &&
+	    sb.buf[10299] == '1' && sb.buf[10000] == '0' && sb.cap >= sb.len) {
+		TEST_PASS("jsb grew over many appends.");
+	} else {
+		TEST_FAIL("jsb lost bytes while growing.");
+	}
+	jsb_clear(&sb);
+	if (jsb_len(&sb) == 0 && sb.cap >= 10300) {
+		TEST_PASS("jsb_clear kept the memory.");
+	} else {
+		TEST_FAIL("jsb_clear didn't empty the builder.");
+	}
+
+	/* 3. References come out in place, without copying */
+	static const char body[] = "<html>body</html>";
+	jsb_puts(&sb, "HTTP/1.1 200 OK\r\n\r\n");
+	jsb_ref(&sb, body, sizeof(body) - 1);
+	jsb_puts(&sb, "\n");
+	jsb_ref(&sb, "!", 1);
+	struct iovec iov[8];
+	int cnt = jsb_iov(&sb, iov, 8);
+	if (jsb_iov(&sb, NULL, 0) == 4 && cnt == 4 &&
+	    iov[1].iov_base == body && iov[1].iov_len == sizeof(body) - 1 &&
+	    iov[2].iov_len == 1 && jsb_len(&sb) == 19 + 17 + 2) {
+		TEST_PASS("jsb_iov listed the references between the bytes.");
+	} else {
+		TEST_FAIL("jsb_iov got the pieces wrong.");
+	}
+	s = jsb_take(&sb, &len);
+	if (s && len == 38 &&
+	    strcmp(s, "HTTP/1.1 200 OK\r\n\r\n<html>body</html>\n!") == 0) {
+		TEST_PASS("jsb_take copied the references in.");
+	} else {
+		TEST_FAIL("jsb_take flattened the string wrong.");
+	}
+	jfree(s);
+	jsb_free(&sb);
+}
+#endif
+
+#if defined(__TEST_INTERN)
+static jintern_t *g_intern;
+
+static void *jintern_worker(void *arg)
+{
+	char name[32];
+	uintptr_t id = (uintptr_t)arg;
+	bool ok = true;
+
+	for (int i = 0; i < 5000; i++) {
+		snprintf(name, sizeof(name), "metric.%d", i % 2000);
+		const char *p = jintern_cstr(g_intern, name);
+		ok &= p && strcmp(p, name) == 0 &&
+		      jintern_lookup(g_intern, name, strlen(name)) == p;
+	}
+	return ok ? (void *)id : NULL;
+}
+
+void test_jintern()
+{
+	TEST_PRINT("jintern");
+	/* 1. Equal strings get the same pointer */
+	jintern_t *t = jintern_create(0);
+	char buf[] = "http.requests";
+	const char *a = jintern_cstr(t, "http.requests");
+	const char *b = jintern(t, buf, strlen(buf));
+	const char *c = jintern_cstr(t, "http.request");
+	if (a && a == b && a != buf && c && c != a && strcmp(a, buf) == 0 &&
+	    jintern_len(c) == 12 && jintern_count(t) == 2) {
+		TEST_PASS("Equal strings were interned to one pointer.");
+	} else {
+		TEST_FAIL("jintern didn't canonicalize equal strings.");
+	}
+
+	/* 2. Null bytes, the empty string and a long string */
+	const char *z1 = jintern(t, "a\0b", 3);
+	const char *z2 = jintern(t, "a\0c", 3);
+	const char *e = jintern(t, "", 0);
+	char big[1 << 16];
+	memset(big, 'x', sizeof(big));
+	const char *l = jintern(t, big, sizeof(big));
+	if (z1 != z2 && jintern_len(z1) == 3 && e && e[0] == '\0' &&
+	    jintern(t, "", 0) == e && l && jintern(t, big, sizeof(big)) == l &&
+	    jintern_len(l) == sizeof(big) && l[sizeof(big)] == '\0') {
+		TEST_PASS("jintern handled null bytes, empty and long strings.");
+	} else {
+		TEST_FAIL("jintern failed on special strings.");
+	}
+
+	/* 3. Growing keeps every pointer */
+	char name[32];
+	const char *first[5000];
+	bool ok = true;
+	for (int i = 0; i < 5000; i++) {
+		snprintf(name, sizeof(name), "label_%d", i);
+		first[i] = jintern_cstr(t, name);
+	}
+	for (int i = 0; i < 5000; i++) {
+		snprintf(name, sizeof(name), "label_%d", i);
+		ok &= jintern_lookup(t, name, strlen(name)) == first[i];
+	}
+	if (ok && jintern_count(t) == 5000 + 6 &&
+	    jintern_lookup(t, "nope", 4) == NULL && jintern_count(t) == 5006) {
+		TEST_PASS("Pointers stayed the same while the table grew.");
+	} else {
+		TEST_FAIL("jintern lost strings while growing.");
+	}
+	jintern_destroy(t);
+
+	/* 4. A shared table from several threads */
+	pthread_t th[4];
+	ok = (g_intern = jintern_create(JINTERN_SHARED)) != NULL;
+	for (uintptr_t i = 0; i < 4; i++)
+		pthread_create(&th[i], NULL, jintern_worker, (void *)(i + 1));
+	for (int i = 0; i < 4; i++) {
+		void *r;
+		pthread_join(th[i], &r);
+		ok &= r != NULL;
+	}
+	if (ok && jintern_count(g_intern) == 2000 &&
+	    jintern_create(2) == NULL && errno == EINVAL) {
+		TEST_PASS("Shared table stayed consistent across threads.");
+	} else {
+		TEST_FAIL("Shared table broke under threads.");
+	}
+	jintern_destroy(g_intern);
+}
+#endif
+
+#if defined(__TEST_STRCASECMP) || defined(__TEST_STRNCASECMP) || \
+	defined(__TEST_MEMCASECMP)
+static int sgn(int v)
+{
+	return (v > 0) - (v < 0);
+}
+#endif
+
+#if defined(__TEST_STRCASECMP) || defined(__TEST_STRNCASECMP) || \
+	defined(__TEST_MEMCASECMP) || defined(__TEST_STRSORT)
+/* a PROT_NONE page right after the one returned */
+static char *guarded_page(void)
+{
+	long pg = sysconf(_SC_PAGESIZE);
+	char *p = mmap(NULL, 2 * pg, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	mprotect(p + pg, pg, PROT_NONE);
+	return p;
+}
+#endif
+
+#if defined(__TEST_STRCASECMP)
+void test_jstrcasecmp()
+{
+	TEST_PRINT("jstrcasecmp");
+	/* 1. Case is ignored, only for letters */
+	if (jstrcasecmp("Content-Length", "content-length") == 0 &&
+	    jstrcasecmp("HELLO", "hello") == 0 &&
+	    jstrcasecmp("@", "`") != 0 && jstrcasecmp("[", "{") != 0 &&
+	    jstrcasecmp("\xc4", "\xe4") != 0 && jstrcasecmp("", "") == 0) {
+		TEST_PASS("jstrcasecmp folded letters and nothing else.");
+	} else {
+		TEST_FAIL("jstrcasecmp folded the wrong bytes.");
+	}
+
+	/* 2. Order matches the C library on long strings */
+	char a[100], b[100];
+	bool ok = true;
+	for (int i = 0; i < 99; i++)
+		a[i] = b[i] = (char)((i % 2 ? 'a' : 'A') + i % 26);
+	a[99] = b[99] = '\0';
+	for (int i = 0; i < 99; i += 7) {
+		char keep = b[i];
+		b[i] = (char)(b[i] ^ 0x20);
+		ok &= jstrcasecmp(a, b) == 0;
+		b[i] = (char)(keep + 1);
+		ok &= sgn(jstrcasecmp(a, b)) == sgn(strcasecmp(a, b));
+		ok &= sgn(jstrcasecmp(b, a)) == sgn(strcasecmp(b, a));
+		b[i] = keep;
+	}
+	b[60] = '\0';
+	ok &= jstrcasecmp(a, b) > 0 && jstrcasecmp(b, a) < 0;
+	if (ok) {
+		TEST_PASS("jstrcasecmp ordered strings like strcasecmp.");
+	} else {
+		TEST_FAIL("jstrcasecmp disagreed with strcasecmp.");
+	}
+
+	/* 3. Strings ending right before an inaccessible page */
+	char *pg = guarded_page();
+	long sz = sysconf(_SC_PAGESIZE);
+	ok = true;
+	for (int n = 0; n < 40; n++) {
+		char *x = pg + sz - n - 1;
+		memset(x, 'Q', n);
+		x[n] = '\0';
+		ok &= jstrcasecmp(x, x) == 0;
+		ok &= jstrcasecmp(x, a) != 0 || n == 0;
+	}
+	munmap(pg, 2 * sz);
+	if (ok) {
+		TEST_PASS("jstrcasecmp stayed within the page.");
+	} else {
+		TEST_FAIL("jstrcasecmp got strings at a page end wrong.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRNCASECMP)
+void test_jstrncasecmp()
+{
+	TEST_PRINT("jstrncasecmp");
+	if (jstrncasecmp("Transfer-Encoding: x", "TRANSFER-ENCODING: y", 18) ==
+		    0 &&
+	    jstrncasecmp("abc", "ABD", 3) < 0 && jstrncasecmp("abc", "ABD", 2) == 0 &&
+	    jstrncasecmp("abc", "xyz", 0) == 0 &&
+	    jstrncasecmp("ab", "ABC", 10) < 0) {
+		TEST_PASS("jstrncasecmp stopped after n bytes or at the end.");
+	} else {
+		TEST_FAIL("jstrncasecmp compared the wrong range.");
+	}
+
+	char *pg = guarded_page();
+	long sz = sysconf(_SC_PAGESIZE);
+	bool ok = true;
+	for (int n = 1; n < 40; n++) {
+		char *x = pg + sz - n;
+		memset(x, 'k', n);
+		ok &= jstrncasecmp(x, "KKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKKK",
+				   n) == 0;
+	}
+	munmap(pg, 2 * sz);
+	if (ok) {
+		TEST_PASS("jstrncasecmp read no more than n bytes.");
+	} else {
+		TEST_FAIL("jstrncasecmp got unterminated bytes wrong.");
+	}
+}
+#endif
+
+#if defined(__TEST_MEMCASECMP)
+void test_jmemcasecmp()
+{
+	TEST_PRINT("jmemcasecmp");
+	char a[64], b[64];
+	for (int i = 0; i < 64; i++) {
+		a[i] = (char)('a' + i % 26);
+		b[i] = (char)('A' + i % 26);
+	}
+	a[20] = b[20] = '\0';
+	bool ok = jmemcasecmp(a, b, 64) == 0;
+	b[40] = 'A';
+	ok &= jmemcasecmp(a, b, 64) > 0 && jmemcasecmp(b, a, 64) < 0 &&
+	      jmemcasecmp(a, b, 40) == 0;
+	if (ok) {
+		TEST_PASS("jmemcasecmp compared past null bytes, ignoring case.");
+	} else {
+		TEST_FAIL("jmemcasecmp failed.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRTOLOWER)
+void test_jstrtolower()
+{
+	TEST_PRINT("jstrtolower");
+	char buf[80];
+	strcpy(buf + 3, "X-Forwarded-For: 10.0.0.1 [HOST] @ZEBRA\xc9 and more TEXT");
+	buf[70] = '#';
+	strcpy(buf + 71, "KEEP");
+	char *r = jstrtolower(buf + 3);
+	if (r == buf + 3 &&
+	    strcmp(buf + 3, "x-forwarded-for: 10.0.0.1 [host] @zebra\xc9 and more text") == 0 &&
+	    strcmp(buf + 71, "KEEP") == 0) {
+		TEST_PASS("jstrtolower lowered letters up to the end only.");
+	} else {
+		TEST_FAIL("jstrtolower changed the wrong bytes.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRTOUPPER)
+void test_jstrtoupper()
+{
+	TEST_PRINT("jstrtoupper");
+	char buf[64] = "content-type: text/html; charset={utf-8} `z`";
+	jstrtoupper(buf);
+	if (strcmp(buf, "CONTENT-TYPE: TEXT/HTML; CHARSET={UTF-8} `Z`") == 0) {
+		TEST_PASS("jstrtoupper raised letters only.");
+	} else {
+		TEST_FAIL("jstrtoupper changed the wrong bytes.");
+	}
+}
+#endif
+
+#if defined(__TEST_MEMTOLOWER) || defined(__TEST_MEMTOUPPER)
+void test_jmemtolower()
+{
+	TEST_PRINT("jmemtolower / jmemtoupper");
+	unsigned char src[300], lo[300], up[300];
+	bool ok = true;
+	for (int i = 0; i < 300; i++)
+		src[i] = (unsigned char)(i * 37);
+	for (int n = 0; n < 300; n += 13) {
+		jmemtolower(lo, src, n);
+		jmemtoupper(up, src, n);
+		for (int i = 0; i < n; i++) {
+			ok &= lo[i] == (src[i] >= 'A' && src[i] <= 'Z' ?
+						src[i] + 32 :
+						src[i]);
+			ok &= up[i] == (src[i] >= 'a' && src[i] <= 'z' ?
+						src[i] - 32 :
+						src[i]);
+		}
+	}
+	jmemtolower(lo, src, 300);
+	jmemtoupper(lo, lo, 300);
+	jmemtoupper(up, src, 300);
+	ok &= memcmp(lo, up, 300) == 0;
+	if (ok) {
+		TEST_PASS("jmemtolower and jmemtoupper converted every byte.");
+	} else {
+		TEST_FAIL("jmemtolower or jmemtoupper got a byte wrong.");
+	}
+}
+#endif
+
+#if defined(__TEST_UTF8)
+/* the offset of the first bad sequence, decoding code points the long way */
+static size_t utf8_ref(const unsigned char *s, size_t n)
+{
+	static const uint32_t min[] = { 0, 0, 0x80, 0x800, 0x10000 };
+	size_t i = 0;
+	while (i < n) {
+		int len = s[i] < 0x80 ? 1 : s[i] >= 0xf0 ? 4 : s[i] >= 0xe0 ? 3 :
+					      s[i] >= 0xc0 ? 2 : 0;
+		uint32_t cp = len == 1 ? s[i] : s[i] & (0x7f >> len);
+		if (len == 0 || n - i < (size_t)len || s[i] >= 0xf8)
+			return i;
+		for (int k = 1; k < len; k++) {
+			if ((s[i + k] & 0xc0) != 0x80)
+				return i;
+			cp = cp << 6 | (s[i + k] & 0x3f);
+		}
+		if (cp < min[len] || cp > 0x10ffff ||
+		    (cp >= 0xd800 && cp <= 0xdfff))
+			return i;
+		i += len;
+	}
+	return JSTR_NPOS;
+}
+
+void test_jutf8()
+{
+	TEST_PRINT("jutf8_validate / jutf8_count / jutf8_find_invalid");
+	/* 1. The edges of each sequence length are valid */
+	const char *good[] = {
+		"", "plain ASCII", "h\xc3\xa9llo", "\xe6\x97\xa5\xe6\x9c\xac",
+		"\xf0\x9f\x98\x80", "\x7f\xc2\x80\xdf\xbf\xe0\xa0\x80",
+		"\xed\x9f\xbf\xee\x80\x80\xef\xbf\xbf",
+		"\xf0\x90\x80\x80\xf4\x8f\xbf\xbf",
+	};
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(good) / sizeof(*good); i++)
+		ok &= jutf8_validate(good[i], strlen(good[i]));
+	if (ok) {
+		TEST_PASS("jutf8_validate accepted valid UTF-8.");
+	} else {
+		TEST_FAIL("jutf8_validate rejected valid UTF-8.");
+	}
+
+	/* 2. Each kind of error is found, wherever it is in a long text */
+	const char *bad[] = {
+		"\x80",	     "\xbf\x80",	     "\xc0\x80",
+		"\xc1\xbf",	     "\xe0\x80\x80",	     "\xe0\x9f\xbf",
+		"\xed\xa0\x80",   "\xed\xbf\xbf",	     "\xf0\x80\x80\x80",
+		"\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80",
+		"\xff",	     "\xc3" "A",	     "\xe2\x82" "A",
+		"\xf0\x9f\x98" "A",  "\xc3\xa9\xa9",
+	};
+	unsigned char buf[200];
+	for (size_t i = 0; i < sizeof(bad) / sizeof(*bad); i++) {
+		size_t len = strlen(bad[i]);
+		for (size_t at = 0; at + len <= 140; at++) {
+			/* two byte characters around it, ASCII after */
+			for (size_t k = 0; k + 1 < at; k += 2)
+				memcpy(buf + k, "\xc3\xa9", 2);
+			if (at & 1)
+				buf[at - 1] = 'x';
+			memset(buf + at, 'y', sizeof(buf) - at);
+			memcpy(buf + at, bad[i], len);
+			size_t want = bad[i][0] == '\xc3' && len == 3 ? at + 2 :
+									 at;
+			ok &= jutf8_find_invalid(buf, sizeof(buf)) == want;
+			ok &= !jutf8_validate(buf, sizeof(buf));
+		}
+	}
+	if (ok) {
+		TEST_PASS("jutf8_find_invalid found every error where it was.");
+	} else {
+		TEST_FAIL("jutf8_find_invalid missed an error or misplaced it.");
+	}
+
+	/* 3. A sequence cut off by the end of the input is invalid */
+	memset(buf, 'a', sizeof(buf));
+	for (size_t n = 1; n <= 130; n++) {
+		memcpy(buf + n - 1, "\xf0\x9f\x98\x80", 4);
+		ok &= jutf8_find_invalid(buf, n) == n - 1;
+		ok &= jutf8_find_invalid(buf, n + 2) == n - 1;
+		ok &= jutf8_find_invalid(buf, n + 3) == JSTR_NPOS;
+		memset(buf + n - 1, 'a', 4);
+	}
+	if (ok) {
+		TEST_PASS("jutf8_find_invalid caught sequences cut short.");
+	} else {
+		TEST_FAIL("jutf8_find_invalid let a cut short sequence pass.");
+	}
+
+	/* 4. Random mixes agree with decoding the long way */
+	unsigned char *r = malloc(4096);
+	srand(44);
+	for (int round = 0; round < 2000; round++) {
+		size_t n = rand() % 4096, i = 0;
+		while (i < n) {
+			static const char *pick[] = { "a", "\xc3\xa9", "\xe2\x82\xac",
+						      "\xf0\x9f\x98\x80" };
+			const char *p = pick[rand() % 4];
+			for (; *p && i < n; p++)
+				r[i++] = (unsigned char)*p;
+		}
+		/* now and then a random byte in a random place */
+		if (n && rand() % 4 == 0)
+			r[rand() % n] = (unsigned char)rand();
+		ok &= jutf8_find_invalid(r, n) == utf8_ref(r, n);
+		if (utf8_ref(r, n) == JSTR_NPOS) {
+			size_t cps = 0;
+			for (size_t k = 0; k < n; k++)
+				cps += (r[k] & 0xc0) != 0x80;
+			ok &= jutf8_count(r, n) == cps;
+		}
+	}
+	free(r);
+	if (ok) {
+		TEST_PASS("jutf8_find_invalid agreed with a plain decoder.");
+	} else {
+		TEST_FAIL("jutf8_find_invalid disagreed with a plain decoder.");
+	}
+
+	/* 5. Counting across many blocks, ASCII and not */
+	size_t big = 64 * 1000 + 7;
+	unsigned char *t = malloc(big);
+	size_t cps = 0;
+	for (size_t k = 0; k < big;) {
+		if ((k / 640) % 2 == 0 || big - k < 3) {
+			t[k++] = 'z';
+		} else {
+			memcpy(t + k, "\xe2\x82\xac", 3);
+			k += 3;
+		}
+		cps++;
+	}
+	ok &= jutf8_validate(t, big) && jutf8_count(t, big) == cps;
+	ok &= jutf8_count("", 0) == 0 && jutf8_count("\xf0\x9f\x98\x80", 4) == 1;
+	free(t);
+	if (ok) {
+		TEST_PASS("jutf8_count counted every code point.");
+	} else {
+		TEST_FAIL("jutf8_count miscounted.");
+	}
+}
+#endif
+
+#if defined(__TEST_STRSORT)
+static int cmp_str(const void *a, const void *b)
+{
+	return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* a key like the ones jstrsort is for: shared prefixes, a varying tail */
+static void random_key(char *buf)
+{
+	static const char *prefixes[] = { "", "https://example.com/",
+					  "https://example.com/api/v1/users/",
+					  "2026-10-19T12:", "\xc3\xa9t\xc3\xa9" };
+	int n = sprintf(buf, "%s", prefixes[rand() % 5]);
+	int tail = rand() % 20;
+	for (int i = 0; i < tail; i++)
+		buf[n++] = rand() % 4 ? 'a' + rand() % 3 : 0x7f + rand() % 0x80;
+	buf[n] = '\0';
+}
+
+void test_jstrsort()
+{
+	TEST_PRINT("jstrsort");
+	/* 1. Against qsort(strcmp), at lengths either side of the cutoff */
+	size_t lengths[] = { 0, 1, 2, 31, 32, 33, 1000, 20000 };
+	char *pool = malloc(20000 * 64);
+	char **v = malloc(20000 * sizeof(char *));
+	char **w = malloc(20000 * sizeof(char *));
+	bool ok = true;
+	srand(48);
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(*lengths); l++) {
+		size_t n = lengths[l];
+		for (size_t i = 0; i < n; i++) {
+			v[i] = pool + i * 64;
+			/* a few exact duplicates too */
+			if (i && rand() % 8 == 0)
+				strcpy(v[i], v[rand() % i]);
+			else
+				random_key(v[i]);
+		}
+		memcpy(w, v, n * sizeof(char *));
+		jstrsort(v, n);
+		qsort(w, n, sizeof(char *), cmp_str);
+		for (size_t i = 0; i < n; i++)
+			ok &= strcmp(v[i], w[i]) == 0;
+	}
+	if (ok) {
+		TEST_PASS("jstrsort sorted like qsort with strcmp.");
+	} else {
+		TEST_FAIL("jstrsort put strings out of order.");
+	}
+
+	/* 2. Strings ending right before an unmapped page */
+	char *pg = guarded_page();
+	long sz = sysconf(_SC_PAGESIZE);
+	size_t n = 0;
+	for (int len = 0; len <= 20; len++) {
+		char *s = pg + sz - 1 - len;
+		memset(s, 'k', len);
+		s[len] = '\0';
+		v[n++] = s;
+	}
+	jstrsort(v, n);
+	for (size_t i = 0; i < n; i++)
+		ok &= strlen(v[i]) == i;
+	munmap(pg, 2 * sz);
+	if (ok) {
+		TEST_PASS("jstrsort read no further than the strings.");
+	} else {
+		TEST_FAIL("jstrsort misread strings at the end of a page.");
+	}
+	free(pool);
+	free(v);
+	free(w);
+}
+#endif
+
 void run_jstring_tests()
 {
 	printf("=== JString Implementation Test Suite ===\n\n");
@@ -653,6 +1414,39 @@ void run_jstring_tests()
 #endif
 #if defined(__TEST_STRNDUP)
 	test_jstrndup();
+#endif
+#if defined(__TEST_STR)
+	test_jstr();
+#endif
+#if defined(__TEST_SB)
+	test_jsb();
+#endif
+#if defined(__TEST_INTERN)
+	test_jintern();
+#endif
+#if defined(__TEST_STRCASECMP)
+	test_jstrcasecmp();
+#endif
+#if defined(__TEST_STRNCASECMP)
+	test_jstrncasecmp();
+#endif
+#if defined(__TEST_MEMCASECMP)
+	test_jmemcasecmp();
+#endif
+#if defined(__TEST_STRTOLOWER)
+	test_jstrtolower();
+#endif
+#if defined(__TEST_STRTOUPPER)
+	test_jstrtoupper();
+#endif
+#if defined(__TEST_MEMTOLOWER) || defined(__TEST_MEMTOUPPER)
+	test_jmemtolower();
+#endif
+#if defined(__TEST_UTF8)
+	test_jutf8();
+#endif
+#if defined(__TEST_STRSORT)
+	test_jstrsort();
 #endif
 	printf("\n=== All String Tests Finished ===\n");
 }
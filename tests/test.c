@@ -16,6 +16,14 @@ extern void run_jmm_tests(void);
 extern void run_jstring_tests(void);
 #endif
 
+#if defined(__JSTD_DEBUG)
+extern void run_jstdlib_tests(void);
+#endif
+
+#if defined(__JSTDIO_DEBUG)
+extern void run_jstdio_tests(void);
+#endif
+
 int main(void)
 {
 #if defined(__JMM_DEBUG)
@@ -26,6 +34,14 @@ int main(void)
 	run_jstring_tests();
 #endif
 
+#if defined(__JSTD_DEBUG)
+	run_jstdlib_tests();
+#endif
+
+#if defined(__JSTDIO_DEBUG)
+	run_jstdio_tests();
+#endif
+
 	if (g_test_failed) {
 		printf("\n*** Some tests FAILED! Check the output above. ***\n");
 		return 1;